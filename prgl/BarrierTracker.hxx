@@ -0,0 +1,121 @@
+/**
+ * @file BarrierTracker.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_BARRIER_TRACKER_H
+#define PRGL_BARRIER_TRACKER_H
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "prgl/ShaderStorageBuffer.hxx"
+#include "prgl/Texture2d.hxx"
+#include "prgl/Texture2dArray.hxx"
+#include "prgl/glCommon.hxx"
+
+namespace prgl {
+
+/**
+ * @brief Issues glMemoryBarrier only when a command reads or writes a resource
+ * that an earlier command wrote incoherently (image stores, shader storage
+ * and atomic counter writes), and only with the bits of the new access.
+ *
+ * Before each dispatch or draw, declare the resources the command uses with
+ * use() and call flush(). GlslComputeShader::dispatchCompute does this for the
+ * bound samplers, images and SSBOs when a tracker is set on the program, and
+ * PassGraph for the resources of each pass. Both also set the tracker on the
+ * resources they use, so that later downloads and copies, FrameBufferObject
+ * binds and QuadRenderer draws of a resource declare their access and flush
+ * the barrier they need. Render targets are declared as textures with
+ * Access::Framebuffer.
+ */
+class BarrierTracker final {
+ public:
+  // kind of access, named after the barrier bit that makes writes visible
+  enum class Access : uint32_t {
+    ImageLoadStore  = GL_SHADER_IMAGE_ACCESS_BARRIER_BIT,
+    StorageBuffer   = GL_SHADER_STORAGE_BARRIER_BIT,
+    AtomicCounter   = GL_ATOMIC_COUNTER_BARRIER_BIT,
+    TextureFetch    = GL_TEXTURE_FETCH_BARRIER_BIT,
+    Framebuffer     = GL_FRAMEBUFFER_BARRIER_BIT,
+    TextureUpdate   = GL_TEXTURE_UPDATE_BARRIER_BIT,
+    BufferUpdate    = GL_BUFFER_UPDATE_BARRIER_BIT,
+    PixelBuffer     = GL_PIXEL_BUFFER_BARRIER_BIT,
+    Uniform         = GL_UNIFORM_BARRIER_BIT,
+    VertexAttribute = GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT,
+    ElementArray    = GL_ELEMENT_ARRAY_BARRIER_BIT,
+    Command         = GL_COMMAND_BARRIER_BIT
+  };
+
+  struct Statistics {
+    // glMemoryBarrier calls
+    uint64_t issued;
+    // flushes that needed no barrier
+    uint64_t elided;
+  };
+
+  // issues the barrier, glMemoryBarrier unless replaced e.g. in tests
+  using MemoryBarrier = std::function<void(GLbitfield barriers)>;
+
+  static std::shared_ptr<BarrierTracker> Create(
+    MemoryBarrier memoryBarrier = nullptr);
+
+  explicit BarrierTracker(MemoryBarrier memoryBarrier = nullptr);
+  ~BarrierTracker();
+
+  // declare an access of the next command
+  void useTexture(uint32_t id, Access access, bool writes);
+  void useBuffer(uint32_t handle, Access access, bool writes);
+  void use(const Texture2d& texture, Access access, bool writes = false);
+  void use(const Texture2dArray& texture, Access access, bool writes = false);
+  void use(const ShaderStorageBuffer& buffer, Access access,
+           bool writes = false);
+
+  /**
+   * @brief Issue the barrier the declared accesses need, call right before
+   * the command.
+   *
+   * @return the barrier bits, 0 if the barrier was elided.
+   */
+  GLbitfield flush();
+  // use() and flush() for a single access, e.g. of a download
+  template <typename Resource>
+  GLbitfield flush(const Resource& resource, Access access,
+                   bool writes = false) {
+    use(resource, access, writes);
+    return flush();
+  }
+
+  // forget all writes, e.g. after an explicit glMemoryBarrier
+  void reset();
+
+  Statistics getStatistics() const;
+  void resetStatistics();
+
+ private:
+  BarrierTracker(const BarrierTracker&) = delete;
+  BarrierTracker& operator=(const BarrierTracker&) = delete;
+
+  void use(uint64_t key, Access access, bool writes);
+
+  struct Write {
+    uint64_t key;
+    Access access;
+  };
+
+  MemoryBarrier mMemoryBarrier;
+  // barrier bits already issued since the last incoherent write, by resource
+  std::unordered_map<uint64_t, GLbitfield> mDirty;
+  GLbitfield mRequired;
+  std::vector<Write> mWrites;
+  Statistics mStatistics;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_BARRIER_TRACKER_H
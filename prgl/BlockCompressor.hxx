@@ -0,0 +1,68 @@
+/**
+ * @file BlockCompressor.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_BLOCK_COMPRESSOR_H
+#define PRGL_BLOCK_COMPRESSOR_H
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "prgl/Texture2d.hxx"
+
+namespace prgl {
+
+/**
+ * @brief Encodes 8 bit RGBA images into the BC1, BC3, BC4, BC5 and BC7 block
+ * compressed formats on the host, e.g. while importing assets. The 4x4 blocks
+ * are distributed over worker threads, pixel projections use SSE2 if
+ * available.
+ *
+ * Endpoints are taken from the principal axis of each block. BC7 uses mode 6
+ * only (one subset, RGBA endpoints, 4 bit indices), which is fast and suits
+ * most color textures but is not the best choice for blocks with several
+ * distinct colors.
+ */
+class BlockCompressor final {
+ public:
+  template <typename... T>
+  static std::shared_ptr<BlockCompressor> Create(T&&... args) {
+    return std::make_shared<BlockCompressor>(std::forward<T>(args)...);
+  }
+
+  /**
+   * @param threadCount number of worker threads, 0 uses one per hardware
+   * thread.
+   */
+  explicit BlockCompressor(uint32_t threadCount = 0U);
+
+  /**
+   * @brief Encode a single mip level.
+   *
+   * @param rgba 8 bit RGBA pixels, rows from bottom to top like glTexImage2D.
+   * BC4 only uses red, BC5 red and green.
+   * @param width image width, does not need to be a multiple of 4.
+   * @param height image height, does not need to be a multiple of 4.
+   * @param format one of the Bc* formats of TextureFormatInternal.
+   * @param rowStride number of pixels between two rows, 0 if tightly packed.
+   * @return getCompressedImageSize(format, width, height) bytes ready for
+   * Texture2d::uploadCompressed.
+   */
+  std::vector<uint8_t> compress(const uint8_t* rgba, uint32_t width,
+                                uint32_t height, TextureFormatInternal format,
+                                uint32_t rowStride = 0U) const;
+
+  uint32_t getThreadCount() const;
+
+ private:
+  uint32_t mThreadCount;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_BLOCK_COMPRESSOR_H
@@ -0,0 +1,120 @@
+/**
+ * @file BufferHeap.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_BUFFER_HEAP_H
+#define PRGL_BUFFER_HEAP_H
+
+#include <memory>
+#include <vector>
+
+#include "prgl/TlsfAllocator.hxx"
+#include "prgl/glCommon.hxx"
+
+namespace prgl {
+
+/**
+ * @brief Suballocates many small vertex, storage or uniform ranges from a few
+ * large buffer objects (pages) instead of creating a buffer object for each.
+ * An allocation is a range (buffer, offset, size), meshes sharing a page can
+ * be drawn without rebinding their buffer. VertexBufferObject and
+ * ShaderStorageBuffer can be created on a heap.
+ */
+class BufferHeap final {
+ public:
+  struct Allocation {
+    uint32_t buffer;
+    uint64_t offset;
+    uint64_t size;
+    // identify the allocation across defragment()
+    uint32_t page;
+    uint32_t block;
+  };
+
+  struct Statistics {
+    uint32_t pages;
+    uint64_t capacity;
+    uint64_t used;
+    // largest range that can be allocated without a new page
+    uint64_t largestFree;
+    uint32_t allocations;
+    // 1 - largestFree / free bytes over all pages
+    float fragmentation;
+  };
+
+  template <typename... T>
+  static std::shared_ptr<BufferHeap> Create(T&&... args) {
+    return std::make_shared<BufferHeap>(std::forward<T>(args)...);
+  }
+
+  /**
+   * @param target decides the offset alignment, e.g. GL_UNIFORM_BUFFER
+   * offsets are multiples of GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+   * @param pageSize size of each buffer object, larger allocations get a page
+   * of their own that is deleted when they are freed.
+   */
+  explicit BufferHeap(GLenum target     = GL_SHADER_STORAGE_BUFFER,
+                      uint64_t pageSize = 64U << 20U);
+  ~BufferHeap();
+
+  // alignment is raised to the one the target requires
+  Allocation allocate(uint64_t size, uint64_t alignment = 1U);
+  void free(const Allocation& allocation);
+  // where the allocation lives after a defragment()
+  Allocation resolve(const Allocation& allocation) const;
+
+  // write nBytes at offset relative to the allocation
+  void upload(const Allocation& allocation, const void* dataStart,
+              uint64_t nBytes, uint64_t offset = 0U);
+  void download(const Allocation& allocation, void* dataStart,
+                uint64_t nBytes, uint64_t offset = 0U) const;
+  // bind the range to an indexed target, e.g. a storage or uniform block
+  void bindRange(const Allocation& allocation, uint32_t location) const;
+
+  /**
+   * @brief Move the allocations of each page to its start on the GPU so the
+   * free space forms one range. Buffers stay the same, offsets change and have
+   * to be resolved again.
+   *
+   * @return number of bytes moved.
+   */
+  uint64_t defragment();
+
+  GLenum getTarget() const;
+  uint64_t getAlignment() const;
+  uint64_t getPageSize() const;
+  Statistics getStatistics() const;
+
+ private:
+  BufferHeap(const BufferHeap&) = delete;
+  BufferHeap& operator=(const BufferHeap&) = delete;
+
+  struct Page {
+    // INVALID_HANDLE once a dedicated page was deleted, the slot is reused
+    uint32_t handle;
+    TlsfAllocator allocator;
+    // holds a single allocation larger than the page size
+    bool dedicated;
+  };
+
+  // index of the new page
+  uint32_t addPage(uint64_t size, bool dedicated);
+  // resolved allocation, throws if the range does not lie inside it
+  Allocation resolveRange(const char* function, const Allocation& allocation,
+                          uint64_t offset, uint64_t nBytes) const;
+
+  GLenum mTarget;
+  uint64_t mAlignment;
+  uint64_t mPageSize;
+  std::vector<Page> mPages;
+  // staging for moves overlapping their own source
+  uint32_t mScratch;
+  uint64_t mScratchSize;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_BUFFER_HEAP_H
@@ -15,8 +15,12 @@
 
 namespace prgl {
 
+class QuadRenderer;
+
 class ContextImplementation {
   GLFWwindow* mGlfwWindow;
+  // created on first use, destroyed while the context still exists
+  std::shared_ptr<QuadRenderer> mQuadRenderer;
 
   static void initGLFW();
 
@@ -39,6 +43,12 @@ class ContextImplementation {
   [[noreturn]] static void onError(int32_t errorCode, const char* errorMessage);
 
   void makeCurrent() const;
+
+  // renderer for this context, e.g. for Texture2d::render
+  QuadRenderer& getQuadRenderer();
+
+  // the context current on this thread, nullptr if none was created by prgl
+  static ContextImplementation* GetCurrent();
 };
 
 }  // namespace prgl
@@ -16,6 +16,7 @@
 #include "prgl/GlslProgram.hxx"
 #include "prgl/ShaderStorageBuffer.hxx"
 #include "prgl/Texture2d.hxx"
+#include "prgl/Texture2dArray.hxx"
 
 namespace prgl {
 
@@ -25,33 +26,71 @@ namespace prgl {
  */
 class GlslComputeShader final : public GlslProgram {
  public:
+  /**
+   * @brief Layout of the group counts read by dispatchComputeIndirect, a
+   * kernel writes it into a ShaderStorageBuffer to size the next one.
+   */
+  struct DispatchIndirectCommand {
+    uint32_t numGroupsX;
+    uint32_t numGroupsY;
+    uint32_t numGroupsZ;
+  };
+  static_assert(sizeof(DispatchIndirectCommand) == 12U,
+                "matches the layout of glDispatchComputeIndirect");
+
   static std::shared_ptr<GlslComputeShader> Create(
-    const std::string& glslSource);
+    const std::string& glslSource, const Defines& defines = Defines());
 
-  GlslComputeShader(const std::string& glslSource);
+  // defines are injected after the #version line, see InjectDefines
+  GlslComputeShader(const std::string& glslSource,
+                    const Defines& defines = Defines());
 
   ~GlslComputeShader() override;
 
+  // ends with GL_ALL_BARRIER_BITS unless a barrier tracker is set
   void execute(int32_t x, int32_t y, int32_t w, int32_t h);
 
   void bindImage2D(uint32_t unit, const std::shared_ptr<Texture2d>& texture,
-                   TextureAccess access);
+                   TextureAccess access, int32_t level = 0);
+  // bind a single layer of a texture array as image2D
+  void bindImage2D(uint32_t unit,
+                   const std::shared_ptr<Texture2dArray>& texture,
+                   uint32_t layer, TextureAccess access, int32_t level = 0);
+  // writes is only used by the barrier tracker
   void bindSSBO(uint32_t location,
-                const std::shared_ptr<ShaderStorageBuffer>& buffer);
+                const std::shared_ptr<ShaderStorageBuffer>& buffer,
+                bool writes = true);
+
+  // local size of the shader, queried once after linking
+  const vec3ui& getWorkGroupSize() const;
+  static vec3ui getMaxWorkGroupSize();
+  // work groups covering width x height x depth invocations, rounded up
+  vec3ui getGroupCount(uint32_t width, uint32_t height,
+                       uint32_t depth = 1U) const;
+  // dispatch without the implicit barrier of execute, for multi pass kernels,
+  // with a barrier tracker set the bindings are declared and the barrier they
+  // require is issued first
+  void dispatchCompute(uint32_t num_groups_x, uint32_t num_groups_y,
+                       uint32_t num_groups_z);
+  /**
+   * @brief Dispatch with the group counts stored at offset in buffer, see
+   * DispatchIndirectCommand. Without a barrier tracker a command barrier is
+   * issued first so that counts written by a previous kernel are seen.
+   */
+  void dispatchComputeIndirect(
+    const std::shared_ptr<ShaderStorageBuffer>& buffer,
+    uint32_t offset = 0U);
+  void memoryBarrier(GLbitfield barrierType = GL_ALL_BARRIER_BITS);
 
  private:
   GlslComputeShader(const GlslComputeShader&) = delete;
   GlslComputeShader& operator=(const GlslComputeShader&) = delete;
 
   void attach(const std::string& source);
-
-  vec3ui getWorkGroupSize() const;
-  static vec3ui getMaxWorkGroupSize();
-  void dispatchCompute(uint32_t num_groups_x, uint32_t num_groups_y,
-                       uint32_t num_groups_z);
-  void memoryBarrier(GLbitfield barrierType = GL_ALL_BARRIER_BITS);
+  void queryWorkGroupSize();
 
   uint32_t mShaderHandle;
+  vec3ui mWorkGroupSize;
 };
 
 }  // namespace prgl
@@ -8,8 +8,13 @@
 #ifndef PRGL_PROGRAM_H
 #define PRGL_PROGRAM_H
 
+#include <map>
 #include <memory>
+#include <string>
+#include <unordered_map>
 
+#include "prgl/BarrierTracker.hxx"
+#include "prgl/ProgramBinaryCache.hxx"
 #include "prgl/Texture2d.hxx"
 #include "prgl/glCommon.hxx"
 
@@ -23,6 +28,44 @@ namespace prgl {
  */
 class GlslProgram {
  public:
+  /**
+   * @brief Active uniform or vertex attribute, queried once after linking.
+   */
+  struct Variable {
+    std::string name;
+    int32_t location;
+    // GL type enum, e.g. GL_FLOAT_VEC3 or GL_SAMPLER_2D
+    uint32_t type;
+    int32_t arraySize;
+  };
+
+  /**
+   * @brief Active uniform block or shader storage block.
+   */
+  struct Block {
+    std::string name;
+    uint32_t index;
+    int32_t binding;
+    int32_t dataSize;
+  };
+
+  /**
+   * @brief Pre-resolved uniform location, setting a value through a handle
+   * needs no name lookup and no bound program. Handles become invalid when
+   * the program is linked again.
+   */
+  struct UniformHandle {
+    int32_t location = -1;
+    uint32_t type    = 0U;
+
+    bool isValid() const {
+      return location >= 0;
+    }
+  };
+
+  // preprocessor symbols and their values, e.g. {"RADIUS", "4"}
+  using Defines = std::map<std::string, std::string>;
+
   static std::shared_ptr<GlslProgram> Create();
 
   GlslProgram();
@@ -64,19 +107,103 @@ class GlslProgram {
   void bindSampler(const std::string& name, uint32_t unit,
                    const std::shared_ptr<Texture2d>& texture);
 
+  // bindings are declared to the tracker before each dispatch, nullptr
+  // disables tracking
+  void setBarrierTracker(const std::shared_ptr<BarrierTracker>& tracker);
+  const std::shared_ptr<BarrierTracker>& getBarrierTracker() const;
+
+  // connect a uniform block to a binding point, see UniformBuffer
+  void bindUniformBlock(const std::string& name, uint32_t binding);
+
+  // resolve once and keep, an invalid handle is returned for unknown names
+  UniformHandle getUniform(const std::string& name) const;
+
+  // debug builds throw if the type does not match the uniform
+  void set(const UniformHandle& handle, int32_t value);
+  void set(const UniformHandle& handle, uint32_t value);
+  void set(const UniformHandle& handle, float value);
+  void set(const UniformHandle& handle, const vec2f& value);
+  void set(const UniformHandle& handle, const vec3f& value);
+  void set(const UniformHandle& handle, const vec4f& value);
+  void set(const UniformHandle& handle, const vec2i& value);
+  void set(const UniformHandle& handle, const vec3i& value);
+  void set(const UniformHandle& handle, const vec4i& value);
+  void set(const UniformHandle& handle, const vec2ui& value);
+  void set(const UniformHandle& handle, const vec3ui& value);
+  void set(const UniformHandle& handle, const vec4ui& value);
+  void set(const UniformHandle& handle, const mat3x3<float>& value);
+  void set(const UniformHandle& handle, const mat4x4<float>& value);
+
+  // reflection data of the last successful link
+  const std::unordered_map<std::string, Variable>& getUniforms() const;
+  const std::unordered_map<std::string, Variable>& getAttributes() const;
+  const std::unordered_map<std::string, Block>& getUniformBlocks() const;
+  const std::unordered_map<std::string, Block>& getStorageBlocks() const;
+
   auto isBound() const -> bool;
 
   static std::string ReadShaderFromFile(const std::string& filename);
+  /**
+   * @brief Insert a #define for each entry after the #version line, followed
+   * by a #line directive so compiler messages keep their line numbers. Makes
+   * specialized variants of a shader without branching on uniforms.
+   */
+  static std::string InjectDefines(const std::string& source,
+                                   const Defines& defines);
+
+  // programs linked afterwards go through the cache, nullptr disables it
+  static void SetBinaryCache(const std::shared_ptr<ProgramBinaryCache>& cache);
+  static const std::shared_ptr<ProgramBinaryCache>& GetBinaryCache();
 
  protected:
   static uint32_t getCurrentlyBoundProgram();
   static uint32_t compile(const std::string& source, uint32_t type);
+  // compile split in two, see GlslRenderingPipelineProgram::build
+  static uint32_t startCompile(const std::string& source, uint32_t type);
+  static void checkCompile(uint32_t shader, const std::string& source);
+
+  // query the active resources, call after every successful link
+  void reflect();
+
+  // a texture or buffer bound to the program and how the shader accesses it
+  struct TrackedBinding {
+    bool texture;
+    uint32_t id;
+    bool writes;
+  };
+  // replaces the binding of the same kind at unit or location
+  void trackBinding(BarrierTracker::Access access, uint32_t unit,
+                    const TrackedBinding& binding);
+  // declare all bound resources to the barrier tracker, if there is one
+  void declareBindings() const;
+  // a resource written by the program flushes later reads, e.g. downloads,
+  // through the tracker of the program
+  template <typename Resource>
+  void attachBarrierTracker(Resource& resource, bool writes) const {
+    if (mBarrierTracker && writes) {
+      resource.setBarrierTracker(mBarrierTracker);
+    }
+  }
 
   uint32_t mProgHandle;
+  std::shared_ptr<BarrierTracker> mBarrierTracker;
+  std::map<std::pair<BarrierTracker::Access, uint32_t>, TrackedBinding>
+    mTrackedBindings;
 
  private:
   GlslProgram(const GlslProgram&) = delete;
   GlslProgram& operator=(const GlslProgram&) = delete;
+
+  int32_t getUniformLocation(const std::string& name);
+  void reflectBlocks(uint32_t interface,
+                     std::unordered_map<std::string, Block>& blocks) const;
+
+  std::unordered_map<std::string, Variable> mUniforms;
+  std::unordered_map<std::string, Variable> mAttributes;
+  std::unordered_map<std::string, Block> mUniformBlocks;
+  std::unordered_map<std::string, Block> mStorageBlocks;
+  // locations by name as used by the string setters, including misses
+  std::unordered_map<std::string, int32_t> mLocations;
 };
 
 }  // namespace prgl
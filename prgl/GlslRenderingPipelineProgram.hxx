@@ -9,7 +9,9 @@
 #define PRGL_GLSL_RENDERING_PIPELINE_PROGRAM_H
 
 #include <array>
+#include <map>
 #include <memory>
+#include <string>
 
 #include "prgl/GlslProgram.hxx"
 #include "prgl/ShaderStorageBuffer.hxx"
@@ -33,12 +35,35 @@ class GlslRenderingPipelineProgram final : public GlslProgram {
   void attachGeometryShader(const std::string& source);
   void attachFragmentShader(const std::string& source);
 
+  /**
+   * @brief Replace all stages and link once. Each attach*Shader call above
+   * links the program again, build is the way to create a complete program.
+   *
+   * With wait set to false neither compile nor link status are queried, so
+   * many programs can be built back to back and compiled concurrently when
+   * GL_KHR_parallel_shader_compile is available. Poll isLinkComplete() and
+   * call finish() before the program is used.
+   *
+   * @param sources source by shader type, e.g. GL_VERTEX_SHADER.
+   */
+  void build(const std::map<uint32_t, std::string>& sources,
+             bool wait = true);
+  // build with the defines injected into every stage, see InjectDefines
+  void build(const std::map<uint32_t, std::string>& sources,
+             const Defines& defines, bool wait = true);
+  // never blocks, always true without GL_KHR_parallel_shader_compile
+  bool isLinkComplete() const;
+  // wait for the link, throws on compile or link errors
+  void finish();
+
  private:
   GlslRenderingPipelineProgram(const GlslRenderingPipelineProgram&) = delete;
   GlslRenderingPipelineProgram& operator=(const GlslRenderingPipelineProgram&) =
     delete;
 
-  uint32_t createShader(const std::string& source, GLenum shaderType);
+  void createShader(const std::string& source, GLenum shaderType);
+  void link();
+  uint32_t& getShader(GLenum shaderType);
   void cleanupShader(uint32_t& shader);
 
   uint32_t mVertProg;
@@ -46,6 +71,11 @@ class GlslRenderingPipelineProgram final : public GlslProgram {
   uint32_t mTesselationEvaluationProg;
   uint32_t mGeometryProg;
   uint32_t mFragProg;
+  // source by shader type, needed for the cache key and cache misses
+  std::map<uint32_t, std::string> mSources;
+  ProgramBinaryCache::Key mCacheKey;
+  // linked without checking the status yet
+  bool mPending;
 };
 
 }  // namespace prgl
@@ -0,0 +1,111 @@
+/**
+ * @file MappedImageFile.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_MAPPED_IMAGE_FILE_H
+#define PRGL_MAPPED_IMAGE_FILE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "prgl/Texture2d.hxx"
+
+namespace prgl {
+
+/**
+ * @brief Read only memory mapping of an image file. Pixels are read straight
+ * from the page cache, upload() copies them band by band into persistently
+ * mapped pixel unpack buffers without any heap copy in between.
+ *
+ * Supported are binary PGM/PPM (P5, P6 with 8 or 16 bit), PFM (Pf, PF) and
+ * headerless raw files described by a RawLayout. Only available on POSIX
+ * systems.
+ */
+class MappedImageFile final {
+ public:
+  // madvise hints for the kernel
+  enum class Advice : uint32_t {
+    Normal,
+    Sequential,
+    Random,
+    WillNeed,
+    DontNeed
+  };
+
+  /**
+   * @brief Description of a raw file without header.
+   */
+  struct RawLayout {
+    uint32_t width;
+    uint32_t height;
+    TextureFormat format;
+    DataType type;
+    // bytes to skip at the start of the file
+    std::size_t headerSize;
+    bool bigEndian;
+    // first row of the file is the top row of the image
+    bool topDown;
+  };
+
+  template <typename... T>
+  static std::shared_ptr<MappedImageFile> Create(T&&... args) {
+    return std::make_shared<MappedImageFile>(std::forward<T>(args)...);
+  }
+
+  // PGM, PPM or PFM file, the layout is read from the header
+  explicit MappedImageFile(const std::string& path);
+  MappedImageFile(const std::string& path, const RawLayout& layout);
+  ~MappedImageFile();
+
+  void advise(Advice advice) const;
+  // advice for rows of the file in file order
+  void advise(Advice advice, uint32_t firstRow, uint32_t rowCount) const;
+
+  /**
+   * @brief Upload the image into level 0 of a texture of the same size,
+   * format and type, bandRows rows per transfer and ringSize transfers in
+   * flight. Byte order and row order are fixed on the way.
+   */
+  void upload(Texture2d& texture, uint32_t bandRows = 64U,
+              uint32_t ringSize = 3U) const;
+
+  // row in file order, valid as long as this object is alive
+  const uint8_t* getRow(uint32_t row) const;
+
+  uint32_t getWidth() const;
+  uint32_t getHeight() const;
+  TextureFormat getFormat() const;
+  DataType getType() const;
+  std::size_t getRowSize() const;
+  bool isBigEndian() const;
+  bool isTopDown() const;
+
+ private:
+  MappedImageFile(const MappedImageFile&) = delete;
+  MappedImageFile& operator=(const MappedImageFile&) = delete;
+
+  void map(const std::string& path);
+  void unmap();
+  void parseHeader();
+  void validate() const;
+
+  int mFile;
+  uint8_t* mMapped;
+  std::size_t mFileSize;
+  std::size_t mDataOffset;
+  uint32_t mWidth;
+  uint32_t mHeight;
+  TextureFormat mFormat;
+  DataType mType;
+  std::size_t mRowSize;
+  bool mBigEndian;
+  bool mTopDown;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_MAPPED_IMAGE_FILE_H
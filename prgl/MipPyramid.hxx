@@ -0,0 +1,64 @@
+/**
+ * @file MipPyramid.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_MIP_PYRAMID_H
+#define PRGL_MIP_PYRAMID_H
+
+#include <memory>
+
+#include "prgl/GlslComputeShader.hxx"
+#include "prgl/Texture2d.hxx"
+
+namespace prgl {
+
+/**
+ * @brief Filter used to compute a mip level from the next finer one.
+ */
+enum class MipFilter : int32_t {
+  // average of the covered texels
+  Box = 0,
+  // Kaiser windowed sinc over 6x6 texels, sharper than box
+  Kaiser = 1,
+  // maximum of the covered texels, e.g. a conservative depth (Hi-Z) pyramid
+  Max = 2,
+  // minimum of the covered texels
+  Min = 3
+};
+
+/**
+ * @brief Builds the mip chain of a Texture2d with a compute shader, level by
+ * level from level 0. Unlike glGenerateMipmap the filter can be chosen and
+ * odd sized levels are handled conservatively (three texels per axis are
+ * covered), which Hi-Z culling relies on.
+ */
+class MipPyramid final {
+ public:
+  static std::shared_ptr<MipPyramid> Create();
+
+  MipPyramid();
+  ~MipPyramid();
+
+  /**
+   * @brief Overwrite levels 1 to getMipLevelCount() - 1 of the texture.
+   *
+   * @param texture texture with a sized, uncompressed internal format created
+   * with mip maps.
+   * @param filter the reduction filter.
+   */
+  void generate(const std::shared_ptr<Texture2d>& texture,
+                MipFilter filter = MipFilter::Box);
+
+ private:
+  MipPyramid(const MipPyramid&) = delete;
+  MipPyramid& operator=(const MipPyramid&) = delete;
+
+  std::shared_ptr<GlslComputeShader> mShader;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_MIP_PYRAMID_H
@@ -0,0 +1,116 @@
+/**
+ * @file ParallelPrimitives.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_PARALLEL_PRIMITIVES_H
+#define PRGL_PARALLEL_PRIMITIVES_H
+
+#include <memory>
+#include <vector>
+
+#include "prgl/GlslComputeShader.hxx"
+#include "prgl/ShaderStorageBuffer.hxx"
+
+namespace prgl {
+
+enum class ScanType : uint32_t { Exclusive, Inclusive };
+
+/**
+ * @brief Compute shader building blocks working in place on uint32_t elements
+ * of shader storage buffers: prefix scan, key/value radix sort, histogram and
+ * stream compaction. Offsets and counts are given in elements.
+ *
+ * All functions only record GPU commands, nothing is read back except by
+ * getCompactedCount(). Each function ends with a shader storage and buffer
+ * update barrier, results are visible to shaders and to downloads and copies
+ * afterwards.
+ */
+class ParallelPrimitives final {
+ public:
+  // histogram bins are accumulated in shared memory of this size
+  static constexpr uint32_t MaxBinCount = 256U;
+
+  static std::shared_ptr<ParallelPrimitives> Create();
+
+  ParallelPrimitives();
+  ~ParallelPrimitives();
+
+  // prefix sum of the elements [offset, offset + count)
+  void scan(const std::shared_ptr<ShaderStorageBuffer>& data, uint32_t count,
+            ScanType type = ScanType::Exclusive, uint32_t offset = 0U);
+
+  /**
+   * @brief Stable ascending LSD radix sort, 4 bits per pass.
+   *
+   * @param values permuted like the keys, may be nullptr.
+   * @param keyBits only the lowest keyBits of the keys are sorted, fewer bits
+   * need fewer passes.
+   */
+  void sort(const std::shared_ptr<ShaderStorageBuffer>& keys,
+            const std::shared_ptr<ShaderStorageBuffer>& values,
+            uint32_t count, uint32_t offset = 0U, uint32_t keyBits = 32U);
+
+  /**
+   * @brief Count values into bins, bin = min(value / binWidth, binCount - 1).
+   * The first binCount elements of bins are overwritten.
+   */
+  void histogram(const std::shared_ptr<ShaderStorageBuffer>& values,
+                 uint32_t count,
+                 const std::shared_ptr<ShaderStorageBuffer>& bins,
+                 uint32_t binCount, uint32_t binWidth = 1U,
+                 uint32_t offset = 0U);
+
+  /**
+   * @brief Copy the elements of input whose flag is not zero to the start of
+   * output, keeping their order. The number of elements kept is written to
+   * getCountBuffer(). input and flags may be the same buffer.
+   */
+  void compact(const std::shared_ptr<ShaderStorageBuffer>& input,
+               const std::shared_ptr<ShaderStorageBuffer>& flags,
+               const std::shared_ptr<ShaderStorageBuffer>& output,
+               uint32_t count, uint32_t offset = 0U);
+
+  // single uint32_t with the result of the last compact
+  const std::shared_ptr<ShaderStorageBuffer>& getCountBuffer() const;
+  // reads the count back, waits for the GPU
+  uint32_t getCompactedCount() const;
+
+ private:
+  ParallelPrimitives(const ParallelPrimitives&) = delete;
+  ParallelPrimitives& operator=(const ParallelPrimitives&) = delete;
+
+  // buffer that only grows
+  struct Scratch {
+    std::shared_ptr<ShaderStorageBuffer> buffer;
+    uint32_t capacity;
+  };
+
+  static void reserve(Scratch& scratch, uint32_t nBytes);
+  static void dispatch(GlslComputeShader& shader, uint32_t groups);
+  void scanLevel(const std::shared_ptr<ShaderStorageBuffer>& data,
+                 uint32_t offset, uint32_t count, bool inclusive,
+                 uint32_t level);
+
+  std::shared_ptr<GlslComputeShader> mScanShader;
+  std::shared_ptr<GlslComputeShader> mAddShader;
+  std::shared_ptr<GlslComputeShader> mCountShader;
+  std::shared_ptr<GlslComputeShader> mScatterShader;
+  std::shared_ptr<GlslComputeShader> mHistogramShader;
+  std::shared_ptr<GlslComputeShader> mMarkShader;
+  std::shared_ptr<GlslComputeShader> mCompactShader;
+
+  // block sums of each scan level
+  std::vector<Scratch> mSums;
+  Scratch mKeys;
+  Scratch mValues;
+  Scratch mDigitCounts;
+  Scratch mPositions;
+  std::shared_ptr<ShaderStorageBuffer> mCount;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_PARALLEL_PRIMITIVES_H
@@ -0,0 +1,193 @@
+/**
+ * @file PassGraph.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_PASS_GRAPH_H
+#define PRGL_PASS_GRAPH_H
+
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "prgl/BarrierTracker.hxx"
+#include "prgl/RenderTargetPool.hxx"
+#include "prgl/ShaderStorageBuffer.hxx"
+#include "prgl/Texture2d.hxx"
+
+namespace prgl {
+
+/**
+ * @brief Declarative chain of compute and raster passes.
+ *
+ * Each pass declares the textures and buffers it reads and writes. compile()
+ * orders the passes by these dependencies, culls passes whose results are
+ * never used and assigns the transient resources created by the graph to GL
+ * objects. Transients whose lifetimes do not overlap share the same object,
+ * textures if their descriptors match, buffers if the object is large enough.
+ * execute() creates missing objects, issues the barriers between the passes
+ * through a BarrierTracker and runs them.
+ *
+ * A write creates a new version of the resource, the handle returned by
+ * write() is what later passes read. Passes writing imported resources or
+ * marked with setSideEffect() are never culled. The GL objects are kept for
+ * the next compile(), so a graph rebuilt every frame reuses them.
+ */
+class PassGraph final {
+ public:
+  // version of a texture or buffer
+  using Handle = uint32_t;
+  // records the GL commands of a pass, resources are looked up with
+  // getTexture and getBuffer
+  using Execute = std::function<void(const PassGraph& graph)>;
+  using TextureDescriptor = RenderTargetPool::Descriptor;
+
+  static constexpr uint32_t Culled = std::numeric_limits<uint32_t>::max();
+
+  struct Statistics {
+    uint32_t passes;
+    uint32_t culled;
+    uint32_t transientTextures;
+    uint32_t transientBuffers;
+    // GL objects backing the transients
+    uint32_t physicalTextures;
+    uint32_t physicalBuffers;
+  };
+
+  template <typename... T>
+  static std::shared_ptr<PassGraph> Create(T&&... args) {
+    return std::make_shared<PassGraph>(std::forward<T>(args)...);
+  }
+
+  /**
+   * @param tracker shared with programs that declare their own bindings, a
+   * new one is created if nullptr.
+   */
+  explicit PassGraph(std::shared_ptr<BarrierTracker> tracker = nullptr);
+  ~PassGraph();
+
+  // transient resources, written by the first pass using them
+  Handle createTexture(const std::string& name,
+                       const TextureDescriptor& descriptor);
+  Handle createBuffer(const std::string& name, uint32_t nBytes);
+  // resources owned by the caller, their content is kept
+  Handle importTexture(const std::string& name,
+                       const std::shared_ptr<Texture2d>& texture);
+  Handle importBuffer(const std::string& name,
+                      const std::shared_ptr<ShaderStorageBuffer>& buffer);
+
+  // returns the index of the pass
+  uint32_t addPass(const std::string& name, Execute execute);
+  void read(uint32_t pass, Handle resource, BarrierTracker::Access access);
+  // only the latest version of a resource can be written
+  Handle write(uint32_t pass, Handle resource, BarrierTracker::Access access);
+  void setSideEffect(uint32_t pass);
+
+  // sort, cull and assign GL objects, execute() compiles if needed
+  void compile();
+  void execute();
+  // remove passes and resources, the GL objects are kept for reuse
+  void reset();
+
+  // valid while a pass is executed
+  const std::shared_ptr<Texture2d>& getTexture(Handle resource) const;
+  const std::shared_ptr<ShaderStorageBuffer>& getBuffer(
+    Handle resource) const;
+
+  // pass indices in execution order, culled passes are left out
+  const std::vector<uint32_t>& getOrder() const;
+  bool isCulled(uint32_t pass) const;
+  // GL object slot a transient is assigned to, Culled if unused
+  uint32_t getPhysicalIndex(Handle resource) const;
+  const std::shared_ptr<BarrierTracker>& getBarrierTracker() const;
+  Statistics getStatistics() const;
+
+ private:
+  PassGraph(const PassGraph&) = delete;
+  PassGraph& operator=(const PassGraph&) = delete;
+
+  static constexpr uint32_t NoPass   = std::numeric_limits<uint32_t>::max();
+  static constexpr Handle NoVersion = std::numeric_limits<uint32_t>::max();
+
+  enum class Kind : uint32_t { Texture, Buffer };
+
+  struct Resource {
+    std::string name;
+    Kind kind;
+    TextureDescriptor descriptor;
+    uint32_t nBytes;
+    bool imported;
+    std::shared_ptr<Texture2d> texture;
+    std::shared_ptr<ShaderStorageBuffer> buffer;
+    Handle latest;
+    // assigned by compile()
+    uint32_t physical;
+  };
+
+  struct Version {
+    uint32_t resource;
+    // version the producer wrote over
+    Handle previous;
+    uint32_t producer;
+    std::vector<uint32_t> readers;
+  };
+
+  struct Use {
+    Handle version;
+    BarrierTracker::Access access;
+    bool writes;
+  };
+
+  struct Pass {
+    std::string name;
+    Execute execute;
+    std::vector<Use> uses;
+    bool sideEffect;
+    bool culled;
+  };
+
+  struct PhysicalTexture {
+    TextureDescriptor descriptor;
+    std::shared_ptr<Texture2d> texture;
+    // first order position the slot is free again
+    uint32_t freeFrom;
+  };
+
+  struct PhysicalBuffer {
+    uint32_t capacity;
+    // size of the GL buffer, it grows to capacity in execute()
+    uint32_t allocated;
+    std::shared_ptr<ShaderStorageBuffer> buffer;
+    uint32_t freeFrom;
+  };
+
+  Handle addResource(Resource resource);
+  const Version& getVersion(Handle resource) const;
+  Pass& getPass(uint32_t pass);
+  // passes that have to run before the pass, withReaders adds the passes
+  // reading what the pass overwrites
+  std::vector<uint32_t> getDependencies(uint32_t pass,
+                                        bool withReaders) const;
+  void cull();
+  void sort();
+  void assignPhysical();
+  void realize(const Resource& resource);
+
+  std::shared_ptr<BarrierTracker> mTracker;
+  std::vector<Resource> mResources;
+  std::vector<Version> mVersions;
+  std::vector<Pass> mPasses;
+  std::vector<uint32_t> mOrder;
+  std::vector<PhysicalTexture> mTextures;
+  std::vector<PhysicalBuffer> mBuffers;
+  bool mCompiled;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_PASS_GRAPH_H
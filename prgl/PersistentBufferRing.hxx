@@ -0,0 +1,84 @@
+/**
+ * @file PersistentBufferRing.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_PERSISTENT_BUFFER_RING_H
+#define PRGL_PERSISTENT_BUFFER_RING_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "prgl/glCommon.hxx"
+
+namespace prgl {
+
+/**
+ * @brief Buffer object split into equally sized slots that stays mapped for its
+ * whole lifetime (glBufferStorage + GL_MAP_PERSISTENT_BIT). Every slot is
+ * guarded by a fence so the host never touches memory the GPU still uses.
+ */
+class PersistentBufferRing final {
+ public:
+  /**
+   * @brief Direction of the host access to the mapped memory.
+   */
+  enum class Access : uint32_t {
+    // host writes, GPU reads (e.g. pixel unpack, uniform or storage data)
+    Write,
+    // GPU writes, host reads (e.g. pixel pack, readback staging)
+    Read
+  };
+
+  template <typename... T>
+  static std::shared_ptr<PersistentBufferRing> Create(T&&... args) {
+    return std::make_shared<PersistentBufferRing>(std::forward<T>(args)...);
+  }
+
+  PersistentBufferRing(GLenum target, std::size_t slotSize, uint32_t slotCount,
+                       Access access, std::size_t slotAlignment = 1U);
+  ~PersistentBufferRing();
+
+  void bind(bool bind) const;
+
+  // advance to the next slot and block until the GPU released it
+  uint32_t acquire();
+
+  // fence all commands issued so far that use the slot
+  void fence(uint32_t slot);
+  // non blocking check if the GPU is done with the slot
+  bool isSignaled(uint32_t slot) const;
+  // block until the GPU is done with the slot
+  void wait(uint32_t slot) const;
+
+  void* getMappedSlot(uint32_t slot) const;
+  std::size_t getSlotOffset(uint32_t slot) const;
+  std::size_t getSlotSize() const;
+  uint32_t getSlotCount() const;
+  uint32_t getCurrentSlot() const;
+
+  uint32_t getHandle() const;
+  GLenum getTarget() const;
+
+ private:
+  PersistentBufferRing(const PersistentBufferRing&) = delete;
+  PersistentBufferRing& operator=(const PersistentBufferRing&) = delete;
+
+  void releaseFence(uint32_t slot);
+
+  uint32_t mHandle;
+  GLenum mTarget;
+  std::size_t mSlotSize;
+  std::size_t mSlotStride;
+  uint32_t mSlotCount;
+  uint32_t mCurrent;
+  uint8_t* mMapped;
+  std::vector<GLsync> mFences;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_PERSISTENT_BUFFER_RING_H
@@ -0,0 +1,81 @@
+/**
+ * @file ProgramBinaryCache.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_PROGRAM_BINARY_CACHE_H
+#define PRGL_PROGRAM_BINARY_CACHE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "prgl/glCommon.hxx"
+
+namespace prgl {
+
+/**
+ * @brief On-disk cache of linked program binaries (glGetProgramBinary).
+ *
+ * Entries are named by a hash of all stage sources and the vendor, renderer
+ * and version string of the driver, so a driver update invalidates them. The
+ * sources and driver string are stored in the entry as well and compared on
+ * load, a hash collision is a miss. Entries that do not match and binaries
+ * the driver rejects are removed and the program is compiled again.
+ * Install it with GlslProgram::SetBinaryCache(). The methods are thread safe
+ * so programs can also be built on a shared worker context.
+ */
+class ProgramBinaryCache final {
+ public:
+  struct Key {
+    // file name of the entry, a hash of the identity
+    std::string name;
+    // driver string and stage sources, compared with the entry on load
+    std::string identity;
+  };
+
+  static std::shared_ptr<ProgramBinaryCache> Create(
+    const std::string& directory);
+
+  // the directory is created if it does not exist
+  explicit ProgramBinaryCache(const std::string& directory);
+  ~ProgramBinaryCache();
+
+  // key of a program from its sources by shader type, needs a GL context
+  Key makeKey(const std::map<uint32_t, std::string>& sources);
+
+  /**
+   * @brief Load a cached binary into program.
+   *
+   * @return true if the program is linked, false if there is no entry or the
+   * binary was rejected.
+   */
+  bool load(uint32_t program, const Key& key);
+
+  // store the binary of a linked program, failures are only reported
+  void store(uint32_t program, const Key& key) const;
+
+  const std::string& getDirectory() const;
+  uint32_t getHits() const;
+  uint32_t getMisses() const;
+
+ private:
+  ProgramBinaryCache(const ProgramBinaryCache&) = delete;
+  ProgramBinaryCache& operator=(const ProgramBinaryCache&) = delete;
+
+  std::string getPath(const Key& key) const;
+
+  std::string mDirectory;
+  // vendor, renderer and version string, queried on first use
+  std::string mDriver;
+  uint32_t mHits;
+  uint32_t mMisses;
+  mutable std::mutex mMutex;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_PROGRAM_BINARY_CACHE_H
@@ -0,0 +1,104 @@
+/**
+ * @file QuadRenderer.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_QUAD_RENDERER_H
+#define PRGL_QUAD_RENDERER_H
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "prgl/BarrierTracker.hxx"
+#include "prgl/GlslRenderingPipelineProgram.hxx"
+#include "prgl/Texture2d.hxx"
+#include "prgl/Texture2dArray.hxx"
+#include "prgl/TextureAtlas.hxx"
+#include "prgl/VertexArrayObject.hxx"
+#include "prgl/VertexBufferObject.hxx"
+
+namespace prgl {
+
+/**
+ * @brief Collects textured rectangles and draws them with instanced draw calls
+ * (one per run of quads sharing a texture). Works on core profiles. Images of
+ * a TextureAtlas share one texture and are drawn with a single call.
+ */
+class QuadRenderer final {
+ public:
+  static std::shared_ptr<QuadRenderer> Create();
+
+  QuadRenderer();
+  ~QuadRenderer();
+
+  /**
+   * @brief Queue a textured rectangle. The texture must stay alive until the
+   * next flush.
+   *
+   * @param texture the texture to draw.
+   * @param posX left edge in pixels of the current viewport.
+   * @param posY top edge in pixels of the current viewport.
+   * @param width width in pixels.
+   * @param height height in pixels.
+   * @param texCoords u0, v0, u1, v1 of the texture region to draw.
+   */
+  void add(const Texture2d& texture, float posX, float posY, float width,
+           float height, const vec4f& texCoords = {0.0F, 0.0F, 1.0F, 1.0F});
+  // queue a textured rectangle showing a layer of a texture array
+  void add(const Texture2dArray& texture, uint32_t layer, float posX,
+           float posY, float width, float height,
+           const vec4f& texCoords = {0.0F, 0.0F, 1.0F, 1.0F});
+  // queue a textured rectangle showing an image packed into the atlas
+  void add(const TextureAtlas& atlas, const TextureAtlas::Region& region,
+           float posX, float posY, float width, float height);
+
+  // draw all queued quads, optionally converting linear colors to sRGB
+  void flush(bool convert_sRGB = false);
+
+  // statistics of the last flush
+  uint32_t getDrawCallCount() const;
+  uint32_t getQuadCount() const;
+
+ private:
+  QuadRenderer(const QuadRenderer&) = delete;
+  QuadRenderer& operator=(const QuadRenderer&) = delete;
+
+  struct Batch {
+    uint32_t texture;
+    bool isArray;
+    uint32_t first;
+    uint32_t count;
+    // of the texture, declares the fetches of the draw
+    std::shared_ptr<BarrierTracker> tracker;
+  };
+
+  void addQuad(uint32_t texture, bool isArray,
+               const std::shared_ptr<BarrierTracker>& tracker, uint32_t layer,
+               float posX, float posY, float width, float height,
+               const vec4f& texCoords);
+
+  std::shared_ptr<GlslRenderingPipelineProgram> mProgram;
+  std::shared_ptr<GlslRenderingPipelineProgram> mArrayProgram;
+  std::shared_ptr<VertexArrayObject> mVao;
+  // per instance x, y, width, height
+  std::shared_ptr<VertexBufferObject> mRects;
+  // per instance u0, v0, u1, v1
+  std::shared_ptr<VertexBufferObject> mTexCoords;
+  // per instance texture array layer
+  std::shared_ptr<VertexBufferObject> mLayers;
+
+  std::vector<vec4f> mRectData;
+  std::vector<vec4f> mTexCoordData;
+  std::vector<std::array<float, 1U>> mLayerData;
+  std::vector<Batch> mBatches;
+
+  uint32_t mDrawCalls;
+  uint32_t mQuads;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_QUAD_RENDERER_H
@@ -0,0 +1,81 @@
+/**
+ * @file ReadbackQueue.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_READBACK_QUEUE_H
+#define PRGL_READBACK_QUEUE_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "prgl/PersistentBufferRing.hxx"
+
+namespace prgl {
+
+/**
+ * @brief Non blocking GPU -> host transfers. Each readback copies into a slot
+ * of a persistently mapped staging ring and is fenced. The host memory is only
+ * read once the fence has signalled, the result is delivered through a future
+ * and an optional callback when poll() finds it completed.
+ */
+class ReadbackQueue final {
+ public:
+  using Callback = std::function<void(const std::vector<uint8_t>&)>;
+  // records the GL command writing into the bound staging buffer at offset
+  using CopyCommand = std::function<void(std::size_t offset)>;
+
+  template <typename... T>
+  static std::shared_ptr<ReadbackQueue> Create(T&&... args) {
+    return std::make_shared<ReadbackQueue>(std::forward<T>(args)...);
+  }
+
+  /**
+   * @param target staging buffer binding used during the copy, e.g.
+   * GL_PIXEL_PACK_BUFFER or GL_COPY_WRITE_BUFFER.
+   * @param slotSize maximum number of bytes per readback.
+   * @param depth number of readbacks that can be in flight.
+   */
+  ReadbackQueue(GLenum target, std::size_t slotSize, uint32_t depth);
+  ~ReadbackQueue();
+
+  // record a readback of nBytes, blocks only if depth readbacks are in flight
+  std::future<std::vector<uint8_t>> enqueue(std::size_t nBytes,
+                                            const CopyCommand& copy,
+                                            Callback callback = nullptr);
+
+  // deliver all completed readbacks in order, returns the number delivered
+  uint32_t poll();
+  // block until all readbacks are delivered
+  void finish();
+
+  uint32_t getPendingCount() const;
+  uint32_t getDepth() const;
+  std::size_t getSlotSize() const;
+
+ private:
+  ReadbackQueue(const ReadbackQueue&) = delete;
+  ReadbackQueue& operator=(const ReadbackQueue&) = delete;
+
+  struct Pending {
+    uint32_t slot;
+    std::size_t nBytes;
+    std::promise<std::vector<uint8_t>> promise;
+    Callback callback;
+  };
+
+  void deliverOldest();
+
+  std::unique_ptr<PersistentBufferRing> mRing;
+  std::deque<Pending> mPending;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_READBACK_QUEUE_H
@@ -0,0 +1,63 @@
+/**
+ * @file RectanglePacker.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_RECTANGLE_PACKER_H
+#define PRGL_RECTANGLE_PACKER_H
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace prgl {
+
+/**
+ * @brief Packs rectangles into a fixed size area using the skyline bottom-left
+ * heuristic. Rectangles are never rotated.
+ */
+class RectanglePacker final {
+ public:
+  struct Rect {
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+  };
+
+  RectanglePacker(uint32_t width, uint32_t height);
+
+  // find a place for the rectangle, empty if it does not fit anymore
+  std::optional<Rect> insert(uint32_t width, uint32_t height);
+
+  void clear();
+
+  uint32_t getWidth() const;
+  uint32_t getHeight() const;
+  // ratio of the packed area to the total area
+  float getOccupancy() const;
+
+ private:
+  struct SkylineNode {
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+  };
+
+  std::optional<uint32_t> fit(std::size_t index, uint32_t width,
+                              uint32_t height) const;
+  void addSkylineLevel(std::size_t index, const Rect& rect);
+
+  uint32_t mWidth;
+  uint32_t mHeight;
+  uint64_t mUsedArea;
+  std::vector<SkylineNode> mSkyline;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_RECTANGLE_PACKER_H
@@ -0,0 +1,122 @@
+/**
+ * @file RenderTargetPool.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_RENDER_TARGET_POOL_H
+#define PRGL_RENDER_TARGET_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "prgl/FrameBufferObject.hxx"
+#include "prgl/Texture2d.hxx"
+
+namespace prgl {
+
+/**
+ * @brief Recycles temporary render targets (a Texture2d attached to a
+ * FrameBufferObject) across frames instead of creating and deleting them for
+ * every pass. Targets that were not requested for a number of frames are
+ * deleted. A target dropped by its user without release() is returned to the
+ * pool as well.
+ */
+class RenderTargetPool final {
+ public:
+  /**
+   * @brief Properties a pooled target has to match.
+   */
+  struct Descriptor {
+    uint32_t width;
+    uint32_t height;
+    TextureFormatInternal internalFormat;
+    // mip levels of the texture, 1: no mip maps, 0: the full chain
+    uint32_t levels;
+
+    bool operator==(const Descriptor& other) const;
+  };
+
+  struct Statistics {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    // targets waiting for reuse
+    uint32_t available;
+    // targets handed out and not released yet
+    uint32_t inUse;
+  };
+
+  template <typename... T>
+  static std::shared_ptr<RenderTargetPool> Create(T&&... args) {
+    return std::make_shared<RenderTargetPool>(std::forward<T>(args)...);
+  }
+
+  /**
+   * @param maxIdleFrames number of nextFrame calls a released target is kept
+   * without being acquired again.
+   */
+  explicit RenderTargetPool(uint32_t maxIdleFrames = 3U);
+  ~RenderTargetPool();
+
+  // get a framebuffer with a color texture matching the descriptor
+  std::shared_ptr<FrameBufferObject> acquire(const Descriptor& descriptor);
+  std::shared_ptr<FrameBufferObject> acquire(
+    uint32_t width, uint32_t height,
+    TextureFormatInternal internalFormat = TextureFormatInternal::Rgba16F,
+    uint32_t levels                      = 1U);
+  // hand a target back, its content is undefined when acquired again
+  void release(const std::shared_ptr<FrameBufferObject>& target);
+
+  // advance the frame counter, reclaim dropped targets and delete targets idle
+  // for too long
+  void nextFrame();
+  // delete all available targets, targets in use are not affected
+  void clear();
+
+  Statistics getStatistics() const;
+  void resetStatistics();
+
+ private:
+  RenderTargetPool(const RenderTargetPool&) = delete;
+  RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+  struct DescriptorHash {
+    std::size_t operator()(const Descriptor& descriptor) const;
+  };
+
+  struct Entry {
+    std::shared_ptr<FrameBufferObject> target;
+    // frame the target was released in
+    uint64_t releaseFrame;
+  };
+
+  struct Lease {
+    std::shared_ptr<FrameBufferObject> target;
+    // the pointer handed out, expires once the user drops it
+    std::weak_ptr<FrameBufferObject> handle;
+    Descriptor descriptor;
+  };
+
+  // resolve a level count of 0 or beyond the full chain
+  static Descriptor normalize(const Descriptor& descriptor);
+  std::shared_ptr<FrameBufferObject> createTarget(
+    const Descriptor& descriptor) const;
+  // make leases whose handle expired available again
+  void reclaim();
+
+  uint32_t mMaxIdleFrames;
+  uint64_t mFrame;
+  std::unordered_map<Descriptor, std::vector<Entry>, DescriptorHash>
+    mAvailable;
+  // targets handed out
+  std::vector<Lease> mInUse;
+  Statistics mStatistics;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_RENDER_TARGET_POOL_H
@@ -0,0 +1,106 @@
+/**
+ * @file ShaderHotReload.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_SHADER_HOT_RELOAD_H
+#define PRGL_SHADER_HOT_RELOAD_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "prgl/GlslRenderingPipelineProgram.hxx"
+#include "prgl/ShaderPreprocessor.hxx"
+
+namespace prgl {
+
+/**
+ * @brief Rebuilds programs when their GLSL files or any file they include
+ * change on disk, without stalling the render loop.
+ *
+ * Changes are detected with inotify. A background thread preprocesses,
+ * compiles and links the new program on a hidden context sharing objects with
+ * the render context. update() swaps finished programs in on the render
+ * thread; if the new sources do not compile the old program stays and the
+ * error is printed. Only available on Linux.
+ */
+class ShaderHotReload final {
+ public:
+  /**
+   * @brief A watched program, read and swapped on the render thread only.
+   */
+  struct Program {
+    std::shared_ptr<GlslRenderingPipelineProgram> program;
+    // incremented on every swap, uniform handles must be resolved again
+    uint32_t generation;
+  };
+
+  template <typename... T>
+  static std::shared_ptr<ShaderHotReload> Create(T&&... args) {
+    return std::make_shared<ShaderHotReload>(std::forward<T>(args)...);
+  }
+
+  // construct on the render thread while its context is current
+  explicit ShaderHotReload(std::shared_ptr<ShaderPreprocessor> preprocessor =
+                             ShaderPreprocessor::Create());
+  ~ShaderHotReload();
+
+  /**
+   * @brief Build a program from GLSL files right away and watch them.
+   *
+   * @param files file name by shader type, e.g. GL_VERTEX_SHADER.
+   */
+  std::shared_ptr<const Program> watch(
+    const std::map<uint32_t, std::string>& files);
+
+  // once per frame on the render thread, returns the number of swaps
+  uint32_t update();
+
+  const std::shared_ptr<ShaderPreprocessor>& getPreprocessor() const;
+
+ private:
+  ShaderHotReload(const ShaderHotReload&) = delete;
+  ShaderHotReload& operator=(const ShaderHotReload&) = delete;
+
+  struct Entry {
+    std::map<uint32_t, std::string> files;
+    // all files the program was built from, guarded by mMutex
+    std::vector<std::string> dependencies;
+    std::shared_ptr<Program> program;
+  };
+
+  std::shared_ptr<GlslRenderingPipelineProgram> build(
+    const std::map<uint32_t, std::string>& files,
+    std::vector<std::string>& dependencies) const;
+  void addWatches(const std::vector<std::string>& files);
+  std::vector<std::string> readChanges() const;
+  void run();
+
+  std::shared_ptr<ShaderPreprocessor> mPreprocessor;
+  GLFWwindow* mWorkerContext;
+  // inotify file descriptor
+  int mNotify;
+  // watched directory by watch descriptor, guarded by mMutex
+  std::unordered_map<int, std::string> mDirectories;
+  std::vector<std::shared_ptr<Entry>> mEntries;
+  // programs rebuilt by the worker, waiting for update()
+  std::vector<std::pair<std::shared_ptr<Program>,
+                        std::shared_ptr<GlslRenderingPipelineProgram>>>
+    mFinished;
+  mutable std::mutex mMutex;
+  std::atomic<bool> mRunning;
+  std::thread mWorker;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_SHADER_HOT_RELOAD_H
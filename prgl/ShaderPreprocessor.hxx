@@ -0,0 +1,70 @@
+/**
+ * @file ShaderPreprocessor.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_SHADER_PREPROCESSOR_H
+#define PRGL_SHADER_PREPROCESSOR_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace prgl {
+
+/**
+ * @brief Resolves #include "file" and #include <file> in GLSL files. Files are
+ * read once and cached until they are invalidated, e.g. by ShaderHotReload.
+ *
+ * Quoted names are searched next to the including file first, then in the
+ * include paths; names in angle brackets only in the include paths. Files
+ * containing #pragma once are only included once per shader. #line directives
+ * keep compiler messages pointing to the right file (the source string number
+ * is the index into Result::files) and line.
+ */
+class ShaderPreprocessor final {
+ public:
+  struct Result {
+    std::string source;
+    // the shader file followed by all included files, canonical paths
+    std::vector<std::string> files;
+  };
+
+  template <typename... T>
+  static std::shared_ptr<ShaderPreprocessor> Create(T&&... args) {
+    return std::make_shared<ShaderPreprocessor>(std::forward<T>(args)...);
+  }
+
+  explicit ShaderPreprocessor(std::vector<std::string> includePaths = {});
+  ~ShaderPreprocessor();
+
+  // thread safe
+  Result process(const std::string& filename);
+
+  // drop a file from the cache, it is read again on the next use
+  void invalidate(const std::string& filename);
+  void clear();
+
+ private:
+  ShaderPreprocessor(const ShaderPreprocessor&) = delete;
+  ShaderPreprocessor& operator=(const ShaderPreprocessor&) = delete;
+
+  const std::string& read(const std::string& path);
+  std::string resolve(const std::string& name, const std::string& includer,
+                      bool quoted) const;
+  void expand(const std::string& path, Result& result,
+              std::vector<std::string>& stack);
+
+  std::vector<std::string> mIncludePaths;
+  // file content by canonical path
+  std::unordered_map<std::string, std::string> mFiles;
+  std::mutex mMutex;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_SHADER_PREPROCESSOR_H
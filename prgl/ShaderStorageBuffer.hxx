@@ -1,56 +1,150 @@
-/**
- * @file ShaderStorageBuffer.hxx
- * @author Thomas Lindemeier
- * @brief
- * @date 2019-01-02
- *
- */
-#ifndef PRGL_SHADERSTORAGEBUFFER_H
-#define PRGL_SHADERSTORAGEBUFFER_H
-
-#include <stdint.h>
-
-#include <memory>
-
-namespace prgl {
-
-class Context;
-
-class ShaderStorageBuffer final {
- public:
-  static std::shared_ptr<ShaderStorageBuffer> Create();
-
-  ShaderStorageBuffer();
-  ~ShaderStorageBuffer();
-
-  // retun current buffer size in bytes
-  uint32_t getSizeInBytes() const;
-
-  // allocate buffer
-  void create(const void* dataStart, uint32_t nBytes);
-
-  // upload to previous allocated buffer
-  void upload(const void* dataStart, uint32_t nBytes);
-
-  // download to host ram
-  void download(void* dataStart, uint32_t nBytes) const;
-
-  void bind(bool bind) const;
-
-  // bind to location to address it in a shader
-  void bindBase(uint32_t location) const;
-
-  void copyTo(ShaderStorageBuffer& other) const;
-
-  uint32_t getHandle() const;
-
- private:
-  ShaderStorageBuffer(const ShaderStorageBuffer&) = delete;
-  ShaderStorageBuffer& operator=(const ShaderStorageBuffer&) = delete;
-
-  uint32_t mHandle;
-};
-
-}  // namespace prgl
-
-#endif  // PRGL_SHADERSTORAGEBUFFER_H
+/**
+ * @file ShaderStorageBuffer.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2019-01-02
+ *
+ */
+#ifndef PRGL_SHADERSTORAGEBUFFER_H
+#define PRGL_SHADERSTORAGEBUFFER_H
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <memory>
+
+#include "prgl/BufferHeap.hxx"
+#include "prgl/PersistentBufferRing.hxx"
+#include "prgl/ReadbackQueue.hxx"
+
+namespace prgl {
+
+class BarrierTracker;
+class Context;
+
+class ShaderStorageBuffer final {
+ public:
+  static std::shared_ptr<ShaderStorageBuffer> Create();
+  static std::shared_ptr<ShaderStorageBuffer> Create(
+    const std::shared_ptr<BufferHeap>& heap);
+
+  ShaderStorageBuffer();
+  /**
+   * @brief Keep the data in a range of a heap page instead of an own buffer
+   * object. Streaming and mapping are not available, after
+   * BufferHeap::defragment the buffer has to be bound again.
+   *
+   * @param heap heap with target GL_SHADER_STORAGE_BUFFER.
+   */
+  explicit ShaderStorageBuffer(const std::shared_ptr<BufferHeap>& heap);
+  ~ShaderStorageBuffer();
+
+  // retun current buffer size in bytes, kept on the host
+  uint64_t getSizeInBytes() const;
+
+  // allocate buffer, ends streaming
+  void create(const void* dataStart, uint64_t nBytes);
+
+  // upload to previous allocated buffer
+  void upload(const void* dataStart, uint64_t nBytes);
+  // update only [offset, offset + nBytes) of a regular buffer
+  void uploadRange(const void* dataStart, uint64_t offset, uint64_t nBytes);
+
+  /**
+   * @brief Keep the data in a persistently mapped ring of frameCount slots of
+   * nBytes each instead. Every streaming upload writes the next free slot
+   * without mapping or stalling, bindBase binds the slot written last. The
+   * previous content is lost.
+   */
+  void enableStreaming(uint64_t nBytes, uint32_t frameCount = 3U);
+  bool isStreaming() const;
+  // pointer to getSizeInBytes() bytes of mapped memory for the next frame
+  void* beginStreamingUpload();
+  void endStreamingUpload();
+  // beginStreamingUpload + memcpy + endStreamingUpload
+  void uploadStreaming(const void* dataStart);
+
+  // download to host ram, waits for the GPU
+  void download(void* dataStart, uint64_t nBytes) const;
+  void downloadRange(void* dataStart, uint64_t offset, uint64_t nBytes) const;
+
+  /**
+   * @brief Map [offset, offset + nBytes) of a regular buffer, unmap() before
+   * the GPU uses it again.
+   *
+   * @param access GL_MAP_*_BIT flags, e.g. GL_MAP_INVALIDATE_RANGE_BIT to
+   * discard the old content of the range or GL_MAP_UNSYNCHRONIZED_BIT to skip
+   * waiting for the GPU when the caller knows the range is not in use.
+   */
+  void* mapRange(uint64_t offset, uint64_t nBytes,
+                 GLbitfield access = GL_MAP_WRITE_BIT |
+                                     GL_MAP_INVALIDATE_RANGE_BIT);
+  // make writes visible, for ranges mapped with GL_MAP_FLUSH_EXPLICIT_BIT,
+  // offset is relative to the mapped range
+  void flushMappedRange(uint64_t offset, uint64_t nBytes) const;
+  void unmap();
+  bool isMapped() const;
+
+  // non blocking downloads of up to maxBytes (0: the current size) through a
+  // staging ring, ringDepth downloads can be in flight before one has to wait
+  void enableAsyncDownload(uint64_t maxBytes = 0U, uint32_t ringDepth = 3U);
+  /**
+   * @brief Record a copy of nBytes at offset into the staging ring. The future
+   * becomes ready (and the callback is called) from within pollDownloads once
+   * the GPU has finished the copy, usually a few frames later.
+   */
+  std::future<std::vector<uint8_t>> downloadAsync(
+    uint64_t offset, uint64_t nBytes,
+    ReadbackQueue::Callback callback = nullptr);
+  // the whole buffer
+  std::future<std::vector<uint8_t>> downloadAsync(
+    ReadbackQueue::Callback callback = nullptr);
+  // deliver finished downloads, call once per frame
+  uint32_t pollDownloads();
+
+  void bind(bool bind) const;
+
+  // bind to location to address it in a shader
+  void bindBase(uint32_t location) const;
+
+  void copyTo(ShaderStorageBuffer& other) const;
+
+  // buffer holding the data, the ring while streaming or a heap page
+  uint32_t getHandle() const;
+  // byte offset of the data in getHandle(), the current slot while streaming
+  std::size_t getOffset() const;
+  bool isHeapAllocated() const;
+
+  // see Texture2d::setBarrierTracker
+  void setBarrierTracker(const std::shared_ptr<BarrierTracker>& tracker);
+  const std::shared_ptr<BarrierTracker>& getBarrierTracker() const;
+
+ private:
+  ShaderStorageBuffer(const ShaderStorageBuffer&) = delete;
+  ShaderStorageBuffer& operator=(const ShaderStorageBuffer&) = delete;
+
+  void checkRange(const char* function, uint64_t offset,
+                  uint64_t nBytes) const;
+
+  uint32_t mHandle;
+  uint64_t mSize;
+  bool mMapped;
+
+  std::unique_ptr<PersistentBufferRing> mRing;
+  // slot bound by bindBase, fenced when the next upload starts
+  uint32_t mSlot;
+  bool mWritten;
+  int32_t mUploadSlot;
+
+  std::unique_ptr<ReadbackQueue> mDownloadQueue;
+
+  std::shared_ptr<BufferHeap> mHeap;
+  // size 0 while nothing is allocated from the heap
+  BufferHeap::Allocation mAllocation;
+
+  std::shared_ptr<BarrierTracker> mBarrierTracker;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_SHADERSTORAGEBUFFER_H
@@ -0,0 +1,87 @@
+/**
+ * @file ShaderVariantCache.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_SHADER_VARIANT_CACHE_H
+#define PRGL_SHADER_VARIANT_CACHE_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "prgl/GlslComputeShader.hxx"
+#include "prgl/GlslRenderingPipelineProgram.hxx"
+
+namespace prgl {
+
+/**
+ * @brief Programs specialized with compile time defines, built on first use
+ * and kept by their sources and defines.
+ *
+ * A kernel with e.g. RADIUS and CHANNELS defines is compiled once per
+ * combination used instead of branching on uniforms. Variants live as long as
+ * the cache, linked binaries can additionally be kept on disk by a
+ * ProgramBinaryCache.
+ */
+class ShaderVariantCache final {
+ public:
+  static std::shared_ptr<ShaderVariantCache> Create();
+
+  ShaderVariantCache();
+  ~ShaderVariantCache();
+
+  std::shared_ptr<GlslComputeShader> getComputeShader(
+    const std::string& source,
+    const GlslProgram::Defines& defines = GlslProgram::Defines());
+
+  /**
+   * @param sources source by shader type, e.g. GL_VERTEX_SHADER.
+   * @param wait see GlslRenderingPipelineProgram::build, only used when the
+   * variant is built.
+   */
+  std::shared_ptr<GlslRenderingPipelineProgram> getPipelineProgram(
+    const std::map<uint32_t, std::string>& sources,
+    const GlslProgram::Defines& defines = GlslProgram::Defines(),
+    bool wait                           = true);
+
+  // hash of the sources and the defines, independent of the GL context,
+  // variants with equal keys are told apart by comparing both
+  static uint64_t makeKey(const std::map<uint32_t, std::string>& sources,
+                          const GlslProgram::Defines& defines);
+
+  // number of variants built
+  std::size_t getSize() const;
+  uint32_t getHits() const;
+  uint32_t getMisses() const;
+  void clear();
+
+ private:
+  ShaderVariantCache(const ShaderVariantCache&) = delete;
+  ShaderVariantCache& operator=(const ShaderVariantCache&) = delete;
+
+  struct ComputeVariant {
+    std::string source;
+    GlslProgram::Defines defines;
+    std::shared_ptr<GlslComputeShader> program;
+  };
+
+  struct PipelineVariant {
+    std::map<uint32_t, std::string> sources;
+    GlslProgram::Defines defines;
+    std::shared_ptr<GlslRenderingPipelineProgram> program;
+  };
+
+  // by makeKey
+  std::unordered_multimap<uint64_t, ComputeVariant> mComputeShaders;
+  std::unordered_multimap<uint64_t, PipelineVariant> mPipelinePrograms;
+  uint32_t mHits;
+  uint32_t mMisses;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_SHADER_VARIANT_CACHE_H
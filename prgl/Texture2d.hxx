@@ -13,6 +13,8 @@
 #include <vector>
 
 #include "glCommon.hxx"
+#include "prgl/PersistentBufferRing.hxx"
+#include "prgl/ReadbackQueue.hxx"
 
 namespace prgl {
 
@@ -141,7 +143,15 @@ enum class TextureFormatInternal : uint32_t {
   Rgba16I        = GL_RGBA16I,
   Rgba16Ui       = GL_RGBA16UI,
   Rgba32I        = GL_RGBA32I,
-  Rgba32Ui       = GL_RGBA32UI
+  Rgba32Ui       = GL_RGBA32UI,
+  // block compressed formats, 4x4 texels per block
+  Bc1Rgb         = GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+  Bc1Rgba        = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
+  Bc3Rgba        = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+  Bc4R           = GL_COMPRESSED_RED_RGTC1,
+  Bc5Rg          = GL_COMPRESSED_RG_RGTC2,
+  Bc7Rgba        = GL_COMPRESSED_RGBA_BPTC_UNORM,
+  Bc7SrgbAlpha   = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM
 };
 
 /**
@@ -170,6 +180,103 @@ enum class TextureFormat : uint32_t {
   DepthStencil   = GL_DEPTH_STENCIL
 };
 
+/**
+ * @brief Number of components per pixel of the given pixel data format.
+ */
+constexpr uint32_t getChannelCount(const TextureFormat format) {
+  switch (format) {
+    case TextureFormat::Red:
+    case TextureFormat::RedInteger:
+    case TextureFormat::StencilIndex:
+    case TextureFormat::DepthComponent:
+      return 1U;
+    case TextureFormat::Rg:
+    case TextureFormat::RgInteger:
+    case TextureFormat::DepthStencil:
+      return 2U;
+    case TextureFormat::Rgb:
+    case TextureFormat::Bgr:
+    case TextureFormat::RgbInteger:
+    case TextureFormat::BgrInteger:
+      return 3U;
+    case TextureFormat::Rgba:
+    case TextureFormat::Bgra:
+    case TextureFormat::RgbaInteger:
+    case TextureFormat::BgraInteger:
+      return 4U;
+  }
+  return 0U;
+}
+
+/**
+ * @brief Sized internal formats can be used for immutable texture storage.
+ */
+constexpr bool isSizedFormat(const TextureFormatInternal format) {
+  switch (format) {
+    case TextureFormatInternal::DepthComponent:
+    case TextureFormatInternal::DepthStencil:
+    case TextureFormatInternal::Red:
+    case TextureFormatInternal::Rg:
+    case TextureFormatInternal::Rgb:
+    case TextureFormatInternal::Rgba:
+      return false;
+    default:
+      return true;
+  }
+}
+
+/**
+ * @brief Size in bytes of a 4x4 block of a block compressed format, 0 for
+ * uncompressed formats.
+ */
+constexpr uint32_t getCompressedBlockSize(const TextureFormatInternal format) {
+  switch (format) {
+    case TextureFormatInternal::Bc1Rgb:
+    case TextureFormatInternal::Bc1Rgba:
+    case TextureFormatInternal::Bc4R:
+      return 8U;
+    case TextureFormatInternal::Bc3Rgba:
+    case TextureFormatInternal::Bc5Rg:
+    case TextureFormatInternal::Bc7Rgba:
+    case TextureFormatInternal::Bc7SrgbAlpha:
+      return 16U;
+    default:
+      return 0U;
+  }
+}
+
+constexpr bool isCompressedFormat(const TextureFormatInternal format) {
+  return getCompressedBlockSize(format) != 0U;
+}
+
+/**
+ * @brief Size in bytes of a width x height image of a block compressed format.
+ */
+constexpr std::size_t getCompressedImageSize(
+  const TextureFormatInternal format, const uint32_t width,
+  const uint32_t height) {
+  return static_cast<std::size_t>((width + 3U) / 4U) *
+         static_cast<std::size_t>((height + 3U) / 4U) *
+         getCompressedBlockSize(format);
+}
+
+/**
+ * @brief Number of levels of a full mip chain down to 1x1.
+ */
+constexpr uint32_t getMipLevelCount(const uint32_t width,
+                                    const uint32_t height) {
+  auto size   = (width > height) ? width : height;
+  auto levels = 1U;
+  while (size > 1U) {
+    size >>= 1U;
+    levels++;
+  }
+  return levels;
+}
+
+class BarrierTracker;
+class QuadRenderer;
+
 /**
  * @brief Represents a 2d texture.
  *
@@ -202,16 +309,56 @@ class Texture2d final {
                         TextureAccess access = TextureAccess::ReadWrite,
                         int32_t level = 0, bool layered = GL_TRUE,
                         int32_t layer = 0);
+  // upload level 0, createMipMaps only allocates the chain, see
+  // generateMipMaps
   void upload(void* data);
+  // allocate levelCount mip levels (0: the full chain) without data
+  void allocate(uint32_t levelCount);
+  // update a region of a mip level, rowStride in pixels (0: tightly packed)
+  void uploadRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+                    uint32_t level, const void* data, uint32_t rowStride = 0U);
+  // update a region of a mip level of a block compressed texture, x, y, width
+  // and height are multiples of 4 unless the region touches the level border
+  void uploadCompressedRegion(uint32_t x, uint32_t y, uint32_t width,
+                              uint32_t height, uint32_t level,
+                              const void* data, std::size_t size);
+  // upload a whole mip level of a block compressed texture
+  void uploadCompressed(uint32_t level, const void* data, std::size_t size);
+  void generateMipMaps();
+
+  // streaming uploads through a ring of persistently mapped pixel unpack
+  // buffers, ringSize frames can be in flight before the host has to wait
+  void enableStreaming(uint32_t ringSize = 3U);
+  bool isStreaming() const;
+  // pointer to write the next frame to (tightly packed, getFormat/getType)
+  void* beginStreamingUpload();
+  // start the transfer of the frame written since beginStreamingUpload
+  void endStreamingUpload();
+  // beginStreamingUpload + memcpy + endStreamingUpload
+  void uploadStreaming(const void* data);
+  std::size_t getSizeInBytes() const;
 
   void download(void* dataPtr, TextureFormat format, DataType type);
 
+  // non blocking downloads through a ring of pixel pack buffers, ringDepth
+  // downloads can be in flight before downloadAsync has to wait
+  void enableAsyncDownload(TextureFormat format, DataType type,
+                           uint32_t ringDepth = 3U);
+  std::future<std::vector<uint8_t>> downloadAsync(
+    ReadbackQueue::Callback callback = nullptr);
+  // deliver finished downloads, call once per frame
+  uint32_t pollDownloads();
+
   void setWrapMode(TextureWrapMode wrap);
   void setEnvMode(TextureEnvMode envMode);
   void setFilter(TextureMinFilter minFilter, TextureMagFilter magFilter);
   void setMaxIsotropy(float anisotropy);
+  // draws with the QuadRenderer of the current ContextImplementation, or with
+  // one kept per GLFW window for contexts created elsewhere
   void render(float posX, float posY, float width, float height,
               bool convert_sRGB = false) const;
+  void render(QuadRenderer& renderer, float posX, float posY, float width,
+              float height, bool convert_sRGB = false) const;
 
   uint32_t getId() const;
   uint32_t getWidth() const;
@@ -224,12 +371,21 @@ class Texture2d final {
   TextureMagFilter getMagFilter() const;
   TextureWrapMode getWrap() const;
   TextureEnvMode getEnvMode() const;
+  uint32_t getMipLevelCount() const;
   void copyTo(Texture2d& other) const;
 
+  // downloads, copies and draws flush the barriers they need through it, set
+  // by the programs and pass graphs writing the texture
+  void setBarrierTracker(const std::shared_ptr<BarrierTracker>& tracker);
+  const std::shared_ptr<BarrierTracker>& getBarrierTracker() const;
+
  private:
   Texture2d(const Texture2d&) = delete;
   Texture2d& operator=(const Texture2d&) = delete;
 
+  void allocateStorage();
+  void applyParameters() const;
+
   uint32_t mHandle;
   uint32_t mWidth;
   uint32_t mHeight;
@@ -243,8 +399,19 @@ class Texture2d final {
   TextureMagFilter mMagFilter;
   TextureWrapMode mWrap;
   TextureEnvMode mEnvMode;
-  bool mCreateMipMaps;
   float mMaxAnisotropy;
+  bool mStorageAllocated;
+  bool mImmutable;
+  uint32_t mLevelCount;
+
+  std::unique_ptr<PersistentBufferRing> mUploadRing;
+  int32_t mUploadSlot;
+
+  std::unique_ptr<ReadbackQueue> mDownloadQueue;
+  TextureFormat mDownloadFormat;
+  DataType mDownloadType;
+
+  std::shared_ptr<BarrierTracker> mBarrierTracker;
 };
 
 }  // namespace prgl
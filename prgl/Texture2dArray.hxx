@@ -0,0 +1,105 @@
+/**
+ * @file Texture2dArray.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_TEXTURE_2D_ARRAY_H
+#define PRGL_TEXTURE_2D_ARRAY_H
+
+#include <memory>
+
+#include "prgl/Texture2d.hxx"
+
+namespace prgl {
+
+class BarrierTracker;
+
+/**
+ * @brief Represents an array of 2d textures of equal size and format
+ * (GL_TEXTURE_2D_ARRAY) with immutable storage. All layers are bound at once.
+ */
+class Texture2dArray final {
+ public:
+  template <typename... T>
+  static std::shared_ptr<Texture2dArray> Create(T&&... args) {
+    return std::make_shared<Texture2dArray>(std::forward<T>(args)...);
+  }
+
+  Texture2dArray(
+    uint32_t width, uint32_t height, uint32_t layers,
+    TextureFormatInternal internalFormat = TextureFormatInternal::Rgba8,
+    TextureFormat format                 = TextureFormat::Rgba,
+    DataType type                        = DataType::UnsignedByte,
+    TextureMinFilter minFilter           = TextureMinFilter::Linear,
+    TextureMagFilter magFilter           = TextureMagFilter::Linear,
+    TextureWrapMode wrapMode             = TextureWrapMode::ClampToEdge,
+    bool createMipMaps                   = false);
+
+  ~Texture2dArray();
+
+  void bind(bool bind) const;
+  // glActiveTexture + glBindTexture
+  void bindUnit(uint32_t unit) const;
+  // bind all layers (layered) or a single layer as image
+  void bindImageTexture(uint32_t unit,
+                        TextureAccess access = TextureAccess::ReadWrite,
+                        int32_t level = 0, bool layered = GL_TRUE,
+                        int32_t layer = 0);
+  // upload level 0 of a layer, see generateMipMaps
+  void upload(uint32_t layer, const void* data);
+  // update a region of a layer, rowStride in pixels (0: tightly packed)
+  void uploadRegion(uint32_t x, uint32_t y, uint32_t layer, uint32_t width,
+                    uint32_t height, uint32_t level, const void* data,
+                    uint32_t rowStride = 0U);
+  // recompute the mip levels of all layers, once after a batch of uploads
+  void generateMipMaps();
+
+  void download(uint32_t layer, void* dataPtr, TextureFormat format,
+                DataType type) const;
+
+  void setWrapMode(TextureWrapMode wrap);
+  void setFilter(TextureMinFilter minFilter, TextureMagFilter magFilter);
+  void setMaxIsotropy(float anisotropy);
+
+  uint32_t getId() const;
+  uint32_t getWidth() const;
+  uint32_t getHeight() const;
+  uint32_t getLayers() const;
+  TextureFormatInternal getInternalFormat() const;
+  TextureFormat getFormat() const;
+  DataType getType() const;
+  TextureMinFilter getMinFilter() const;
+  TextureMagFilter getMagFilter() const;
+  TextureWrapMode getWrap() const;
+  uint32_t getMipLevelCount() const;
+
+  // see Texture2d::setBarrierTracker
+  void setBarrierTracker(const std::shared_ptr<BarrierTracker>& tracker);
+  const std::shared_ptr<BarrierTracker>& getBarrierTracker() const;
+
+ private:
+  Texture2dArray(const Texture2dArray&) = delete;
+  Texture2dArray& operator=(const Texture2dArray&) = delete;
+
+  uint32_t mHandle;
+  uint32_t mWidth;
+  uint32_t mHeight;
+  uint32_t mLayers;
+  uint32_t mTarget;
+  TextureFormatInternal mInternalFormat;
+  TextureFormat mFormat;
+  DataType mType;
+  TextureMinFilter mMinFilter;
+  TextureMagFilter mMagFilter;
+  TextureWrapMode mWrap;
+  uint32_t mLevelCount;
+  float mMaxAnisotropy;
+
+  std::shared_ptr<BarrierTracker> mBarrierTracker;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_TEXTURE_2D_ARRAY_H
@@ -0,0 +1,81 @@
+/**
+ * @file TextureAtlas.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_TEXTURE_ATLAS_H
+#define PRGL_TEXTURE_ATLAS_H
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "prgl/RectanglePacker.hxx"
+#include "prgl/Texture2dArray.hxx"
+
+namespace prgl {
+
+/**
+ * @brief Packs many small images into the layers of a single Texture2dArray so
+ * they can be bound once and drawn in a single pass.
+ */
+class TextureAtlas final {
+ public:
+  /**
+   * @brief Location of an image inside the atlas.
+   */
+  struct Region {
+    uint32_t layer;
+    // u0, v0, u1, v1
+    vec4f texCoords;
+    // pixel rectangle inside the layer
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+  };
+
+  template <typename... T>
+  static std::shared_ptr<TextureAtlas> Create(T&&... args) {
+    return std::make_shared<TextureAtlas>(std::forward<T>(args)...);
+  }
+
+  /**
+   * @param padding pixels kept around each image and filled with its border
+   * pixels, to avoid bleeding when filtering.
+   */
+  TextureAtlas(
+    uint32_t width, uint32_t height, uint32_t layers,
+    TextureFormatInternal internalFormat = TextureFormatInternal::Rgba8,
+    TextureFormat format                 = TextureFormat::Rgba,
+    DataType type                        = DataType::UnsignedByte,
+    uint32_t padding                     = 1U);
+
+  // pack and upload an image, rowStride in pixels (0: tightly packed)
+  Region add(uint32_t width, uint32_t height, const void* data,
+             uint32_t rowStride = 0U);
+
+  // forget all images, the texture content is kept until overwritten
+  void clear();
+
+  const std::shared_ptr<Texture2dArray>& getTexture() const;
+  float getOccupancy(uint32_t layer) const;
+
+ private:
+  TextureAtlas(const TextureAtlas&) = delete;
+  TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+  std::vector<uint8_t> extrude(uint32_t width, uint32_t height,
+                               const void* data, uint32_t rowStride) const;
+
+  std::shared_ptr<Texture2dArray> mTexture;
+  std::vector<RectanglePacker> mPackers;
+  uint32_t mPadding;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_TEXTURE_ATLAS_H
@@ -0,0 +1,83 @@
+/**
+ * @file TextureReduction.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_TEXTURE_REDUCTION_H
+#define PRGL_TEXTURE_REDUCTION_H
+
+#include <memory>
+#include <vector>
+
+#include "prgl/GlslComputeShader.hxx"
+#include "prgl/ShaderStorageBuffer.hxx"
+#include "prgl/Texture2d.hxx"
+#include "prgl/Types.hxx"
+
+namespace prgl {
+
+/**
+ * @brief Channel a histogram is computed of.
+ */
+enum class ReductionChannel : int32_t {
+  Red       = 0,
+  Green     = 1,
+  Blue      = 2,
+  Alpha     = 3,
+  // Rec. 709 luminance of the linear rgb values
+  Luminance = 4
+};
+
+/**
+ * @brief Statistics of a Texture2d computed on the GPU with shared memory tree
+ * reductions. Only the final result is read back, e.g. for auto exposure.
+ */
+class TextureReduction final {
+ public:
+  struct Result {
+    vec4f minimum;
+    vec4f maximum;
+    vec4f sum;
+    vec4f mean;
+  };
+
+  // largest supported number of histogram bins
+  static constexpr uint32_t MaxBinCount = 256U;
+
+  static std::shared_ptr<TextureReduction> Create();
+
+  TextureReduction();
+  ~TextureReduction();
+
+  // per channel minimum, maximum, sum and mean of a mip level
+  Result reduce(const std::shared_ptr<Texture2d>& texture, uint32_t level = 0U);
+
+  /**
+   * @brief Histogram of a channel of a mip level. Values outside of
+   * [minValue, maxValue] are counted in the first and last bin.
+   */
+  std::vector<uint32_t> histogram(
+    const std::shared_ptr<Texture2d>& texture, uint32_t binCount,
+    float minValue, float maxValue,
+    ReductionChannel channel = ReductionChannel::Luminance,
+    uint32_t level           = 0U);
+
+ private:
+  TextureReduction(const TextureReduction&) = delete;
+  TextureReduction& operator=(const TextureReduction&) = delete;
+
+  std::shared_ptr<GlslComputeShader> mReduceShader;
+  std::shared_ptr<GlslComputeShader> mFinalShader;
+  std::shared_ptr<GlslComputeShader> mHistogramShader;
+  // minimum, maximum and sum of every work group of the first pass
+  std::shared_ptr<ShaderStorageBuffer> mPartials;
+  std::shared_ptr<ShaderStorageBuffer> mResult;
+  std::shared_ptr<ShaderStorageBuffer> mBins;
+  uint32_t mPartialCapacity;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_TEXTURE_REDUCTION_H
@@ -0,0 +1,148 @@
+/**
+ * @file TiledTexture.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_TILED_TEXTURE_H
+#define PRGL_TILED_TEXTURE_H
+
+#include <array>
+#include <functional>
+#include <list>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "prgl/PersistentBufferRing.hxx"
+#include "prgl/QuadRenderer.hxx"
+#include "prgl/Texture2dArray.hxx"
+
+namespace prgl {
+
+/**
+ * @brief Virtual texture for images larger than GL_MAX_TEXTURE_SIZE or the
+ * available video memory. The image and its mip levels are split into square
+ * tiles, only tiles visible in the current viewport are streamed into the
+ * layers of a Texture2dArray that acts as a least recently used cache.
+ *
+ * Tile (level, x, y) covers the texels [x, x + 1) * tileSize by
+ * [y, y + 1) * tileSize of mip level `level`, rows go bottom up like in GL.
+ */
+class TiledTexture final {
+ public:
+  /**
+   * @brief Writes tileSize x tileSize texels of a tile, tightly packed in the
+   * format and type of the texture, to destination (a mapped upload buffer).
+   * Texels beyond the image border of edge tiles are not displayed.
+   */
+  using TileLoader = std::function<void(uint32_t level, uint32_t tileX,
+                                        uint32_t tileY, void* destination)>;
+
+  /**
+   * @brief Part of the image shown and where it is drawn to.
+   */
+  struct Viewport {
+    // visible rectangle in level 0 texels, x and y are the bottom left corner
+    float imageX;
+    float imageY;
+    float imageWidth;
+    float imageHeight;
+    // target rectangle in pixels, see QuadRenderer::add
+    float screenX;
+    float screenY;
+    float screenWidth;
+    float screenHeight;
+  };
+
+  template <typename... T>
+  static std::shared_ptr<TiledTexture> Create(T&&... args) {
+    return std::make_shared<TiledTexture>(std::forward<T>(args)...);
+  }
+
+  /**
+   * @param width width of the full image.
+   * @param height height of the full image.
+   * @param tileSize edge length of a tile in texels.
+   * @param cacheSize number of tiles kept resident.
+   * @param loader provides the texels of a tile.
+   */
+  TiledTexture(
+    uint32_t width, uint32_t height, uint32_t tileSize, uint32_t cacheSize,
+    TileLoader loader,
+    TextureFormatInternal internalFormat = TextureFormatInternal::Rgba8,
+    TextureFormat format                 = TextureFormat::Rgba,
+    DataType type                        = DataType::UnsignedByte);
+  ~TiledTexture();
+
+  /**
+   * @brief Make the tiles needed for the viewport resident, least recently
+   * used tiles are evicted. The coarsest level is always requested so there
+   * is something to show while finer tiles stream in.
+   *
+   * @param maxUploads upper bound of tiles loaded per call to limit hitches.
+   * @return number of tiles loaded.
+   */
+  uint32_t update(const Viewport& viewport, uint32_t maxUploads = 8U);
+
+  // queue the visible tiles, missing tiles are replaced by coarser ones
+  void render(QuadRenderer& renderer, const Viewport& viewport) const;
+
+  // mip level matching the texel to pixel ratio of the viewport
+  uint32_t selectLevel(const Viewport& viewport) const;
+  // layer of the texture array holding the tile, empty if not resident
+  std::optional<uint32_t> getResidentLayer(uint32_t level, uint32_t tileX,
+                                           uint32_t tileY) const;
+
+  const std::shared_ptr<Texture2dArray>& getTexture() const;
+  uint32_t getWidth() const;
+  uint32_t getHeight() const;
+  uint32_t getTileSize() const;
+  uint32_t getLevelCount() const;
+  uint32_t getTileCountX(uint32_t level) const;
+  uint32_t getTileCountY(uint32_t level) const;
+  uint32_t getResidentCount() const;
+  // tiles the last update() could not load because every layer held a tile
+  // of that frame, non zero if the cache is too small for the viewport
+  uint32_t getEvictionFailures() const;
+
+ private:
+  TiledTexture(const TiledTexture&) = delete;
+  TiledTexture& operator=(const TiledTexture&) = delete;
+
+  struct Tile {
+    uint32_t layer;
+    // frame the tile was last requested in
+    uint64_t lastUsed;
+    // position in mLru, most recently used first
+    std::list<uint64_t>::iterator lru;
+  };
+
+  static uint64_t makeKey(uint32_t level, uint32_t tileX, uint32_t tileY);
+  // visible tile range [first, last] of a level
+  std::array<uint32_t, 4U> getVisibleTiles(const Viewport& viewport,
+                                           uint32_t level) const;
+  bool request(uint32_t level, uint32_t tileX, uint32_t tileY,
+               bool mayUpload);
+  void addQuad(QuadRenderer& renderer, const Viewport& viewport,
+               uint32_t level, uint32_t tileX, uint32_t tileY) const;
+
+  uint32_t mWidth;
+  uint32_t mHeight;
+  uint32_t mTileSize;
+  uint32_t mLevelCount;
+  TileLoader mLoader;
+  std::shared_ptr<Texture2dArray> mTexture;
+  PersistentBufferRing mUploadRing;
+  std::unordered_map<uint64_t, Tile> mTiles;
+  std::list<uint64_t> mLru;
+  std::vector<uint32_t> mFreeLayers;
+  uint64_t mFrame;
+  uint32_t mEvictionFailures;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_TILED_TEXTURE_H
@@ -0,0 +1,118 @@
+/**
+ * @file TlsfAllocator.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_TLSF_ALLOCATOR_H
+#define PRGL_TLSF_ALLOCATOR_H
+
+#include <stdint.h>
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace prgl {
+
+/**
+ * @brief Two level segregated fit allocator handing out byte ranges of a fixed
+ * capacity. It only does the bookkeeping, the memory itself (e.g. a GL buffer)
+ * is owned by the caller. Allocation and free take constant time, neighbouring
+ * free ranges are merged immediately.
+ */
+class TlsfAllocator final {
+ public:
+  struct Allocation {
+    uint64_t offset;
+    uint64_t size;
+    // identifies the allocation, stays valid across defragment()
+    uint32_t block;
+  };
+
+  /**
+   * @brief A range moved by defragment(), to lower offsets only. Moves have to
+   * be applied in order, a move may overlap its own source range.
+   */
+  struct Move {
+    uint64_t from;
+    uint64_t to;
+    uint64_t size;
+  };
+
+  struct Statistics {
+    uint64_t capacity;
+    uint64_t used;
+    uint64_t largestFree;
+    uint32_t allocations;
+    uint32_t freeBlocks;
+    // 1 - largestFree / free bytes, 0 if all free space is one range
+    float fragmentation;
+  };
+
+  explicit TlsfAllocator(uint64_t capacity);
+
+  /**
+   * @brief Find a free range, empty if none is large enough.
+   *
+   * @param alignment power of two the offset is a multiple of.
+   */
+  std::optional<Allocation> allocate(uint64_t size, uint64_t alignment = 1U);
+  void free(uint32_t block);
+  // current range of an allocation
+  Allocation get(uint32_t block) const;
+
+  // pack all allocations to the start keeping their order and alignment
+  std::vector<Move> defragment();
+  void clear();
+
+  uint64_t getCapacity() const;
+  Statistics getStatistics() const;
+
+ private:
+  // the second level splits each power of two range into 2^SlLog2 lists
+  static constexpr uint32_t SlLog2  = 4U;
+  static constexpr uint32_t SlCount = 1U << SlLog2;
+  static constexpr uint32_t FlCount = 64U - SlLog2 + 1U;
+
+  struct Block {
+    uint64_t offset;
+    uint64_t size;
+    uint64_t alignment;
+    uint32_t prevPhysical;
+    uint32_t nextPhysical;
+    uint32_t prevFree;
+    uint32_t nextFree;
+    bool free;
+  };
+
+  // first and second level index of the free list holding blocks of size
+  static void mapping(uint64_t size, uint32_t& fl, uint32_t& sl);
+
+  uint32_t createBlock(uint64_t offset, uint64_t size);
+  void releaseBlock(uint32_t block);
+  void insertFree(uint32_t block);
+  void removeFree(uint32_t block);
+  uint32_t findFree(uint64_t size) const;
+  uint32_t findFit(uint64_t size, uint64_t alignment) const;
+  // split the range behind size off the block as a new free block
+  void splitTail(uint32_t block, uint64_t size);
+  void checkAllocated(const char* function, uint32_t block) const;
+
+  uint64_t mCapacity;
+  uint64_t mUsed;
+  uint32_t mAllocations;
+  uint32_t mFirst;
+  std::vector<Block> mBlocks;
+  // indices into mBlocks not in use
+  std::vector<uint32_t> mUnused;
+  uint64_t mFlBitmap;
+  std::array<uint32_t, FlCount> mSlBitmaps;
+  std::array<std::array<uint32_t, SlCount>, FlCount> mFreeLists;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_TLSF_ALLOCATOR_H
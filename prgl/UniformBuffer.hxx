@@ -0,0 +1,181 @@
+/**
+ * @file UniformBuffer.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_UNIFORM_BUFFER_H
+#define PRGL_UNIFORM_BUFFER_H
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "prgl/PersistentBufferRing.hxx"
+#include "prgl/Types.hxx"
+#include "prgl/glCommon.hxx"
+
+namespace prgl {
+
+/**
+ * @brief Base alignment and size of a type in a std140 uniform block.
+ *
+ * Supported are 32 bit scalars, 2, 3 and 4 component vectors, mat4x4<float>,
+ * structs padded to 16 bytes and arrays of 16 byte sized elements. Types whose
+ * C++ layout differs from std140 (bool, double, mat3x3, arrays of scalars)
+ * are rejected.
+ *
+ * mat4x4 is row major while std140 matrices are column major by default, the
+ * block has to be declared as layout(std140, row_major) so that the shader
+ * does not read the transpose.
+ */
+template <typename T>
+struct Std140Traits {
+  // nested structs are aligned to 16 bytes and padded to a multiple of it
+  static constexpr bool Supported = std::is_class<T>::value &&
+                                    std::is_trivially_copyable<T>::value &&
+                                    ((sizeof(T) % 16U) == 0U);
+  static constexpr std::size_t Alignment = 16U;
+};
+
+// the array stride is rounded up to 16 bytes
+template <typename T, std::size_t N>
+struct Std140Traits<std::array<T, N>> {
+  static constexpr bool Supported =
+    Std140Traits<T>::Supported && ((sizeof(T) % 16U) == 0U);
+  static constexpr std::size_t Alignment = 16U;
+};
+
+template <std::size_t A>
+struct Std140Type {
+  static constexpr bool Supported = true;
+  static constexpr std::size_t Alignment = A;
+};
+
+template <>
+struct Std140Traits<float> : Std140Type<4U> {};
+template <>
+struct Std140Traits<int32_t> : Std140Type<4U> {};
+template <>
+struct Std140Traits<uint32_t> : Std140Type<4U> {};
+template <>
+struct Std140Traits<vec2f> : Std140Type<8U> {};
+template <>
+struct Std140Traits<vec2i> : Std140Type<8U> {};
+template <>
+struct Std140Traits<vec2ui> : Std140Type<8U> {};
+template <>
+struct Std140Traits<vec3f> : Std140Type<16U> {};
+template <>
+struct Std140Traits<vec3i> : Std140Type<16U> {};
+template <>
+struct Std140Traits<vec3ui> : Std140Type<16U> {};
+template <>
+struct Std140Traits<vec4f> : Std140Type<16U> {};
+template <>
+struct Std140Traits<vec4i> : Std140Type<16U> {};
+template <>
+struct Std140Traits<vec4ui> : Std140Type<16U> {};
+template <>
+struct Std140Traits<mat4x4<float>> : Std140Type<16U> {};
+
+/**
+ * @brief Compile time check that a member of a uniform block struct has a
+ * std140 type and sits at offset, the byte offset std140 gives it in the GLSL
+ * block. Use it for every member, e.g.
+ * PRGL_STD140_MEMBER(Camera, position, 64U);
+ */
+#define PRGL_STD140_MEMBER(Struct, member, offset)                           \
+  static_assert(prgl::Std140Traits<decltype(Struct::member)>::Supported,     \
+                #Struct "::" #member " has no matching std140 type");        \
+  static_assert(((offset) %                                                  \
+                 prgl::Std140Traits<decltype(Struct::member)>::Alignment)    \
+                  == 0U,                                                     \
+                #Struct "::" #member " offset is not aligned as in std140"); \
+  static_assert(offsetof(Struct, member) == (offset),                        \
+                #Struct "::" #member " is not at its std140 offset")
+
+/**
+ * @brief Uniform block data shared between programs, e.g. camera and time.
+ *
+ * T is the C++ mirror of a std140 block, checked with PRGL_STD140_MEMBER. The
+ * buffer is a persistently mapped ring, update() writes the data of a frame
+ * into the next slot and binds that slot to the binding point, so the GPU can
+ * still read the previous frames while the host writes.
+ */
+template <typename T>
+class UniformBuffer final {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "UniformBuffer: T is copied into mapped memory");
+  static_assert(std::is_standard_layout<T>::value,
+                "UniformBuffer: T needs a standard layout");
+  static_assert((sizeof(T) % 16U) == 0U,
+                "UniformBuffer: std140 blocks are padded to 16 bytes, add "
+                "padding to the end of T");
+
+ public:
+  template <typename... Args>
+  static std::shared_ptr<UniformBuffer<T>> Create(Args&&... args) {
+    return std::make_shared<UniformBuffer<T>>(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @param binding uniform buffer binding point, see
+   * GlslProgram::bindUniformBlock.
+   * @param frameCount slots in the ring, frames in flight plus one.
+   */
+  explicit UniformBuffer(uint32_t binding, uint32_t frameCount = 3U)
+      : mRing(GL_UNIFORM_BUFFER, sizeof(T), frameCount,
+              PersistentBufferRing::Access::Write, getOffsetAlignment()),
+        mBinding(binding),
+        mSlot(0U),
+        mWritten(false) {}
+
+  ~UniformBuffer() = default;
+
+  // once per frame, before the draw calls reading the block
+  void update(const T& data) {
+    // the commands of the last frame are the last users of its slot
+    if (mWritten) {
+      mRing.fence(mSlot);
+    }
+    mSlot = mRing.acquire();
+    std::memcpy(mRing.getMappedSlot(mSlot), &data, sizeof(T));
+    mWritten = true;
+    bind();
+  }
+
+  // bind the slot of the current frame, e.g. after the binding was reused
+  void bind() const {
+    glBindBufferRange(GL_UNIFORM_BUFFER, mBinding, mRing.getHandle(),
+                      static_cast<GLintptr>(mRing.getSlotOffset(mSlot)),
+                      static_cast<GLsizeiptr>(sizeof(T)));
+  }
+
+  uint32_t getBinding() const {
+    return mBinding;
+  }
+
+ private:
+  UniformBuffer(const UniformBuffer&) = delete;
+  UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+  static std::size_t getOffsetAlignment() {
+    int32_t alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    return (alignment > 0) ? static_cast<std::size_t>(alignment) : 256U;
+  }
+
+  PersistentBufferRing mRing;
+  uint32_t mBinding;
+  uint32_t mSlot;
+  bool mWritten;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_UNIFORM_BUFFER_H
@@ -17,6 +17,7 @@
 #include <memory>
 
 #include "prgl/VertexBufferObject.hxx"
+#include "prgl/VertexLayout.hxx"
 
 namespace prgl {
 
@@ -49,9 +50,16 @@ class VertexArrayObject final {
   void bind(bool bind) const;
 
   void addVertexBufferObject(uint32_t location,
-                             const std::shared_ptr<VertexBufferObject>& vbo);
+                             const std::shared_ptr<VertexBufferObject>& vbo,
+                             uint32_t divisor = 0U);
+  // source all attributes of the layout from one (interleaved) buffer
+  void addVertexBufferObject(const std::shared_ptr<VertexBufferObject>& vbo,
+                             const VertexLayout& layout,
+                             uint32_t divisor = 0U);
 
   void render(const DrawMode& mode, uint32_t first, uint32_t count);
+  void renderInstanced(const DrawMode& mode, uint32_t first, uint32_t count,
+                       uint32_t instanceCount, uint32_t baseInstance = 0U);
 
  private:
   VertexArrayObject(const VertexArrayObject&) = delete;
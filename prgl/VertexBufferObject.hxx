@@ -16,6 +16,7 @@
 #include <memory>
 #include <vector>
 
+#include "prgl/BufferHeap.hxx"
 #include "prgl/glCommon.hxx"
 
 namespace prgl {
@@ -46,6 +47,13 @@ class VertexBufferObject final {
 
   VertexBufferObject(Usage usage);
   VertexBufferObject();
+  /**
+   * @brief Keep the vertices in a range of a heap page instead of an own
+   * buffer object, many small meshes then share a few buffers. After
+   * BufferHeap::defragment the buffer has to be added to its
+   * VertexArrayObject again.
+   */
+  explicit VertexBufferObject(const std::shared_ptr<BufferHeap>& heap);
   ~VertexBufferObject();
 
   void bind(bool bind) const;
@@ -57,11 +65,8 @@ class VertexBufferObject final {
     mDataColumns   = dimensions;
     mVerticesCount = count;
 
-    bind(true);
-    glBufferData(GL_ARRAY_BUFFER, (count * sizeof(T)) * mVerticesCount,
-                 static_cast<const void*>(dataPtr),
-                 static_cast<GLenum>(mUsage));
-    bind(false);
+    allocate(static_cast<const void*>(dataPtr),
+             (dimensions * sizeof(T)) * count);
   }
 
   /**
@@ -78,6 +83,20 @@ class VertexBufferObject final {
     createBuffer(data.data()->data(), N, data.size());
   }
 
+  /**
+   * @brief Create an interleaved buffer holding all attributes of a vertex
+   * next to each other, its layout is given by a VertexLayout when adding it
+   * to a VertexArrayObject.
+   *
+   * @tparam Vertex struct holding the attributes of one vertex.
+   */
+  template <class Vertex>
+  void createInterleavedBuffer(const std::vector<Vertex>& vertices) {
+    createInterleavedBuffer(vertices.data(), sizeof(Vertex), vertices.size());
+  }
+  void createInterleavedBuffer(const void* dataPtr, std::size_t stride,
+                               std::size_t count);
+
   /**
    * @brief Update Vertex Buffer object from data.
    *
@@ -124,20 +143,27 @@ class VertexBufferObject final {
     const auto nrBytes    = (N * sizeof(Type)) * nrElements;
     const auto byteOffset = (N * sizeof(Type)) * startIndex;
 
-    bind(true);
-    glBufferSubData(GL_ARRAY_BUFFER, byteOffset, nrBytes,
-                    static_cast<const void*>(&(data[startIndex])));
-    bind(false);
+    uploadRange(static_cast<const void*>(&(data[startIndex])), byteOffset,
+                nrBytes);
   }
 
   DataType getVertexComponentDataType() const;
   uint32_t getVertexComponentDataColumns() const;
   size_t getVerticesCount() const;
+  // buffer holding the vertices, a heap page for heap allocated buffers
+  uint32_t getHandle() const;
+  // byte offset of the first vertex in getHandle()
+  std::size_t getOffset() const;
 
  private:
   VertexBufferObject(const VertexBufferObject&) = delete;
   VertexBufferObject& operator=(const VertexBufferObject&) = delete;
 
+  // (re)allocate nBytes, from the heap if there is one
+  void allocate(const void* dataPtr, std::size_t nBytes);
+  void uploadRange(const void* dataPtr, std::size_t offset,
+                   std::size_t nBytes);
+
   uint32_t mVbo;
 
   DataType mDataType;
@@ -145,6 +171,10 @@ class VertexBufferObject final {
   size_t mVerticesCount;
 
   Usage mUsage;
+
+  std::shared_ptr<BufferHeap> mHeap;
+  // size 0 while nothing is allocated from the heap
+  BufferHeap::Allocation mAllocation;
 };
 
 }  // namespace prgl
@@ -0,0 +1,67 @@
+/**
+ * @file VertexLayout.hxx
+ * @author Thomas Lindemeier
+ * @brief
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_VERTEX_LAYOUT_H
+#define PRGL_VERTEX_LAYOUT_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "prgl/glCommon.hxx"
+
+namespace prgl {
+
+/**
+ * @brief Describes how the attributes of one vertex are laid out in a buffer,
+ * so that a single interleaved buffer can feed several attribute locations.
+ *
+ * @code
+ * // position, normal and texture coordinates in 32 bytes per vertex
+ * VertexLayout layout;
+ * layout.add(0U, 3U).add(1U, 3U).add(2U, 2U);
+ * @endcode
+ */
+class VertexLayout final {
+ public:
+  struct Attribute {
+    uint32_t location;
+    // 1 to 4
+    uint32_t components;
+    // read as float in the shader, doubles are converted
+    DataType type;
+    // map integer types to [0, 1] or [-1, 1]
+    bool normalized;
+    // bytes from the start of the vertex
+    uint32_t offset;
+  };
+
+  /**
+   * @param stride bytes from one vertex to the next, 0 to use the end of the
+   * last attribute.
+   */
+  explicit VertexLayout(uint32_t stride = 0U);
+
+  // append behind the previous attribute, aligned to the component size
+  VertexLayout& add(uint32_t location, uint32_t components,
+                    DataType type = DataType::Float, bool normalized = false);
+  VertexLayout& add(uint32_t location, uint32_t components, DataType type,
+                    bool normalized, uint32_t offset);
+
+  uint32_t getStride() const;
+  const std::vector<Attribute>& getAttributes() const;
+
+ private:
+  uint32_t mStride;
+  // end of the attribute ending last
+  uint32_t mEnd;
+  std::vector<Attribute> mAttributes;
+};
+
+}  // namespace prgl
+
+#endif  // PRGL_VERTEX_LAYOUT_H
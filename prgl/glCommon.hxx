@@ -6,6 +6,7 @@
 #include <stdint.h>
 
 #include <array>
+#include <cstddef>
 #include <memory>
 
 #include "prgl/Types.hxx"
@@ -43,6 +44,28 @@ enum class DataType : uint32_t {
   Double        = GL_DOUBLE
 };
 
+/**
+ * @brief Size of a single component of the given data type in bytes.
+ */
+constexpr std::size_t getSizeInBytes(const DataType type) {
+  switch (type) {
+    case DataType::UnsignedByte:
+    case DataType::Byte:
+      return 1U;
+    case DataType::UnsignedShort:
+    case DataType::Short:
+    case DataType::HalfFloat:
+      return 2U;
+    case DataType::UnsignedInt:
+    case DataType::Int:
+    case DataType::Float:
+      return 4U;
+    case DataType::Double:
+      return 8U;
+  }
+  return 0U;
+}
+
 template <typename T>
 class DataTypeTr {};
 
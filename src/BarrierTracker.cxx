@@ -0,0 +1,114 @@
+#include "prgl/BarrierTracker.hxx"
+
+#include <utility>
+
+namespace prgl {
+
+namespace {
+// textures and buffers have separate name spaces
+constexpr uint64_t TextureKind = 1ULL << 32U;
+constexpr uint64_t BufferKind  = 2ULL << 32U;
+
+// writes that become visible only after a barrier
+bool isIncoherent(BarrierTracker::Access access) {
+  return (access == BarrierTracker::Access::ImageLoadStore) ||
+         (access == BarrierTracker::Access::StorageBuffer) ||
+         (access == BarrierTracker::Access::AtomicCounter);
+}
+}  // namespace
+
+std::shared_ptr<BarrierTracker> BarrierTracker::Create(
+  MemoryBarrier memoryBarrier) {
+  return std::make_shared<BarrierTracker>(std::move(memoryBarrier));
+}
+
+BarrierTracker::BarrierTracker(MemoryBarrier memoryBarrier)
+    : mMemoryBarrier(std::move(memoryBarrier)),
+      mDirty(),
+      mRequired(0U),
+      mWrites(),
+      mStatistics{0U, 0U} {}
+
+BarrierTracker::~BarrierTracker() = default;
+
+void BarrierTracker::useTexture(uint32_t id, Access access, bool writes) {
+  use(TextureKind | id, access, writes);
+}
+
+void BarrierTracker::useBuffer(uint32_t handle, Access access, bool writes) {
+  use(BufferKind | handle, access, writes);
+}
+
+void BarrierTracker::use(const Texture2d& texture, Access access,
+                         bool writes) {
+  useTexture(texture.getId(), access, writes);
+}
+
+void BarrierTracker::use(const Texture2dArray& texture, Access access,
+                         bool writes) {
+  useTexture(texture.getId(), access, writes);
+}
+
+void BarrierTracker::use(const ShaderStorageBuffer& buffer, Access access,
+                         bool writes) {
+  useBuffer(buffer.getHandle(), access, writes);
+}
+
+void BarrierTracker::use(uint64_t key, Access access, bool writes) {
+  const auto bit = static_cast<GLbitfield>(access);
+  const auto it  = mDirty.find(key);
+  // reading or overwriting an incoherent write that this kind of access
+  // cannot see yet
+  if ((it != mDirty.end()) && ((it->second & bit) == 0U)) {
+    mRequired |= bit;
+  }
+  if (writes) {
+    mWrites.push_back(Write{key, access});
+  }
+}
+
+GLbitfield BarrierTracker::flush() {
+  const auto barrier = mRequired;
+  if (barrier != 0U) {
+    if (mMemoryBarrier) {
+      mMemoryBarrier(barrier);
+    } else {
+      glMemoryBarrier(barrier);
+    }
+    mStatistics.issued++;
+    // a barrier covers every earlier write
+    for (auto& dirty : mDirty) {
+      dirty.second |= barrier;
+    }
+  } else {
+    mStatistics.elided++;
+  }
+  mRequired = 0U;
+
+  // writes of the upcoming command
+  for (const auto& write : mWrites) {
+    if (isIncoherent(write.access)) {
+      mDirty[write.key] = 0U;
+    } else {
+      mDirty.erase(write.key);
+    }
+  }
+  mWrites.clear();
+  return barrier;
+}
+
+void BarrierTracker::reset() {
+  mDirty.clear();
+  mRequired = 0U;
+  mWrites.clear();
+}
+
+BarrierTracker::Statistics BarrierTracker::getStatistics() const {
+  return mStatistics;
+}
+
+void BarrierTracker::resetStatistics() {
+  mStatistics = Statistics{0U, 0U};
+}
+
+}  // namespace prgl
@@ -0,0 +1,479 @@
+#include "prgl/BlockCompressor.hxx"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PRGL_BLOCK_COMPRESSOR_SSE2
+#endif
+
+namespace prgl {
+
+namespace {
+// 4x4 RGBA pixels, row by row
+using Block = std::array<uint8_t, 64U>;
+using Axis  = std::array<int16_t, 4U>;
+using Dots  = std::array<int32_t, 16U>;
+
+// BC7 interpolation weights of 4 bit indices
+constexpr std::array<int32_t, 16U> Bc7Weights = {
+  0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+/**
+ * @brief Writes values into a zero initialized block starting at the least
+ * significant bit.
+ */
+class BitWriter final {
+ public:
+  explicit BitWriter(uint8_t* data) : mData(data), mPosition(0U) {}
+
+  void write(uint32_t value, uint32_t bits) {
+    for (auto bit = 0U; bit < bits; bit++) {
+      if (((value >> bit) & 1U) != 0U) {
+        mData[mPosition >> 3U] |= static_cast<uint8_t>(1U << (mPosition & 7U));
+      }
+      mPosition++;
+    }
+  }
+
+ private:
+  uint8_t* mData;
+  uint32_t mPosition;
+};
+
+void loadBlock(const uint8_t* rgba, uint32_t width, uint32_t height,
+               uint32_t stride, uint32_t blockX, uint32_t blockY,
+               Block& block) {
+  for (auto y = 0U; y < 4U; y++) {
+    // partial blocks at the image border repeat the last row and column
+    const auto row = std::min((blockY * 4U) + y, height - 1U);
+    for (auto x = 0U; x < 4U; x++) {
+      const auto column = std::min((blockX * 4U) + x, width - 1U);
+      const auto* pixel =
+        rgba + (((static_cast<std::size_t>(row) * stride) + column) * 4U);
+      std::memcpy(block.data() + (((y * 4U) + x) * 4U), pixel, 4U);
+    }
+  }
+}
+
+/**
+ * @brief Dot product of every pixel of the block with the axis. This runs
+ * for every block and index set, so it is vectorized where possible.
+ */
+void computeDots(const Block& block, const Axis& axis, Dots& dots) {
+#if defined(PRGL_BLOCK_COMPRESSOR_SSE2)
+  const auto zero = _mm_setzero_si128();
+  const auto axes = _mm_setr_epi16(axis[0U], axis[1U], axis[2U], axis[3U],
+                                   axis[0U], axis[1U], axis[2U], axis[3U]);
+  for (auto i = 0U; i < 4U; i++) {
+    __m128i pixels;
+    std::memcpy(&pixels, block.data() + (i * 16U), sizeof(pixels));
+    // widen to 16 bit, two pixels per register: [r*x + g*y, b*z + a*w] each
+    const auto low  = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), axes);
+    const auto high = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), axes);
+    // gather both partial sums of the four pixels and add them
+    const auto lowSorted  = _mm_shuffle_epi32(low, _MM_SHUFFLE(3, 1, 2, 0));
+    const auto highSorted = _mm_shuffle_epi32(high, _MM_SHUFFLE(3, 1, 2, 0));
+    const auto sums = _mm_add_epi32(_mm_unpacklo_epi64(lowSorted, highSorted),
+                                    _mm_unpackhi_epi64(lowSorted, highSorted));
+    std::memcpy(dots.data() + (i * 4U), &sums, sizeof(sums));
+  }
+#else
+  for (auto i = 0U; i < 16U; i++) {
+    const auto* pixel = block.data() + (i * 4U);
+    dots[i] = (pixel[0U] * axis[0U]) + (pixel[1U] * axis[1U]) +
+              (pixel[2U] * axis[2U]) + (pixel[3U] * axis[3U]);
+  }
+#endif
+}
+
+/**
+ * @brief Principal axis of the first channels components of the block, zero
+ * if all pixels are equal.
+ */
+std::array<float, 4U> principalAxis(const Block& block, uint32_t channels) {
+  std::array<float, 4U> mean = {0.0F, 0.0F, 0.0F, 0.0F};
+  for (auto i = 0U; i < 16U; i++) {
+    for (auto c = 0U; c < channels; c++) {
+      mean[c] += static_cast<float>(block[(i * 4U) + c]);
+    }
+  }
+  for (auto& m : mean) {
+    m /= 16.0F;
+  }
+
+  std::array<std::array<float, 4U>, 4U> covariance = {};
+  for (auto i = 0U; i < 16U; i++) {
+    for (auto a = 0U; a < channels; a++) {
+      const auto da = static_cast<float>(block[(i * 4U) + a]) - mean[a];
+      for (auto b = 0U; b < channels; b++) {
+        const auto db = static_cast<float>(block[(i * 4U) + b]) - mean[b];
+        covariance[a][b] += da * db;
+      }
+    }
+  }
+
+  // power iteration starting at the channel with the largest variance
+  auto largest = 0U;
+  for (auto c = 1U; c < channels; c++) {
+    if (covariance[c][c] > covariance[largest][largest]) {
+      largest = c;
+    }
+  }
+  auto axis = covariance[largest];
+  for (auto iteration = 0U; iteration < 8U; iteration++) {
+    std::array<float, 4U> next = {0.0F, 0.0F, 0.0F, 0.0F};
+    auto norm                  = 0.0F;
+    for (auto a = 0U; a < channels; a++) {
+      for (auto b = 0U; b < channels; b++) {
+        next[a] += covariance[a][b] * axis[b];
+      }
+      norm = std::max(norm, std::abs(next[a]));
+    }
+    if (norm <= 0.0F) {
+      return {0.0F, 0.0F, 0.0F, 0.0F};
+    }
+    for (auto c = 0U; c < channels; c++) {
+      axis[c] = next[c] / norm;
+    }
+  }
+  return axis;
+}
+
+/**
+ * @brief Pixels with the smallest and largest projection onto the principal
+ * axis, pixels failing the mask are ignored.
+ */
+template <typename Mask>
+std::pair<uint32_t, uint32_t> extremePixels(const Block& block,
+                                            uint32_t channels, Mask mask) {
+  const auto axis = principalAxis(block, channels);
+  auto minimum    = 0U;
+  auto maximum    = 0U;
+  auto minValue   = std::numeric_limits<float>::max();
+  auto maxValue   = std::numeric_limits<float>::lowest();
+  for (auto i = 0U; i < 16U; i++) {
+    if (!mask(i)) {
+      continue;
+    }
+    auto projection = 0.0F;
+    for (auto c = 0U; c < channels; c++) {
+      projection += static_cast<float>(block[(i * 4U) + c]) * axis[c];
+    }
+    if (projection < minValue) {
+      minValue = projection;
+      minimum  = i;
+    }
+    if (projection > maxValue) {
+      maxValue = projection;
+      maximum  = i;
+    }
+  }
+  return {minimum, maximum};
+}
+
+/**
+ * @brief Position of every pixel on the line from e0 to e1, quantized to
+ * steps + 1 values.
+ */
+std::array<uint32_t, 16U> quantizePositions(const Block& block,
+                                            const std::array<int32_t, 4U>& e0,
+                                            const std::array<int32_t, 4U>& e1,
+                                            uint32_t steps) {
+  Axis axis;
+  auto base   = 0;
+  auto length = 0;
+  for (auto c = 0U; c < 4U; c++) {
+    axis[c] = static_cast<int16_t>(e1[c] - e0[c]);
+    base += e0[c] * axis[c];
+    length += axis[c] * axis[c];
+  }
+
+  std::array<uint32_t, 16U> positions = {};
+  if (length == 0) {
+    return positions;
+  }
+  Dots dots;
+  computeDots(block, axis, dots);
+  const auto scale = 1.0F / static_cast<float>(length);
+  for (auto i = 0U; i < 16U; i++) {
+    const auto t =
+      std::clamp(static_cast<float>(dots[i] - base) * scale, 0.0F, 1.0F);
+    positions[i] =
+      static_cast<uint32_t>(std::lround(t * static_cast<float>(steps)));
+  }
+  return positions;
+}
+
+uint16_t toRgb565(const uint8_t* color) {
+  const auto r = ((color[0U] * 31U) + 127U) / 255U;
+  const auto g = ((color[1U] * 63U) + 127U) / 255U;
+  const auto b = ((color[2U] * 31U) + 127U) / 255U;
+  return static_cast<uint16_t>((r << 11U) | (g << 5U) | b);
+}
+
+std::array<int32_t, 4U> fromRgb565(uint16_t color) {
+  const auto r = (color >> 11U) & 31U;
+  const auto g = (color >> 5U) & 63U;
+  const auto b = color & 31U;
+  return {static_cast<int32_t>((r << 3U) | (r >> 2U)),
+          static_cast<int32_t>((g << 2U) | (g >> 4U)),
+          static_cast<int32_t>((b << 3U) | (b >> 2U)), 0};
+}
+
+/**
+ * @brief BC1 color block. With punchThrough, pixels with alpha < 128 use the
+ * transparent index of the three color mode.
+ */
+void encodeColorBlock(const Block& block, bool punchThrough, uint8_t* out) {
+  auto transparent = false;
+  auto opaque      = false;
+  for (auto i = 0U; i < 16U; i++) {
+    const auto isTransparent = punchThrough && (block[(i * 4U) + 3U] < 128U);
+    transparent              = transparent || isTransparent;
+    opaque                   = opaque || !isTransparent;
+  }
+  if (!opaque) {
+    // c0 <= c1 selects the three color mode, index 3 is transparent black
+    std::memset(out, 0, 4U);
+    std::memset(out + 4U, 0xFF, 4U);
+    return;
+  }
+
+  const auto isOpaque = [&block, transparent](uint32_t i) {
+    return !transparent || (block[(i * 4U) + 3U] >= 128U);
+  };
+  const auto extremes = extremePixels(block, 3U, isOpaque);
+  auto c0             = toRgb565(block.data() + (extremes.second * 4U));
+  auto c1             = toRgb565(block.data() + (extremes.first * 4U));
+  // four colors need c0 > c1, three colors plus transparent c0 <= c1
+  if ((!transparent && (c0 < c1)) || (transparent && (c0 > c1))) {
+    std::swap(c0, c1);
+  }
+
+  auto indices = 0U;
+  if (c0 != c1) {
+    // palette order of the interpolated colors
+    constexpr std::array<uint32_t, 4U> FourColors  = {0U, 2U, 3U, 1U};
+    constexpr std::array<uint32_t, 3U> ThreeColors = {0U, 2U, 1U};
+
+    const auto positions = quantizePositions(block, fromRgb565(c0),
+                                             fromRgb565(c1),
+                                             transparent ? 2U : 3U);
+    for (auto i = 0U; i < 16U; i++) {
+      uint32_t index = 3U;
+      if (isOpaque(i)) {
+        index = transparent ? ThreeColors[positions[i]]
+                            : FourColors[positions[i]];
+      }
+      indices |= index << (i * 2U);
+    }
+  } else if (transparent) {
+    for (auto i = 0U; i < 16U; i++) {
+      indices |= (isOpaque(i) ? 0U : 3U) << (i * 2U);
+    }
+  }
+
+  BitWriter writer(out);
+  writer.write(c0, 16U);
+  writer.write(c1, 16U);
+  writer.write(indices, 32U);
+}
+
+/**
+ * @brief BC4 block of one channel, also the alpha block of BC3 and the two
+ * halves of BC5.
+ */
+void encodeChannelBlock(const Block& block, uint32_t channel, uint8_t* out) {
+  auto minimum = 255U;
+  auto maximum = 0U;
+  for (auto i = 0U; i < 16U; i++) {
+    const auto value = static_cast<uint32_t>(block[(i * 4U) + channel]);
+    minimum          = std::min(minimum, value);
+    maximum          = std::max(maximum, value);
+  }
+
+  BitWriter writer(out);
+  // a0 > a1 selects six interpolated values between the endpoints
+  writer.write(maximum, 8U);
+  writer.write(minimum, 8U);
+  const auto range = maximum - minimum;
+  for (auto i = 0U; i < 16U; i++) {
+    auto index = 0U;
+    if (range > 0U) {
+      const auto value = static_cast<uint32_t>(block[(i * 4U) + channel]);
+      const auto position =
+        (((value - minimum) * 14U) + range) / (2U * range);
+      index = (position == 7U) ? 0U : ((position == 0U) ? 1U : 8U - position);
+    }
+    writer.write(index, 3U);
+  }
+}
+
+/**
+ * @brief BC7 mode 6: a single subset with 7 bit RGBA endpoints, one p-bit per
+ * endpoint and 4 bit indices.
+ */
+void encodeBc7Block(const Block& block, uint8_t* out) {
+  const auto extremes = extremePixels(block, 4U, [](uint32_t) { return true; });
+
+  std::array<std::array<uint32_t, 4U>, 2U> endpoints;
+  std::array<uint32_t, 2U> pBits;
+  std::array<std::array<int32_t, 4U>, 2U> colors;
+  const std::array<uint32_t, 2U> pixels = {extremes.first, extremes.second};
+  for (auto e = 0U; e < 2U; e++) {
+    const auto* pixel = block.data() + (pixels[e] * 4U);
+    // the p-bit is shared by all channels, keep the one with less error
+    auto bestError = std::numeric_limits<int32_t>::max();
+    for (auto p = 0U; p < 2U; p++) {
+      auto error = 0;
+      std::array<uint32_t, 4U> quantized;
+      for (auto c = 0U; c < 4U; c++) {
+        const auto value = static_cast<int32_t>(pixel[c]);
+        quantized[c] = static_cast<uint32_t>(
+          std::clamp((value - static_cast<int32_t>(p) + 1) / 2, 0, 127));
+        const auto restored = static_cast<int32_t>((quantized[c] << 1U) | p);
+        error += (restored - value) * (restored - value);
+      }
+      if (error < bestError) {
+        bestError    = error;
+        endpoints[e] = quantized;
+        pBits[e]     = p;
+      }
+    }
+    for (auto c = 0U; c < 4U; c++) {
+      colors[e][c] = static_cast<int32_t>((endpoints[e][c] << 1U) | pBits[e]);
+    }
+  }
+
+  // find the nearest weight on the line between the restored endpoints
+  const auto positions = quantizePositions(block, colors[0U], colors[1U], 64U);
+  std::array<uint32_t, 16U> indices;
+  for (auto i = 0U; i < 16U; i++) {
+    const auto weight = static_cast<int32_t>(positions[i]);
+    const auto nearest =
+      std::min_element(Bc7Weights.begin(), Bc7Weights.end(),
+                       [weight](int32_t a, int32_t b) {
+                         return std::abs(a - weight) < std::abs(b - weight);
+                       });
+    indices[i] = static_cast<uint32_t>(nearest - Bc7Weights.begin());
+  }
+
+  // the most significant bit of the first index is implicitly zero, the
+  // weights are symmetric so swapping the endpoints mirrors the indices
+  if (indices[0U] >= 8U) {
+    std::swap(endpoints[0U], endpoints[1U]);
+    std::swap(pBits[0U], pBits[1U]);
+    for (auto& index : indices) {
+      index = 15U - index;
+    }
+  }
+
+  BitWriter writer(out);
+  writer.write(1U << 6U, 7U);
+  for (auto c = 0U; c < 4U; c++) {
+    writer.write(endpoints[0U][c], 7U);
+    writer.write(endpoints[1U][c], 7U);
+  }
+  writer.write(pBits[0U], 1U);
+  writer.write(pBits[1U], 1U);
+  writer.write(indices[0U], 3U);
+  for (auto i = 1U; i < 16U; i++) {
+    writer.write(indices[i], 4U);
+  }
+}
+
+void encodeBlock(const Block& block, TextureFormatInternal format,
+                 uint8_t* out) {
+  switch (format) {
+    case TextureFormatInternal::Bc1Rgb:
+      encodeColorBlock(block, false, out);
+      break;
+    case TextureFormatInternal::Bc1Rgba:
+      encodeColorBlock(block, true, out);
+      break;
+    case TextureFormatInternal::Bc3Rgba:
+      encodeChannelBlock(block, 3U, out);
+      encodeColorBlock(block, false, out + 8U);
+      break;
+    case TextureFormatInternal::Bc4R:
+      encodeChannelBlock(block, 0U, out);
+      break;
+    case TextureFormatInternal::Bc5Rg:
+      encodeChannelBlock(block, 0U, out);
+      encodeChannelBlock(block, 1U, out + 8U);
+      break;
+    case TextureFormatInternal::Bc7Rgba:
+    case TextureFormatInternal::Bc7SrgbAlpha:
+      encodeBc7Block(block, out);
+      break;
+    default:
+      throw std::invalid_argument("BlockCompressor: unsupported format");
+  }
+}
+}  // namespace
+
+BlockCompressor::BlockCompressor(uint32_t threadCount)
+    : mThreadCount(threadCount) {
+  if (mThreadCount == 0U) {
+    mThreadCount = std::max(1U, std::thread::hardware_concurrency());
+  }
+}
+
+std::vector<uint8_t> BlockCompressor::compress(const uint8_t* rgba,
+                                               uint32_t width, uint32_t height,
+                                               TextureFormatInternal format,
+                                               uint32_t rowStride) const {
+  const auto blockSize = getCompressedBlockSize(format);
+  if (blockSize == 0U) {
+    throw std::invalid_argument(
+      "BlockCompressor::compress: format is not block compressed");
+  }
+  if ((rgba == nullptr) || (width == 0U) || (height == 0U)) {
+    throw std::invalid_argument("BlockCompressor::compress: empty image");
+  }
+
+  const auto stride  = (rowStride == 0U) ? width : rowStride;
+  const auto blocksX = (width + 3U) / 4U;
+  const auto blocksY = (height + 3U) / 4U;
+  std::vector<uint8_t> result(getCompressedImageSize(format, width, height),
+                              0U);
+
+  // workers take every threadCount-th row of blocks
+  const auto threadCount = std::min(mThreadCount, blocksY);
+  const auto encodeRows  = [&](uint32_t firstRow) {
+    Block block;
+    for (auto blockY = firstRow; blockY < blocksY; blockY += threadCount) {
+      for (auto blockX = 0U; blockX < blocksX; blockX++) {
+        loadBlock(rgba, width, height, stride, blockX, blockY, block);
+        const auto offset =
+          ((static_cast<std::size_t>(blockY) * blocksX) + blockX) * blockSize;
+        encodeBlock(block, format, result.data() + offset);
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (auto t = 1U; t < threadCount; t++) {
+    workers.emplace_back(encodeRows, t);
+  }
+  encodeRows(0U);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  return result;
+}
+
+uint32_t BlockCompressor::getThreadCount() const {
+  return mThreadCount;
+}
+
+}  // namespace prgl
@@ -0,0 +1,237 @@
+#include "prgl/BufferHeap.hxx"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace prgl {
+
+namespace {
+uint64_t queryAlignment(GLenum target) {
+  GLenum parameter = GL_NONE;
+  if (target == GL_SHADER_STORAGE_BUFFER) {
+    parameter = GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT;
+  } else if (target == GL_UNIFORM_BUFFER) {
+    parameter = GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT;
+  } else {
+    // vertex and index data, enough for any attribute type
+    return 16U;
+  }
+  int32_t alignment = 0;
+  glGetIntegerv(parameter, &alignment);
+  // the allocator needs a power of two
+  uint64_t result = 1U;
+  while (result < static_cast<uint64_t>(std::max(alignment, 1))) {
+    result <<= 1U;
+  }
+  return result;
+}
+}  // namespace
+
+BufferHeap::BufferHeap(GLenum target, uint64_t pageSize)
+    : mTarget(target),
+      mAlignment(queryAlignment(target)),
+      mPageSize(pageSize),
+      mPages(),
+      mScratch(INVALID_HANDLE),
+      mScratchSize(0U) {
+  if (pageSize == 0U) {
+    throw std::invalid_argument("BufferHeap: page size must not be zero");
+  }
+}
+
+BufferHeap::~BufferHeap() {
+  for (auto& page : mPages) {
+    if (page.handle != INVALID_HANDLE) {
+      glDeleteBuffers(1, &page.handle);
+    }
+  }
+  if (mScratch != INVALID_HANDLE) {
+    glDeleteBuffers(1, &mScratch);
+  }
+}
+
+/**
+ * @brief Create the buffer without binding it, binding an index buffer would
+ * replace the one of the bound vertex array.
+ */
+uint32_t BufferHeap::addPage(uint64_t size, bool dedicated) {
+  uint32_t handle = INVALID_HANDLE;
+  glCreateBuffers(1, &handle);
+  glNamedBufferStorage(handle, static_cast<GLsizeiptr>(size), nullptr,
+                       GL_DYNAMIC_STORAGE_BIT);
+
+  Page page = {handle, TlsfAllocator(size), dedicated};
+  for (auto i = 0U; i < mPages.size(); i++) {
+    if (mPages[i].handle == INVALID_HANDLE) {
+      mPages[i] = std::move(page);
+      return i;
+    }
+  }
+  mPages.push_back(std::move(page));
+  return static_cast<uint32_t>(mPages.size() - 1U);
+}
+
+BufferHeap::Allocation BufferHeap::allocate(uint64_t size,
+                                            uint64_t alignment) {
+  if (size == 0U) {
+    throw std::invalid_argument("BufferHeap::allocate: size must be positive");
+  }
+  alignment = std::max(alignment, mAlignment);
+  for (auto i = 0U; i < mPages.size(); i++) {
+    if (mPages[i].handle == INVALID_HANDLE) {
+      continue;
+    }
+    const auto allocation = mPages[i].allocator.allocate(size, alignment);
+    if (allocation) {
+      return {mPages[i].handle, allocation->offset, allocation->size, i,
+              allocation->block};
+    }
+  }
+  // pages start at offset 0, so any alignment fits
+  const auto page       = addPage(std::max(mPageSize, size), size > mPageSize);
+  const auto allocation = mPages[page].allocator.allocate(size, alignment);
+  if (!allocation) {
+    throw std::runtime_error("BufferHeap::allocate: could not allocate " +
+                             std::to_string(size) + " bytes");
+  }
+  return {mPages[page].handle, allocation->offset, allocation->size, page,
+          allocation->block};
+}
+
+void BufferHeap::free(const Allocation& allocation) {
+  if ((allocation.page >= mPages.size()) ||
+      (mPages[allocation.page].handle == INVALID_HANDLE)) {
+    throw std::invalid_argument("BufferHeap::free: unknown page");
+  }
+  auto& page = mPages[allocation.page];
+  page.allocator.free(allocation.block);
+  // regular pages are kept for later allocations
+  if (page.dedicated && (page.allocator.getStatistics().allocations == 0U)) {
+    glDeleteBuffers(1, &page.handle);
+    page.handle = INVALID_HANDLE;
+  }
+}
+
+BufferHeap::Allocation BufferHeap::resolve(
+  const Allocation& allocation) const {
+  if ((allocation.page >= mPages.size()) ||
+      (mPages[allocation.page].handle == INVALID_HANDLE)) {
+    throw std::invalid_argument("BufferHeap::resolve: unknown page");
+  }
+  const auto& page   = mPages[allocation.page];
+  const auto current = page.allocator.get(allocation.block);
+  return {page.handle, current.offset, current.size, allocation.page,
+          allocation.block};
+}
+
+BufferHeap::Allocation BufferHeap::resolveRange(const char* function,
+                                                const Allocation& allocation,
+                                                uint64_t offset,
+                                                uint64_t nBytes) const {
+  const auto current = resolve(allocation);
+  if ((offset > current.size) || (nBytes > (current.size - offset))) {
+    throw std::invalid_argument(std::string("BufferHeap::") + function +
+                                ": range exceeds the allocation");
+  }
+  return current;
+}
+
+void BufferHeap::upload(const Allocation& allocation, const void* dataStart,
+                        uint64_t nBytes, uint64_t offset) {
+  const auto current = resolveRange("upload", allocation, offset, nBytes);
+  glNamedBufferSubData(current.buffer,
+                       static_cast<GLintptr>(current.offset + offset),
+                       static_cast<GLsizeiptr>(nBytes), dataStart);
+}
+
+void BufferHeap::download(const Allocation& allocation, void* dataStart,
+                          uint64_t nBytes, uint64_t offset) const {
+  const auto current = resolveRange("download", allocation, offset, nBytes);
+  glGetNamedBufferSubData(current.buffer,
+                          static_cast<GLintptr>(current.offset + offset),
+                          static_cast<GLsizeiptr>(nBytes), dataStart);
+}
+
+void BufferHeap::bindRange(const Allocation& allocation,
+                           uint32_t location) const {
+  const auto current = resolve(allocation);
+  glBindBufferRange(mTarget, location, current.buffer,
+                    static_cast<GLintptr>(current.offset),
+                    static_cast<GLsizeiptr>(current.size));
+}
+
+/**
+ * @brief GL does not allow copies within a buffer to overlap, moves that
+ * overlap their own source go through a scratch buffer.
+ */
+uint64_t BufferHeap::defragment() {
+  // shader writes have to be visible to the copies
+  glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+  uint64_t moved = 0U;
+  for (auto& page : mPages) {
+    if (page.handle == INVALID_HANDLE) {
+      continue;
+    }
+    for (const auto& move : page.allocator.defragment()) {
+      const auto from = static_cast<GLintptr>(move.from);
+      const auto to   = static_cast<GLintptr>(move.to);
+      const auto size = static_cast<GLsizeiptr>(move.size);
+      if ((move.to + move.size) <= move.from) {
+        glCopyNamedBufferSubData(page.handle, page.handle, from, to, size);
+      } else {
+        if (mScratchSize < move.size) {
+          if (mScratch != INVALID_HANDLE) {
+            glDeleteBuffers(1, &mScratch);
+          }
+          glCreateBuffers(1, &mScratch);
+          glNamedBufferStorage(mScratch, size, nullptr, 0U);
+          mScratchSize = move.size;
+        }
+        glCopyNamedBufferSubData(page.handle, mScratch, from, 0, size);
+        glCopyNamedBufferSubData(mScratch, page.handle, 0, to, size);
+      }
+      moved += move.size;
+    }
+  }
+  return moved;
+}
+
+GLenum BufferHeap::getTarget() const {
+  return mTarget;
+}
+
+uint64_t BufferHeap::getAlignment() const {
+  return mAlignment;
+}
+
+uint64_t BufferHeap::getPageSize() const {
+  return mPageSize;
+}
+
+BufferHeap::Statistics BufferHeap::getStatistics() const {
+  Statistics statistics = {0U, 0U, 0U, 0U, 0U, 0.0F};
+  for (const auto& page : mPages) {
+    if (page.handle == INVALID_HANDLE) {
+      continue;
+    }
+    statistics.pages++;
+    const auto pageStatistics = page.allocator.getStatistics();
+    statistics.capacity += pageStatistics.capacity;
+    statistics.used += pageStatistics.used;
+    statistics.allocations += pageStatistics.allocations;
+    statistics.largestFree =
+      std::max(statistics.largestFree, pageStatistics.largestFree);
+  }
+  const auto freeBytes = statistics.capacity - statistics.used;
+  if (freeBytes > 0U) {
+    statistics.fragmentation =
+      1.0F - static_cast<float>(static_cast<double>(statistics.largestFree) /
+                                static_cast<double>(freeBytes));
+  }
+  return statistics;
+}
+
+}  // namespace prgl
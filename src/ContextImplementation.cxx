@@ -6,10 +6,27 @@
 #include "prgl/ContextImplementation.hxx"
 
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
+
+#include "prgl/QuadRenderer.hxx"
 
 namespace prgl {
 
+namespace {
+// contexts by window, to find the ContextImplementation of the current one
+std::mutex& contextsMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::unordered_map<GLFWwindow*, ContextImplementation*>& contexts() {
+  static std::unordered_map<GLFWwindow*, ContextImplementation*> map;
+  return map;
+}
+}  // namespace
+
 void checkGLError(const char* file, const char* function, int line) {
   auto err = glGetError();
 
@@ -111,6 +128,14 @@ ContextImplementation::ContextImplementation()
 
 ContextImplementation::~ContextImplementation() {
   if (getGLFW() != nullptr) {
+    {
+      std::lock_guard<std::mutex> lock(contextsMutex());
+      contexts().erase(getGLFW());
+    }
+    if (mQuadRenderer != nullptr) {
+      makeCurrent();
+      mQuadRenderer.reset();
+    }
     glfwDestroyWindow(getGLFW());
     glfwTerminate();
   }
@@ -169,7 +194,7 @@ ContextImplementation::ContextImplementation(
   int32_t greenBits, int32_t blueBits, int32_t alphaBits, int32_t depthBits,
   int32_t stencilBits, int32_t samples, bool resizable, bool visible,
   bool sRGB_capable, GLFWmonitor* monitor, GLFWwindow* shareContext)
-    : mGlfwWindow(nullptr) {
+    : mGlfwWindow(nullptr), mQuadRenderer(nullptr) {
   initGLFW();
 
   glfwWindowHint(GLFW_RED_BITS, redBits);
@@ -201,6 +226,10 @@ ContextImplementation::ContextImplementation(
   }
 
   initGLEW(mGlfwWindow);
+  {
+    std::lock_guard<std::mutex> lock(contextsMutex());
+    contexts()[mGlfwWindow] = this;
+  }
 
   // opengl error callback
 #ifndef NDEBUG
@@ -245,4 +274,18 @@ void ContextImplementation::makeCurrent() const {
   }
 }
 
+QuadRenderer& ContextImplementation::getQuadRenderer() {
+  if (mQuadRenderer == nullptr) {
+    makeCurrent();
+    mQuadRenderer = QuadRenderer::Create();
+  }
+  return *mQuadRenderer;
+}
+
+ContextImplementation* ContextImplementation::GetCurrent() {
+  std::lock_guard<std::mutex> lock(contextsMutex());
+  const auto it = contexts().find(glfwGetCurrentContext());
+  return (it != contexts().end()) ? it->second : nullptr;
+}
+
 }  // namespace prgl
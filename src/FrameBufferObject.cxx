@@ -2,6 +2,8 @@
 
 #include <iostream>
 
+#include "prgl/BarrierTracker.hxx"
+
 namespace prgl {
 std::shared_ptr<FrameBufferObject> FrameBufferObject::Create() {
   return std::make_shared<FrameBufferObject>();
@@ -22,6 +24,13 @@ uint32_t FrameBufferObject::getId() const {
 
 void FrameBufferObject::bind(bool bind) const {
   if (bind) {
+    // draws write the attachments, earlier image stores have to land first
+    for (const auto* attachment : {mTarget.get(), mDepth.get()}) {
+      if ((attachment != nullptr) && attachment->getBarrierTracker()) {
+        attachment->getBarrierTracker()->flush(
+          *attachment, BarrierTracker::Access::Framebuffer, true);
+      }
+    }
     glBindFramebuffer(GL_FRAMEBUFFER, mHandle);
   } else {
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -3,17 +3,19 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 
 namespace prgl {
 
 std::shared_ptr<GlslComputeShader> GlslComputeShader::Create(
-  const std::string& glslSource) {
-  return std::make_shared<GlslComputeShader>(glslSource);
+  const std::string& glslSource, const Defines& defines) {
+  return std::make_shared<GlslComputeShader>(glslSource, defines);
 }
 
-GlslComputeShader::GlslComputeShader(const std::string& glslSource)
-    : mShaderHandle(INVALID_HANDLE) {
-  attach(glslSource);
+GlslComputeShader::GlslComputeShader(const std::string& glslSource,
+                                     const Defines& defines)
+    : mShaderHandle(INVALID_HANDLE), mWorkGroupSize({1U, 1U, 1U}) {
+  attach(InjectDefines(glslSource, defines));
 }
 
 GlslComputeShader::~GlslComputeShader() {
@@ -30,6 +32,19 @@ GlslComputeShader::~GlslComputeShader() {
 
 void GlslComputeShader::attach(const std::string& source) {
   if (!source.empty()) {
+    const auto& cache = GetBinaryCache();
+    ProgramBinaryCache::Key key;
+    if (cache) {
+      key = cache->makeKey({{GL_COMPUTE_SHADER, source}});
+      if (cache->load(mProgHandle, key)) {
+        reflect();
+        queryWorkGroupSize();
+        return;
+      }
+      glProgramParameteri(mProgHandle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                          GL_TRUE);
+    }
+
     // compile the shader
     mShaderHandle = compile(source, GL_COMPUTE_SHADER);
     glAttachShader(mProgHandle, mShaderHandle);
@@ -51,6 +66,11 @@ void GlslComputeShader::attach(const std::string& source) {
          << log << std::endl;
       throw std::runtime_error(ss.str());
     }
+    if (cache) {
+      cache->store(mProgHandle, key);
+    }
+    reflect();
+    queryWorkGroupSize();
   } else {
     std::stringstream ss;
     ss << "ComputeShader() : empty : " << source << std::endl;
@@ -58,11 +78,23 @@ void GlslComputeShader::attach(const std::string& source) {
   }
 }
 
-vec3ui GlslComputeShader::getWorkGroupSize() const {
+void GlslComputeShader::queryWorkGroupSize() {
   vec3i size;
   glGetProgramiv(mProgHandle, GL_COMPUTE_WORK_GROUP_SIZE, &(size[0]));
-  return {static_cast<uint32_t>(size[0U]), static_cast<uint32_t>(size[1U]),
-          static_cast<uint32_t>(size[2U])};
+  mWorkGroupSize = {static_cast<uint32_t>(size[0U]),
+                    static_cast<uint32_t>(size[1U]),
+                    static_cast<uint32_t>(size[2U])};
+}
+
+const vec3ui& GlslComputeShader::getWorkGroupSize() const {
+  return mWorkGroupSize;
+}
+
+vec3ui GlslComputeShader::getGroupCount(uint32_t width, uint32_t height,
+                                        uint32_t depth) const {
+  return {(width + mWorkGroupSize[0U] - 1U) / mWorkGroupSize[0U],
+          (height + mWorkGroupSize[1U] - 1U) / mWorkGroupSize[1U],
+          (depth + mWorkGroupSize[2U] - 1U) / mWorkGroupSize[2U]};
 }
 
 vec3ui GlslComputeShader::getMaxWorkGroupSize() {
@@ -75,15 +107,44 @@ vec3ui GlslComputeShader::getMaxWorkGroupSize() {
 void GlslComputeShader::dispatchCompute(uint32_t num_groups_x,
                                         uint32_t num_groups_y,
                                         uint32_t num_groups_z) {
+  if (mBarrierTracker) {
+    declareBindings();
+    mBarrierTracker->flush();
+  }
   glDispatchCompute(num_groups_x, num_groups_y, num_groups_z);
 }
 
+void GlslComputeShader::dispatchComputeIndirect(
+  const std::shared_ptr<ShaderStorageBuffer>& buffer, uint32_t offset) {
+  if (((offset % 4U) != 0U) ||
+      ((offset + sizeof(DispatchIndirectCommand)) >
+       buffer->getSizeInBytes())) {
+    throw std::invalid_argument(
+      "GlslComputeShader::dispatchComputeIndirect: offset must be a multiple "
+      "of 4 and the command must lie inside the buffer");
+  }
+  if (mBarrierTracker) {
+    declareBindings();
+    mBarrierTracker->use(*buffer, BarrierTracker::Access::Command);
+    mBarrierTracker->flush();
+  } else {
+    memoryBarrier(GL_COMMAND_BARRIER_BIT);
+  }
+  glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, buffer->getHandle());
+  glDispatchComputeIndirect(
+    static_cast<GLintptr>(buffer->getOffset() + offset));
+  glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+}
+
 void GlslComputeShader::memoryBarrier(GLbitfield barrierType) {
   glMemoryBarrier(barrierType);
 }
 
 /**
- * @brief Dispatch shader at region of interest.
+ * @brief Dispatch shader at region of interest. Without a barrier tracker all
+ * barriers are issued after the dispatch, so that draws and downloads see the
+ * results. With one the written resources carry the tracker and their readers
+ * issue only the barriers they need.
  *
  * @param x
  * @param y
@@ -98,10 +159,12 @@ void GlslComputeShader::execute(int32_t x, int32_t y, int32_t w, int32_t h) {
 
   set2i("offset", x, y);
 
-  const auto workSize = getWorkGroupSize();
-  dispatchCompute((static_cast<uint32_t>(w) / workSize[0U]) + 1U,
-                  (static_cast<uint32_t>(h) / workSize[1U]) + 1U, 1U);
-  memoryBarrier(GL_ALL_BARRIER_BITS);
+  const auto groups =
+    getGroupCount(static_cast<uint32_t>(w), static_cast<uint32_t>(h));
+  dispatchCompute(groups[0U], groups[1U], 1U);
+  if (!mBarrierTracker) {
+    memoryBarrier(GL_ALL_BARRIER_BITS);
+  }
 }
 
 /**
@@ -110,16 +173,45 @@ void GlslComputeShader::execute(int32_t x, int32_t y, int32_t w, int32_t h) {
  * @param location
  * @param texture
  * @param access
+ * @param level mip level to bind
  */
 void GlslComputeShader::bindImage2D(uint32_t unit,
                                     const std::shared_ptr<Texture2d>& texture,
-                                    TextureAccess access) {
+                                    TextureAccess access, int32_t level) {
+  if (!isBound()) {
+    throw std::runtime_error(
+      "trying to bind image to program that is not the currently bound "
+      "program.");
+  }
+  texture->bindImageTexture(unit, access, level);
+  trackBinding(BarrierTracker::Access::ImageLoadStore, unit,
+               {true, texture->getId(), access != TextureAccess::ReadOnly});
+  attachBarrierTracker(*texture, access != TextureAccess::ReadOnly);
+}
+
+/**
+ * @brief Bind a layer of a texture array as image2d, e.g. a resident tile of
+ * a TiledTexture.
+ *
+ * @param unit
+ * @param texture
+ * @param layer
+ * @param access
+ * @param level mip level to bind
+ */
+void GlslComputeShader::bindImage2D(
+  uint32_t unit, const std::shared_ptr<Texture2dArray>& texture,
+  uint32_t layer, TextureAccess access, int32_t level) {
   if (!isBound()) {
     throw std::runtime_error(
       "trying to bind image to program that is not the currently bound "
       "program.");
   }
-  texture->bindImageTexture(unit, access);
+  texture->bindImageTexture(unit, access, level, false,
+                            static_cast<int32_t>(layer));
+  trackBinding(BarrierTracker::Access::ImageLoadStore, unit,
+               {true, texture->getId(), access != TextureAccess::ReadOnly});
+  attachBarrierTracker(*texture, access != TextureAccess::ReadOnly);
 }
 
 /**
@@ -127,15 +219,20 @@ void GlslComputeShader::bindImage2D(uint32_t unit,
  *
  * @param location
  * @param buffer
+ * @param writes false if the shader only reads the buffer
  */
 void GlslComputeShader::bindSSBO(
-  uint32_t location, const std::shared_ptr<ShaderStorageBuffer>& buffer) {
+  uint32_t location, const std::shared_ptr<ShaderStorageBuffer>& buffer,
+  bool writes) {
   if (!isBound()) {
     throw std::runtime_error(
       "trying to bind SSBO to program that is not the currently bound "
       "program.");
   }
   buffer->bindBase(location);
+  trackBinding(BarrierTracker::Access::StorageBuffer, location,
+               {false, buffer->getHandle(), writes});
+  attachBarrierTracker(*buffer, writes);
 }
 
 }  // namespace prgl
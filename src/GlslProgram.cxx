@@ -1,35 +1,216 @@
 #include "prgl/GlslProgram.hxx"
 
+#include <algorithm>
+#include <array>
 #include <fstream>
 #include <iostream>
 #include <memory>
 #include <sstream>
+#include <stdexcept>
 
 namespace prgl {
 
+namespace {
+std::shared_ptr<ProgramBinaryCache>& binaryCache() {
+  static std::shared_ptr<ProgramBinaryCache> cache = nullptr;
+  return cache;
+}
+
+std::string getResourceName(uint32_t program, uint32_t interface,
+                            uint32_t index, int32_t length) {
+  std::string name(static_cast<std::size_t>(std::max(length, 1)), '\0');
+  GLsizei written = 0;
+  glGetProgramResourceName(program, interface, index,
+                           static_cast<GLsizei>(name.size()), &written,
+                           &name[0U]);
+  name.resize(static_cast<std::size_t>(written));
+  return name;
+}
+
+bool isSamplerOrImage(uint32_t type) {
+  switch (type) {
+    case GL_SAMPLER_1D:
+    case GL_SAMPLER_2D:
+    case GL_SAMPLER_3D:
+    case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_2D_SHADOW:
+    case GL_SAMPLER_1D_ARRAY:
+    case GL_SAMPLER_2D_ARRAY:
+    case GL_SAMPLER_2D_ARRAY_SHADOW:
+    case GL_SAMPLER_2D_MULTISAMPLE:
+    case GL_SAMPLER_CUBE_SHADOW:
+    case GL_SAMPLER_BUFFER:
+    case GL_SAMPLER_2D_RECT:
+    case GL_INT_SAMPLER_2D:
+    case GL_INT_SAMPLER_3D:
+    case GL_INT_SAMPLER_2D_ARRAY:
+    case GL_UNSIGNED_INT_SAMPLER_2D:
+    case GL_UNSIGNED_INT_SAMPLER_3D:
+    case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+    case GL_IMAGE_1D:
+    case GL_IMAGE_2D:
+    case GL_IMAGE_3D:
+    case GL_IMAGE_CUBE:
+    case GL_IMAGE_2D_ARRAY:
+    case GL_IMAGE_BUFFER:
+    case GL_INT_IMAGE_2D:
+    case GL_INT_IMAGE_2D_ARRAY:
+    case GL_UNSIGNED_INT_IMAGE_2D:
+    case GL_UNSIGNED_INT_IMAGE_2D_ARRAY:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// can a value of valueType be written to a uniform of uniformType
+bool isCompatible(uint32_t uniformType, uint32_t valueType) {
+  if (uniformType == valueType) {
+    return true;
+  }
+  switch (valueType) {
+    case GL_INT:
+      return (uniformType == GL_BOOL) || isSamplerOrImage(uniformType);
+    case GL_UNSIGNED_INT:
+      return uniformType == GL_BOOL;
+    case GL_INT_VEC2:
+    case GL_UNSIGNED_INT_VEC2:
+      return uniformType == GL_BOOL_VEC2;
+    case GL_INT_VEC3:
+    case GL_UNSIGNED_INT_VEC3:
+      return uniformType == GL_BOOL_VEC3;
+    case GL_INT_VEC4:
+    case GL_UNSIGNED_INT_VEC4:
+      return uniformType == GL_BOOL_VEC4;
+    default:
+      return false;
+  }
+}
+
+void checkType(const GlslProgram::UniformHandle& handle, uint32_t valueType) {
+#ifndef NDEBUG
+  if (handle.isValid() && !isCompatible(handle.type, valueType)) {
+    std::stringstream ss;
+    ss << "GlslProgram::set: value of type 0x" << std::hex << valueType
+       << " does not match the uniform at location " << std::dec
+       << handle.location << " of type 0x" << std::hex << handle.type;
+    throw std::invalid_argument(ss.str());
+  }
+#else
+  static_cast<void>(handle);
+  static_cast<void>(valueType);
+#endif
+}
+
+bool isIdentifier(const std::string& name) {
+  const auto isAlpha = [](char c) {
+    return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+           (c == '_');
+  };
+  const auto isAlnum = [&isAlpha](char c) {
+    return isAlpha(c) || ((c >= '0') && (c <= '9'));
+  };
+  return !name.empty() && isAlpha(name.front()) &&
+         std::all_of(name.begin(), name.end(), isAlnum);
+}
+
+// position of the #version directive, npos if there is none
+std::size_t findVersion(const std::string& source) {
+  auto position = source.find("#version");
+  while (position != std::string::npos) {
+    const auto lineStart = source.find_last_of('\n', position);
+    const auto indent    = (lineStart == std::string::npos) ? 0U
+                                                             : lineStart + 1U;
+    if (source.find_first_not_of(" \t", indent) == position) {
+      return position;
+    }
+    position = source.find("#version", position + 1U);
+  }
+  return std::string::npos;
+}
+}  // namespace
+
 std::string GlslProgram::ReadShaderFromFile(const std::string& filename) {
-  std::string content;
-  std::ifstream fileStream(filename, std::ios::in);
+  std::ifstream fileStream(filename, std::ios::in | std::ios::binary);
 
   if (!fileStream.is_open()) {
     throw std::runtime_error("Could not read shader file " + filename);
   }
 
-  std::string line;
-  while (!fileStream.eof()) {
-    std::getline(fileStream, line);
-    content.append(line + "\n");
+  // read the file at once instead of line by line
+  std::string content;
+  fileStream.seekg(0, std::ios::end);
+  const auto size = fileStream.tellg();
+  if (size > 0) {
+    content.resize(static_cast<std::size_t>(size));
+    fileStream.seekg(0, std::ios::beg);
+    fileStream.read(&content[0U], size);
+  }
+  if (content.empty() || (content.back() != '\n')) {
+    content.push_back('\n');
   }
-
-  fileStream.close();
   return content;
 }
 
+std::string GlslProgram::InjectDefines(const std::string& source,
+                                       const Defines& defines) {
+  if (defines.empty()) {
+    return source;
+  }
+  std::string block;
+  for (const auto& define : defines) {
+    if (!isIdentifier(define.first)) {
+      throw std::invalid_argument(
+        "GlslProgram::InjectDefines: invalid name \"" + define.first + "\"");
+    }
+    if (define.second.find('\n') != std::string::npos) {
+      throw std::invalid_argument("GlslProgram::InjectDefines: value of " +
+                                  define.first + " spans several lines");
+    }
+    block += "#define " + define.first;
+    block += define.second.empty() ? "\n" : (" " + define.second + "\n");
+  }
+
+  // #version has to come first, without it the defines are prepended
+  std::size_t insert = 0U;
+  const auto version = findVersion(source);
+  if (version != std::string::npos) {
+    const auto end = source.find('\n', version);
+    if (end == std::string::npos) {
+      return source + "\n" + block;
+    }
+    insert = end + 1U;
+  }
+  const auto nextLine =
+    std::count(source.begin(),
+               source.begin() + static_cast<std::ptrdiff_t>(insert), '\n') +
+    1;
+  return source.substr(0U, insert) + block + "#line " +
+         std::to_string(nextLine) + "\n" + source.substr(insert);
+}
+
+void GlslProgram::SetBinaryCache(
+  const std::shared_ptr<ProgramBinaryCache>& cache) {
+  binaryCache() = cache;
+}
+
+const std::shared_ptr<ProgramBinaryCache>& GlslProgram::GetBinaryCache() {
+  return binaryCache();
+}
+
 std::shared_ptr<GlslProgram> GlslProgram::Create() {
   return std::make_shared<GlslProgram>();
 }
 
-GlslProgram::GlslProgram() : mProgHandle(INVALID_HANDLE) {
+GlslProgram::GlslProgram()
+    : mProgHandle(INVALID_HANDLE),
+      mBarrierTracker(nullptr),
+      mTrackedBindings(),
+      mUniforms(),
+      mAttributes(),
+      mUniformBlocks(),
+      mStorageBlocks(),
+      mLocations() {
   mProgHandle = glCreateProgram();
 }
 
@@ -39,19 +220,32 @@ GlslProgram::~GlslProgram() {
 }
 
 uint32_t GlslProgram::compile(const std::string& source, uint32_t type) {
+  const auto id = startCompile(source, type);
+  checkCompile(id, source);
+  return id;
+}
+
+/**
+ * @brief Submit the source to the compiler without asking for the result,
+ * drivers with parallel compilation keep working in the background.
+ */
+uint32_t GlslProgram::startCompile(const std::string& source, uint32_t type) {
   uint32_t id = glCreateShader(type);
 
   const char* c_str = source.c_str();
   glShaderSource(id, 1, &c_str, nullptr);
   glCompileShader(id);
+  return id;
+}
 
+void GlslProgram::checkCompile(uint32_t shader, const std::string& source) {
   int32_t c = 0;
 
-  glGetShaderiv(id, GL_COMPILE_STATUS, &c);
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &c);
 
   if (c == 0) {
     std::unique_ptr<GLchar[]> logstr(new GLchar[2048]);
-    glGetShaderInfoLog(id, 2048, nullptr, logstr.get());
+    glGetShaderInfoLog(shader, 2048, nullptr, logstr.get());
     std::stringstream ss;
     ss << "SHADER::Error compiling shader"
        << "\n"
@@ -59,117 +253,109 @@ uint32_t GlslProgram::compile(const std::string& source, uint32_t type) {
        << logstr.get() << std::endl;
     throw std::runtime_error(ss.str());
   }
-
-  return id;
 }
 
 void GlslProgram::seti(const std::string& label, int32_t arg) {
-  glUniform1i(glGetUniformLocation(mProgHandle, label.c_str()), arg);
+  glUniform1i(getUniformLocation(label), arg);
 }
 
 void GlslProgram::setui(const std::string& label, uint32_t arg) {
-  glUniform1ui(glGetUniformLocation(mProgHandle, label.c_str()), arg);
+  glUniform1ui(getUniformLocation(label), arg);
 }
 
 void GlslProgram::setf(const std::string& label, float arg) {
-  glUniform1f(glGetUniformLocation(mProgHandle, label.c_str()), arg);
+  glUniform1f(getUniformLocation(label), arg);
 }
 
 void GlslProgram::set2i(const std::string& label, int32_t arg1, int32_t arg2) {
-  glUniform2i(glGetUniformLocation(mProgHandle, label.c_str()), arg1, arg2);
+  glUniform2i(getUniformLocation(label), arg1, arg2);
 }
 
 void GlslProgram::set2f(const std::string& label, float arg1, float arg2) {
-  glUniform2f(glGetUniformLocation(mProgHandle, label.c_str()), arg1, arg2);
+  glUniform2f(getUniformLocation(label), arg1, arg2);
 }
 
 void GlslProgram::set2f(const std::string& label,
                         const std::array<float, 2>& v) {
-  glUniform2f(glGetUniformLocation(mProgHandle, label.c_str()), v[0], v[1]);
+  glUniform2f(getUniformLocation(label), v[0], v[1]);
 }
 
 void GlslProgram::set3i(const std::string& label, int32_t arg1, int32_t arg2,
                         int32_t arg3) {
-  glUniform3i(glGetUniformLocation(mProgHandle, label.c_str()), arg1, arg2,
-              arg3);
+  glUniform3i(getUniformLocation(label), arg1, arg2, arg3);
 }
 
 void GlslProgram::set3f(const std::string& label, float arg1, float arg2,
                         float arg3) {
-  glUniform3f(glGetUniformLocation(mProgHandle, label.c_str()), arg1, arg2,
-              arg3);
+  glUniform3f(getUniformLocation(label), arg1, arg2, arg3);
 }
 
 void GlslProgram::set3f(const std::string& label,
                         const std::array<float, 3>& v) {
-  glUniform3f(glGetUniformLocation(mProgHandle, label.c_str()), v[0], v[1],
-              v[2]);
+  glUniform3f(getUniformLocation(label), v[0], v[1], v[2]);
 }
 
 void GlslProgram::set4f(const std::string& label,
                         const std::array<float, 4>& v) {
-  glUniform4f(glGetUniformLocation(mProgHandle, label.c_str()), v[0], v[1],
-              v[2], v[3]);
+  glUniform4f(getUniformLocation(label), v[0], v[1], v[2], v[3]);
 }
 
 void GlslProgram::set4i(const std::string& label, int32_t arg1, int32_t arg2,
                         int32_t arg3, int32_t arg4) {
-  glUniform4i(glGetUniformLocation(mProgHandle, label.c_str()), arg1, arg2,
-              arg3, arg4);
+  glUniform4i(getUniformLocation(label), arg1, arg2, arg3, arg4);
 }
 
 void GlslProgram::set4f(const std::string& label, float arg1, float arg2,
                         float arg3, float arg4) {
-  glUniform4f(glGetUniformLocation(mProgHandle, label.c_str()), arg1, arg2,
-              arg3, arg4);
+  glUniform4f(getUniformLocation(label), arg1, arg2, arg3, arg4);
 }
 
 void GlslProgram::set3iv(const std::string& label, const int* args) {
-  glUniform3iv(glGetUniformLocation(mProgHandle, label.c_str()), 1, args);
+  glUniform3iv(getUniformLocation(label), 1, args);
 }
 
 void GlslProgram::set3fv(const std::string& label, const float* args) {
-  glUniform3fv(glGetUniformLocation(mProgHandle, label.c_str()), 1, args);
+  glUniform3fv(getUniformLocation(label), 1, args);
 }
 
 void GlslProgram::set4fv(const std::string& label, const float* args) {
-  glUniform4fv(glGetUniformLocation(mProgHandle, label.c_str()), 1, args);
+  glUniform4fv(getUniformLocation(label), 1, args);
 }
 
 void GlslProgram::set2(const std::string& label, const vec2f& vec) {
-  glUniform4fv(glGetUniformLocation(mProgHandle, label.c_str()), 1, &(vec[0U]));
+  glUniform2fv(getUniformLocation(label), 1, &(vec[0U]));
 }
 
 void GlslProgram::set3(const std::string& label, const vec3f& vec) {
-  glUniform4fv(glGetUniformLocation(mProgHandle, label.c_str()), 1, &(vec[0U]));
+  glUniform3fv(getUniformLocation(label), 1, &(vec[0U]));
 }
 
 void GlslProgram::set2(const std::string& label, const vec2d& vec) {
-  glUniform4dv(glGetUniformLocation(mProgHandle, label.c_str()), 1, &(vec[0U]));
+  glUniform2dv(getUniformLocation(label), 1, &(vec[0U]));
 }
 
 void GlslProgram::set3(const std::string& label, const vec3d& vec) {
-  glUniform4dv(glGetUniformLocation(mProgHandle, label.c_str()), 1, &(vec[0U]));
+  glUniform3dv(getUniformLocation(label), 1, &(vec[0U]));
 }
 
 void GlslProgram::setMatrix(const std::string& label, const float* m,
                             bool transpose) {
-  glUniformMatrix4fv(glGetUniformLocation(mProgHandle, label.c_str()), 1,
+  glUniformMatrix4fv(getUniformLocation(label), 1,
                      static_cast<GLboolean>(transpose), m);
 }
 
 void GlslProgram::setMatrix(const std::string& label, const double* m,
                             bool transpose) {
-  glUniformMatrix4dv(glGetUniformLocation(mProgHandle, label.c_str()), 1,
+  glUniformMatrix4dv(getUniformLocation(label), 1,
                      static_cast<GLboolean>(transpose), m);
 }
 
 void GlslProgram::setMatrix(const std::string& label, const mat3x3<float>& m) {
-  setMatrix(label, m.data(), true);
+  glUniformMatrix3fv(getUniformLocation(label), 1, GL_TRUE, m.data());
 }
 
 void GlslProgram::setMatrix(const std::string& label, const mat3x3<double>& m) {
-  setMatrix(label, m.data(), true);
+  glUniformMatrix3dv(getUniformLocation(label), 1, GL_TRUE, m.data());
 }
 
 void GlslProgram::setMatrix(const std::string& label, const mat4x4<float>& m) {
@@ -212,6 +398,260 @@ void GlslProgram::bindSampler(const std::string& name, const uint32_t unit,
                               const std::shared_ptr<Texture2d>& texture) {
   texture->bindUnit(unit);
   seti(name, static_cast<int32_t>(unit));
+  trackBinding(BarrierTracker::Access::TextureFetch, unit,
+               {true, texture->getId(), false});
+  const auto& tracker = texture->getBarrierTracker();
+  if (tracker && (tracker != mBarrierTracker)) {
+    // not declared by a dispatch of this program, the fetches follow the bind
+    tracker->flush(*texture, BarrierTracker::Access::TextureFetch);
+  }
+}
+
+void GlslProgram::setBarrierTracker(
+  const std::shared_ptr<BarrierTracker>& tracker) {
+  mBarrierTracker = tracker;
+}
+
+const std::shared_ptr<BarrierTracker>& GlslProgram::getBarrierTracker() const {
+  return mBarrierTracker;
+}
+
+void GlslProgram::trackBinding(BarrierTracker::Access access, uint32_t unit,
+                               const TrackedBinding& binding) {
+  mTrackedBindings[std::make_pair(access, unit)] = binding;
+}
+
+void GlslProgram::declareBindings() const {
+  if (!mBarrierTracker) {
+    return;
+  }
+  // bindings stay in place across dispatches, so each one is declared again
+  for (const auto& tracked : mTrackedBindings) {
+    const auto access   = tracked.first.first;
+    const auto& binding = tracked.second;
+    if (binding.texture) {
+      mBarrierTracker->useTexture(binding.id, access, binding.writes);
+    } else {
+      mBarrierTracker->useBuffer(binding.id, access, binding.writes);
+    }
+  }
+}
+
+void GlslProgram::reflect() {
+  mUniforms.clear();
+  mAttributes.clear();
+  mUniformBlocks.clear();
+  mStorageBlocks.clear();
+  mLocations.clear();
+
+  const std::array<GLenum, 5U> properties = {
+    GL_NAME_LENGTH, GL_TYPE, GL_LOCATION, GL_ARRAY_SIZE, GL_BLOCK_INDEX};
+  std::array<int32_t, 5U> values{};
+
+  int32_t count = 0;
+  glGetProgramInterfaceiv(mProgHandle, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+  for (auto i = 0U; i < static_cast<uint32_t>(count); i++) {
+    glGetProgramResourceiv(mProgHandle, GL_UNIFORM, i,
+                           static_cast<GLsizei>(properties.size()),
+                           properties.data(),
+                           static_cast<GLsizei>(values.size()), nullptr,
+                           values.data());
+    // members of uniform blocks have no location
+    if ((values[4U] != -1) || (values[2U] < 0)) {
+      continue;
+    }
+    Variable uniform{
+      getResourceName(mProgHandle, GL_UNIFORM, i, values[0U]), values[2U],
+      static_cast<uint32_t>(values[1U]), values[3U]};
+    mLocations[uniform.name] = uniform.location;
+
+    // arrays are reported as name[0], register the plain name and elements
+    const auto suffix = uniform.name.rfind("[0]");
+    if ((suffix != std::string::npos) &&
+        (suffix + 3U == uniform.name.size())) {
+      uniform.name.resize(suffix);
+      mLocations[uniform.name] = uniform.location;
+      for (auto e = 1; e < uniform.arraySize; e++) {
+        const auto element = uniform.name + "[" + std::to_string(e) + "]";
+        mLocations[element] =
+          glGetUniformLocation(mProgHandle, element.c_str());
+      }
+    }
+    mUniforms[uniform.name] = uniform;
+  }
+
+  glGetProgramInterfaceiv(mProgHandle, GL_PROGRAM_INPUT, GL_ACTIVE_RESOURCES,
+                          &count);
+  for (auto i = 0U; i < static_cast<uint32_t>(count); i++) {
+    glGetProgramResourceiv(mProgHandle, GL_PROGRAM_INPUT, i, 4,
+                           properties.data(), 4, nullptr, values.data());
+    // built-in inputs like gl_VertexID have no location
+    if (values[2U] < 0) {
+      continue;
+    }
+    Variable attribute{
+      getResourceName(mProgHandle, GL_PROGRAM_INPUT, i, values[0U]),
+      values[2U], static_cast<uint32_t>(values[1U]), values[3U]};
+    mAttributes[attribute.name] = attribute;
+  }
+
+  reflectBlocks(GL_UNIFORM_BLOCK, mUniformBlocks);
+  reflectBlocks(GL_SHADER_STORAGE_BLOCK, mStorageBlocks);
+}
+
+void GlslProgram::reflectBlocks(
+  uint32_t interface, std::unordered_map<std::string, Block>& blocks) const {
+  const std::array<GLenum, 3U> properties = {
+    GL_NAME_LENGTH, GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE};
+  std::array<int32_t, 3U> values{};
+
+  int32_t count = 0;
+  glGetProgramInterfaceiv(mProgHandle, interface, GL_ACTIVE_RESOURCES, &count);
+  for (auto i = 0U; i < static_cast<uint32_t>(count); i++) {
+    glGetProgramResourceiv(mProgHandle, interface, i,
+                           static_cast<GLsizei>(properties.size()),
+                           properties.data(),
+                           static_cast<GLsizei>(values.size()), nullptr,
+                           values.data());
+    Block block{getResourceName(mProgHandle, interface, i, values[0U]), i,
+                values[1U], values[2U]};
+    blocks[block.name] = block;
+  }
+}
+
+void GlslProgram::bindUniformBlock(const std::string& name, uint32_t binding) {
+  const auto it = mUniformBlocks.find(name);
+  if (it == mUniformBlocks.end()) {
+    throw std::invalid_argument("GlslProgram::bindUniformBlock: no active "
+                                "uniform block " +
+                                name);
+  }
+  glUniformBlockBinding(mProgHandle, it->second.index, binding);
+  it->second.binding = static_cast<int32_t>(binding);
+}
+
+/**
+ * @brief Location of a uniform by name. Names missing in the reflection data,
+ * e.g. struct members, are asked from the driver once and remembered.
+ */
+int32_t GlslProgram::getUniformLocation(const std::string& name) {
+  const auto it = mLocations.find(name);
+  if (it != mLocations.end()) {
+    return it->second;
+  }
+  const auto location = glGetUniformLocation(mProgHandle, name.c_str());
+  mLocations.emplace(name, location);
+  return location;
+}
+
+GlslProgram::UniformHandle GlslProgram::getUniform(
+  const std::string& name) const {
+  const auto uniform = mUniforms.find(name);
+  if (uniform != mUniforms.end()) {
+    return UniformHandle{uniform->second.location, uniform->second.type};
+  }
+  // element of an array, it has the type of the array
+  const auto bracket = name.rfind('[');
+  const auto element = mLocations.find(name);
+  if ((bracket != std::string::npos) && (element != mLocations.end())) {
+    const auto array = mUniforms.find(name.substr(0U, bracket));
+    if (array != mUniforms.end()) {
+      return UniformHandle{element->second, array->second.type};
+    }
+  }
+  return UniformHandle{};
+}
+
+void GlslProgram::set(const UniformHandle& handle, int32_t value) {
+  checkType(handle, GL_INT);
+  glProgramUniform1i(mProgHandle, handle.location, value);
+}
+
+void GlslProgram::set(const UniformHandle& handle, uint32_t value) {
+  checkType(handle, GL_UNSIGNED_INT);
+  glProgramUniform1ui(mProgHandle, handle.location, value);
+}
+
+void GlslProgram::set(const UniformHandle& handle, float value) {
+  checkType(handle, GL_FLOAT);
+  glProgramUniform1f(mProgHandle, handle.location, value);
+}
+
+void GlslProgram::set(const UniformHandle& handle, const vec2f& value) {
+  checkType(handle, GL_FLOAT_VEC2);
+  glProgramUniform2fv(mProgHandle, handle.location, 1, value.data());
+}
+
+void GlslProgram::set(const UniformHandle& handle, const vec3f& value) {
+  checkType(handle, GL_FLOAT_VEC3);
+  glProgramUniform3fv(mProgHandle, handle.location, 1, value.data());
+}
+
+void GlslProgram::set(const UniformHandle& handle, const vec4f& value) {
+  checkType(handle, GL_FLOAT_VEC4);
+  glProgramUniform4fv(mProgHandle, handle.location, 1, value.data());
+}
+
+void GlslProgram::set(const UniformHandle& handle, const vec2i& value) {
+  checkType(handle, GL_INT_VEC2);
+  glProgramUniform2iv(mProgHandle, handle.location, 1, value.data());
+}
+
+void GlslProgram::set(const UniformHandle& handle, const vec3i& value) {
+  checkType(handle, GL_INT_VEC3);
+  glProgramUniform3iv(mProgHandle, handle.location, 1, value.data());
+}
+
+void GlslProgram::set(const UniformHandle& handle, const vec4i& value) {
+  checkType(handle, GL_INT_VEC4);
+  glProgramUniform4iv(mProgHandle, handle.location, 1, value.data());
+}
+
+void GlslProgram::set(const UniformHandle& handle, const vec2ui& value) {
+  checkType(handle, GL_UNSIGNED_INT_VEC2);
+  glProgramUniform2uiv(mProgHandle, handle.location, 1, value.data());
+}
+
+void GlslProgram::set(const UniformHandle& handle, const vec3ui& value) {
+  checkType(handle, GL_UNSIGNED_INT_VEC3);
+  glProgramUniform3uiv(mProgHandle, handle.location, 1, value.data());
+}
+
+void GlslProgram::set(const UniformHandle& handle, const vec4ui& value) {
+  checkType(handle, GL_UNSIGNED_INT_VEC4);
+  glProgramUniform4uiv(mProgHandle, handle.location, 1, value.data());
+}
+
+void GlslProgram::set(const UniformHandle& handle, const mat3x3<float>& value) {
+  checkType(handle, GL_FLOAT_MAT3);
+  glProgramUniformMatrix3fv(mProgHandle, handle.location, 1, GL_TRUE,
+                            value.data());
+}
+
+void GlslProgram::set(const UniformHandle& handle, const mat4x4<float>& value) {
+  checkType(handle, GL_FLOAT_MAT4);
+  glProgramUniformMatrix4fv(mProgHandle, handle.location, 1, GL_TRUE,
+                            value.data());
+}
+
+const std::unordered_map<std::string, GlslProgram::Variable>&
+GlslProgram::getUniforms() const {
+  return mUniforms;
+}
+
+const std::unordered_map<std::string, GlslProgram::Variable>&
+GlslProgram::getAttributes() const {
+  return mAttributes;
+}
+
+const std::unordered_map<std::string, GlslProgram::Block>&
+GlslProgram::getUniformBlocks() const {
+  return mUniformBlocks;
+}
+
+const std::unordered_map<std::string, GlslProgram::Block>&
+GlslProgram::getStorageBlocks() const {
+  return mStorageBlocks;
 }
 
 }  // namespace prgl
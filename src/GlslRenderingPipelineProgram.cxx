@@ -2,9 +2,28 @@
 
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 
 namespace prgl {
 
+namespace {
+// true if GL_KHR_parallel_shader_compile is available
+bool hasParallelCompile() {
+  return GLEW_KHR_parallel_shader_compile != GL_FALSE;
+}
+
+/**
+ * @brief Let the driver use as many compiler threads as it likes. The limit
+ * is state of the current context, so it is set before every compile instead
+ * of once per process.
+ */
+void enableParallelCompile() {
+  if (hasParallelCompile()) {
+    glMaxShaderCompilerThreadsKHR(0xFFFFFFFFU);
+  }
+}
+}  // namespace
+
 std::shared_ptr<GlslRenderingPipelineProgram>
 GlslRenderingPipelineProgram::Create() {
   return std::make_shared<GlslRenderingPipelineProgram>();
@@ -15,19 +34,80 @@ GlslRenderingPipelineProgram::GlslRenderingPipelineProgram()
       mTesselationControlProg(INVALID_HANDLE),
       mTesselationEvaluationProg(INVALID_HANDLE),
       mGeometryProg(INVALID_HANDLE),
-      mFragProg(INVALID_HANDLE) {}
+      mFragProg(INVALID_HANDLE),
+      mSources(),
+      mCacheKey(),
+      mPending(false) {}
 
-uint32_t GlslRenderingPipelineProgram::createShader(const std::string& source,
-                                                    GLenum shaderType) {
-  uint32_t shader = compile(source, shaderType);
+void GlslRenderingPipelineProgram::build(
+  const std::map<uint32_t, std::string>& sources, bool wait) {
+  if (sources.empty()) {
+    throw std::runtime_error("GlslRenderingPipelineProgram::build: no stages");
+  }
+  for (const auto& stage : sources) {
+    // throws for types that are not a rendering pipeline stage
+    static_cast<void>(getShader(stage.first));
+    if (stage.second.empty()) {
+      throw std::runtime_error(
+        "GlslRenderingPipelineProgram::build: source empty");
+    }
+  }
 
-  glAttachShader(mProgHandle, shader);
+  cleanupShader(mVertProg);
+  cleanupShader(mTesselationControlProg);
+  cleanupShader(mTesselationEvaluationProg);
+  cleanupShader(mGeometryProg);
+  cleanupShader(mFragProg);
+  mSources = sources;
+
+  link();
+  if (wait) {
+    finish();
+  }
+}
+
+void GlslRenderingPipelineProgram::build(
+  const std::map<uint32_t, std::string>& sources, const Defines& defines,
+  bool wait) {
+  auto specialized = sources;
+  for (auto& stage : specialized) {
+    stage.second = InjectDefines(stage.second, defines);
+  }
+  build(specialized, wait);
+}
+
+bool GlslRenderingPipelineProgram::isLinkComplete() const {
+  if (!mPending) {
+    return true;
+  }
+  if (hasParallelCompile()) {
+    int32_t complete = 0;
+    glGetProgramiv(mProgHandle, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete != 0;
+  }
+  // without the extension any status query blocks, leave it to finish()
+  return true;
+}
+
+void GlslRenderingPipelineProgram::finish() {
+  if (!mPending) {
+    return;
+  }
+  mPending = false;
 
-  glLinkProgram(mProgHandle);
   int32_t linkV = 0;
   glGetProgramiv(mProgHandle, GL_LINK_STATUS, &linkV);
 
   if (linkV == 0) {
+    // report the first stage that did not compile
+    for (const auto& stage : mSources) {
+      checkCompile(getShader(stage.first), stage.second);
+    }
+
+    std::string source;
+    for (const auto& stage : mSources) {
+      source += stage.second + "\n";
+    }
     std::cerr << "Error in linking GlslRenderingPipelineProgram program"
               << std::endl;
     GLchar log[10240];
@@ -42,7 +122,69 @@ uint32_t GlslRenderingPipelineProgram::createShader(const std::string& source,
     throw std::runtime_error(ss.str());
   }
 
-  return shader;
+  const auto& cache = GetBinaryCache();
+  if (cache) {
+    cache->store(mProgHandle, mCacheKey);
+  }
+  reflect();
+}
+
+void GlslRenderingPipelineProgram::createShader(const std::string& source,
+                                                GLenum shaderType) {
+  mSources[shaderType] = source;
+  link();
+  finish();
+}
+
+/**
+ * @brief Link the program with all stages, from the binary cache if possible.
+ * Neither compile nor link status are queried here, see finish().
+ */
+void GlslRenderingPipelineProgram::link() {
+  mPending = false;
+  mCacheKey = ProgramBinaryCache::Key();
+
+  const auto& cache = GetBinaryCache();
+  if (cache) {
+    mCacheKey = cache->makeKey(mSources);
+    if (cache->load(mProgHandle, mCacheKey)) {
+      reflect();
+      return;
+    }
+    glProgramParameteri(mProgHandle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                        GL_TRUE);
+  }
+
+  enableParallelCompile();
+  // stages restored from a cached binary have not been compiled yet
+  for (const auto& stage : mSources) {
+    auto& shader = getShader(stage.first);
+    if (shader == INVALID_HANDLE) {
+      shader = startCompile(stage.second, stage.first);
+      glAttachShader(mProgHandle, shader);
+    }
+  }
+
+  glLinkProgram(mProgHandle);
+  mPending = true;
+}
+
+uint32_t& GlslRenderingPipelineProgram::getShader(GLenum shaderType) {
+  switch (shaderType) {
+    case GL_VERTEX_SHADER:
+      return mVertProg;
+    case GL_TESS_CONTROL_SHADER:
+      return mTesselationControlProg;
+    case GL_TESS_EVALUATION_SHADER:
+      return mTesselationEvaluationProg;
+    case GL_GEOMETRY_SHADER:
+      return mGeometryProg;
+    case GL_FRAGMENT_SHADER:
+      return mFragProg;
+    default:
+      throw std::invalid_argument(
+        "GlslRenderingPipelineProgram: unsupported shader type");
+  }
 }
 
 void GlslRenderingPipelineProgram::cleanupShader(uint32_t& shader) {
@@ -70,7 +212,7 @@ void GlslRenderingPipelineProgram::attachVertexShader(
   if (!source.empty()) {
     cleanupShader(mVertProg);
 
-    mVertProg = createShader(source, GL_VERTEX_SHADER);
+    createShader(source, GL_VERTEX_SHADER);
   } else {
     std::stringstream ss;
     ss << "VertexShader() : source empty: " << source << std::endl;
@@ -83,7 +225,7 @@ void GlslRenderingPipelineProgram::attachTesselationControlShader(
   if (!source.empty()) {
     cleanupShader(mTesselationControlProg);
 
-    mTesselationControlProg = createShader(source, GL_TESS_CONTROL_SHADER);
+    createShader(source, GL_TESS_CONTROL_SHADER);
   } else {
     std::stringstream ss;
     ss << "TesselationControlShader() : source empty: " << source << std::endl;
@@ -96,8 +238,7 @@ void GlslRenderingPipelineProgram::attachTesselationEvaluationShader(
   if (!source.empty()) {
     cleanupShader(mTesselationEvaluationProg);
 
-    mTesselationEvaluationProg =
-      createShader(source, GL_TESS_EVALUATION_SHADER);
+    createShader(source, GL_TESS_EVALUATION_SHADER);
   } else {
     std::stringstream ss;
     ss << "TesselationEvaluationShader() : source empty: " << source
@@ -111,7 +252,7 @@ void GlslRenderingPipelineProgram::attachGeometryShader(
   if (!source.empty()) {
     cleanupShader(mGeometryProg);
 
-    mGeometryProg = createShader(source, GL_GEOMETRY_SHADER);
+    createShader(source, GL_GEOMETRY_SHADER);
   } else {
     std::stringstream ss;
     ss << "GeometryShader() : source empty: " << source << std::endl;
@@ -124,7 +265,7 @@ void GlslRenderingPipelineProgram::attachFragmentShader(
   if (!source.empty()) {
     cleanupShader(mFragProg);
 
-    mFragProg = createShader(source, GL_FRAGMENT_SHADER);
+    createShader(source, GL_FRAGMENT_SHADER);
   } else {
     std::stringstream ss;
     ss << "FragmentShader() : source empty: " << source << std::endl;
@@ -0,0 +1,39 @@
+/**
+ * @file Hash.hxx
+ * @author Thomas Lindemeier
+ * @brief FNV-1a hashing shared by the program caches, not installed.
+ * @date 2026-10-17
+ *
+ */
+#ifndef PRGL_HASH_H
+#define PRGL_HASH_H
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <string>
+
+namespace prgl {
+
+// FNV-1a offset basis, the hash of no bytes
+constexpr uint64_t HashSeed = 0xCBF29CE484222325ULL;
+
+inline uint64_t hashBytes(uint64_t hash, const void* data, std::size_t size) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  for (std::size_t i = 0U; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001B3ULL;
+  }
+  return hash;
+}
+
+inline uint64_t hashString(uint64_t hash, const std::string& value) {
+  // hash the size too so that ("ab", "c") and ("a", "bc") differ
+  const uint64_t size = value.size();
+  hash                = hashBytes(hash, &size, sizeof(size));
+  return hashBytes(hash, value.data(), value.size());
+}
+
+}  // namespace prgl
+
+#endif  // PRGL_HASH_H
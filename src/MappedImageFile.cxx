@@ -0,0 +1,348 @@
+#include "prgl/MappedImageFile.hxx"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include "prgl/PersistentBufferRing.hxx"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PRGL_HAS_MMAP
+#endif
+
+namespace prgl {
+
+namespace {
+bool isHostBigEndian() {
+  const uint16_t probe = 1U;
+  uint8_t first        = 0U;
+  std::memcpy(&first, &probe, 1U);
+  return first == 0U;
+}
+
+/**
+ * @brief Reads the whitespace separated tokens of a PNM/PFM header.
+ */
+class HeaderReader final {
+ public:
+  HeaderReader(const uint8_t* data, std::size_t size)
+      : mData(data), mSize(size), mPosition(0U) {}
+
+  std::string next() {
+    // skip whitespace and comments
+    while (mPosition < mSize) {
+      if (mData[mPosition] == '#') {
+        while ((mPosition < mSize) && (mData[mPosition] != '\n')) {
+          mPosition++;
+        }
+      } else if (std::isspace(mData[mPosition]) != 0) {
+        mPosition++;
+      } else {
+        break;
+      }
+    }
+    std::string token;
+    while ((mPosition < mSize) && (std::isspace(mData[mPosition]) == 0)) {
+      token.push_back(static_cast<char>(mData[mPosition]));
+      mPosition++;
+    }
+    if (token.empty()) {
+      throw std::runtime_error("MappedImageFile: truncated header");
+    }
+    return token;
+  }
+
+  // the pixel data starts after the single whitespace ending the header
+  std::size_t dataOffset() const {
+    return mPosition + 1U;
+  }
+
+ private:
+  const uint8_t* mData;
+  std::size_t mSize;
+  std::size_t mPosition;
+};
+
+uint32_t toDimension(const std::string& token) {
+  char* end         = nullptr;
+  const auto value  = std::strtoul(token.c_str(), &end, 10);
+  const auto parsed = static_cast<std::size_t>(end - token.c_str());
+  if ((parsed != token.size()) || (value == 0UL)) {
+    throw std::runtime_error("MappedImageFile: invalid image size " + token);
+  }
+  return static_cast<uint32_t>(value);
+}
+}  // namespace
+
+MappedImageFile::MappedImageFile(const std::string& path)
+    : mFile(-1),
+      mMapped(nullptr),
+      mFileSize(0U),
+      mDataOffset(0U),
+      mWidth(0U),
+      mHeight(0U),
+      mFormat(TextureFormat::Rgb),
+      mType(DataType::UnsignedByte),
+      mRowSize(0U),
+      mBigEndian(false),
+      mTopDown(true) {
+  map(path);
+  // the destructor does not run if the constructor throws
+  try {
+    parseHeader();
+    validate();
+  } catch (...) {
+    unmap();
+    throw;
+  }
+}
+
+MappedImageFile::MappedImageFile(const std::string& path,
+                                 const RawLayout& layout)
+    : mFile(-1),
+      mMapped(nullptr),
+      mFileSize(0U),
+      mDataOffset(layout.headerSize),
+      mWidth(layout.width),
+      mHeight(layout.height),
+      mFormat(layout.format),
+      mType(layout.type),
+      mRowSize(static_cast<std::size_t>(layout.width) *
+               getChannelCount(layout.format) * getSizeInBytes(layout.type)),
+      mBigEndian(layout.bigEndian),
+      mTopDown(layout.topDown) {
+  map(path);
+  try {
+    validate();
+  } catch (...) {
+    unmap();
+    throw;
+  }
+}
+
+MappedImageFile::~MappedImageFile() {
+  unmap();
+}
+
+void MappedImageFile::unmap() {
+#if defined(PRGL_HAS_MMAP)
+  if (mMapped != nullptr) {
+    munmap(mMapped, mFileSize);
+    mMapped = nullptr;
+  }
+  if (mFile >= 0) {
+    close(mFile);
+    mFile = -1;
+  }
+#endif
+}
+
+void MappedImageFile::map(const std::string& path) {
+#if defined(PRGL_HAS_MMAP)
+  mFile = open(path.c_str(), O_RDONLY);
+  if (mFile < 0) {
+    throw std::runtime_error("MappedImageFile: cannot open " + path);
+  }
+  struct stat status;
+  if ((fstat(mFile, &status) != 0) || (status.st_size <= 0)) {
+    close(mFile);
+    mFile = -1;
+    throw std::runtime_error("MappedImageFile: cannot read the size of " +
+                             path);
+  }
+  mFileSize = static_cast<std::size_t>(status.st_size);
+
+  void* mapped = mmap(nullptr, mFileSize, PROT_READ, MAP_PRIVATE, mFile, 0);
+  if (mapped == MAP_FAILED) {
+    close(mFile);
+    mFile = -1;
+    throw std::runtime_error("MappedImageFile: cannot map " + path);
+  }
+  mMapped = static_cast<uint8_t*>(mapped);
+#else
+  throw std::runtime_error("MappedImageFile: memory mapping of " + path +
+                           " is not supported on this platform");
+#endif
+}
+
+void MappedImageFile::parseHeader() {
+  HeaderReader reader(mMapped, mFileSize);
+  const auto magic = reader.next();
+  auto channels    = 0U;
+  if ((magic == "P5") || (magic == "P6")) {
+    channels           = (magic == "P5") ? 1U : 3U;
+    mWidth             = toDimension(reader.next());
+    mHeight            = toDimension(reader.next());
+    const auto maximum = toDimension(reader.next());
+    // 16 bit samples are stored most significant byte first
+    mType      = (maximum < 256U) ? DataType::UnsignedByte
+                                  : DataType::UnsignedShort;
+    mBigEndian = true;
+    mTopDown   = true;
+  } else if ((magic == "Pf") || (magic == "PF")) {
+    channels         = (magic == "Pf") ? 1U : 3U;
+    mWidth           = toDimension(reader.next());
+    mHeight          = toDimension(reader.next());
+    const auto scale = std::strtod(reader.next().c_str(), nullptr);
+    // the sign of the scale gives the byte order, rows are stored bottom up
+    mType      = DataType::Float;
+    mBigEndian = scale > 0.0;
+    mTopDown   = false;
+  } else {
+    throw std::runtime_error("MappedImageFile: unsupported file type " +
+                             magic);
+  }
+
+  mFormat     = (channels == 1U) ? TextureFormat::Red : TextureFormat::Rgb;
+  mDataOffset = reader.dataOffset();
+  mRowSize    = static_cast<std::size_t>(mWidth) * channels *
+             getSizeInBytes(mType);
+}
+
+void MappedImageFile::validate() const {
+  if ((mWidth == 0U) || (mHeight == 0U) || (mRowSize == 0U)) {
+    throw std::invalid_argument("MappedImageFile: empty image");
+  }
+  if ((mDataOffset + (mRowSize * mHeight)) > mFileSize) {
+    throw std::runtime_error("MappedImageFile: file is truncated");
+  }
+}
+
+void MappedImageFile::advise(Advice advice) const {
+  advise(advice, 0U, mHeight);
+}
+
+void MappedImageFile::advise(Advice advice, uint32_t firstRow,
+                             uint32_t rowCount) const {
+#if defined(PRGL_HAS_MMAP)
+  if (firstRow >= mHeight) {
+    return;
+  }
+  rowCount = std::min(rowCount, mHeight - firstRow);
+
+  // madvise works on whole pages
+  const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  const auto begin    = mDataOffset + (firstRow * mRowSize);
+  const auto end      = begin + (rowCount * mRowSize);
+  const auto first    = (begin / pageSize) * pageSize;
+
+  int hint = MADV_NORMAL;
+  switch (advice) {
+    case Advice::Normal:
+      hint = MADV_NORMAL;
+      break;
+    case Advice::Sequential:
+      hint = MADV_SEQUENTIAL;
+      break;
+    case Advice::Random:
+      hint = MADV_RANDOM;
+      break;
+    case Advice::WillNeed:
+      hint = MADV_WILLNEED;
+      break;
+    case Advice::DontNeed:
+      hint = MADV_DONTNEED;
+      break;
+  }
+  // only a hint, failing is not an error
+  madvise(mMapped + first, end - first, hint);
+#else
+  static_cast<void>(advice);
+  static_cast<void>(firstRow);
+  static_cast<void>(rowCount);
+#endif
+}
+
+void MappedImageFile::upload(Texture2d& texture, uint32_t bandRows,
+                             uint32_t ringSize) const {
+  if ((texture.getWidth() != mWidth) || (texture.getHeight() != mHeight) ||
+      (texture.getFormat() != mFormat) || (texture.getType() != mType)) {
+    throw std::invalid_argument(
+      "MappedImageFile::upload: texture size, format or type do not match");
+  }
+
+  const auto rowsPerBand = std::clamp(bandRows, 1U, mHeight);
+  PersistentBufferRing ring(GL_PIXEL_UNPACK_BUFFER, rowsPerBand * mRowSize,
+                            ringSize, PersistentBufferRing::Access::Write);
+
+  // let the driver fix the byte order while copying into the texture
+  int32_t swapBytes = 0;
+  glGetIntegerv(GL_UNPACK_SWAP_BYTES, &swapBytes);
+  const auto swap = (getSizeInBytes(mType) > 1U) &&
+                    (mBigEndian != isHostBigEndian());
+  glPixelStorei(GL_UNPACK_SWAP_BYTES, swap ? GL_TRUE : GL_FALSE);
+
+  advise(Advice::Sequential);
+  for (auto first = 0U; first < mHeight; first += rowsPerBand) {
+    const auto rows = std::min(rowsPerBand, mHeight - first);
+    // let the kernel read ahead the next band while this one is copied
+    advise(Advice::WillNeed, first + rows, rowsPerBand);
+
+    const auto slot = ring.acquire();
+    auto* band      = static_cast<uint8_t*>(ring.getMappedSlot(slot));
+    auto y          = first;
+    if (mTopDown) {
+      // texture rows go bottom up, reverse the rows of the band
+      for (auto r = 0U; r < rows; r++) {
+        std::memcpy(band + (r * mRowSize), getRow(first + rows - 1U - r),
+                    mRowSize);
+      }
+      y = mHeight - first - rows;
+    } else {
+      std::memcpy(band, getRow(first), rows * mRowSize);
+    }
+
+    ring.bind(true);
+    // the data pointer is an offset into the bound pixel unpack buffer
+    texture.uploadRegion(
+      0U, y, mWidth, rows, 0U,
+      reinterpret_cast<const void*>(ring.getSlotOffset(slot)));
+    ring.bind(false);
+    ring.fence(slot);
+
+    // the band is in the upload buffer, drop its pages from the mapping
+    advise(Advice::DontNeed, first, rows);
+  }
+
+  glPixelStorei(GL_UNPACK_SWAP_BYTES, swapBytes);
+}
+
+const uint8_t* MappedImageFile::getRow(uint32_t row) const {
+  return mMapped + mDataOffset + (static_cast<std::size_t>(row) * mRowSize);
+}
+
+uint32_t MappedImageFile::getWidth() const {
+  return mWidth;
+}
+
+uint32_t MappedImageFile::getHeight() const {
+  return mHeight;
+}
+
+TextureFormat MappedImageFile::getFormat() const {
+  return mFormat;
+}
+
+DataType MappedImageFile::getType() const {
+  return mType;
+}
+
+std::size_t MappedImageFile::getRowSize() const {
+  return mRowSize;
+}
+
+bool MappedImageFile::isBigEndian() const {
+  return mBigEndian;
+}
+
+bool MappedImageFile::isTopDown() const {
+  return mTopDown;
+}
+
+}  // namespace prgl
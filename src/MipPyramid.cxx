@@ -0,0 +1,162 @@
+#include "prgl/MipPyramid.hxx"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace prgl {
+
+namespace {
+const char* const MipPyramidShader = R"(
+  #version 430
+
+  layout(local_size_x = 8, local_size_y = 8) in;
+
+  uniform sampler2D source;
+  uniform int sourceLevel;
+  uniform int filterMode;
+  // separable kernel of the Kaiser filter
+  uniform float weights[6];
+
+  layout(binding = 0) writeonly uniform image2D destination;
+
+  void main()
+  {
+    const ivec2 position = ivec2(gl_GlobalInvocationID.xy);
+    const ivec2 size     = imageSize(destination);
+    if (any(greaterThanEqual(position, size))) {
+      return;
+    }
+    const ivec2 sourceSize = textureSize(source, sourceLevel);
+
+    vec4 result = vec4(0.0);
+    if (filterMode == 1) {
+      for (int j = 0; j < 6; ++j) {
+        for (int i = 0; i < 6; ++i) {
+          const ivec2 p = clamp(2 * position + ivec2(i - 2, j - 2), ivec2(0),
+                                sourceSize - 1);
+          result += weights[i] * weights[j] * texelFetch(source, p,
+                                                         sourceLevel);
+        }
+      }
+    } else {
+      // texels covered by the destination texel, 3 per axis for odd sizes
+      const ivec2 first = (position * sourceSize) / size;
+      const ivec2 last =
+        min(((position + 1) * sourceSize + size - 1) / size, sourceSize) - 1;
+
+      result = texelFetch(source, first, sourceLevel);
+      vec4 sum = vec4(0.0);
+      for (int y = first.y; y <= last.y; ++y) {
+        for (int x = first.x; x <= last.x; ++x) {
+          const vec4 texel = texelFetch(source, ivec2(x, y), sourceLevel);
+          sum += texel;
+          result = (filterMode == 2) ? max(result, texel)
+                                     : ((filterMode == 3) ? min(result, texel)
+                                                          : result);
+        }
+      }
+      if (filterMode == 0) {
+        const ivec2 count = last - first + 1;
+        result = sum / float(count.x * count.y);
+      }
+    }
+    imageStore(destination, position, result);
+  }
+)";
+
+// zeroth order modified Bessel function of the first kind
+double besselI0(double x) {
+  auto sum  = 1.0;
+  auto term = 1.0;
+  for (auto k = 1; k < 32; k++) {
+    const auto factor = x / (2.0 * k);
+    term *= factor * factor;
+    sum += term;
+  }
+  return sum;
+}
+
+/**
+ * @brief Weights of the 6 source texels around a destination texel for a
+ * Kaiser windowed sinc with a radius of 1.5 destination texels.
+ */
+std::array<float, 6U> kaiserWeights() {
+  constexpr auto Alpha  = 4.0;
+  constexpr auto Radius = 1.5;
+  constexpr auto Pi     = 3.14159265358979323846;
+
+  std::array<double, 6U> weights;
+  auto sum = 0.0;
+  for (auto k = 0U; k < weights.size(); k++) {
+    // distance of the source texel center in destination texels
+    const auto x      = (static_cast<double>(k) - 2.5) * 0.5;
+    const auto sinc   = std::sin(Pi * x) / (Pi * x);
+    const auto ratio  = x / Radius;
+    const auto window = besselI0(Alpha * std::sqrt(1.0 - (ratio * ratio))) /
+                        besselI0(Alpha);
+    weights[k] = sinc * window;
+    sum += weights[k];
+  }
+
+  std::array<float, 6U> normalized;
+  for (auto k = 0U; k < weights.size(); k++) {
+    normalized[k] = static_cast<float>(weights[k] / sum);
+  }
+  return normalized;
+}
+}  // namespace
+
+std::shared_ptr<MipPyramid> MipPyramid::Create() {
+  return std::make_shared<MipPyramid>();
+}
+
+MipPyramid::MipPyramid()
+    : mShader(GlslComputeShader::Create(MipPyramidShader)) {}
+
+MipPyramid::~MipPyramid() = default;
+
+void MipPyramid::generate(const std::shared_ptr<Texture2d>& texture,
+                          MipFilter filter) {
+  const auto format = texture->getInternalFormat();
+  if (!isSizedFormat(format) || isCompressedFormat(format)) {
+    throw std::invalid_argument(
+      "MipPyramid::generate: texture needs a sized uncompressed format");
+  }
+
+  const auto levels = texture->getMipLevelCount();
+  if (levels < 2U) {
+    return;
+  }
+
+  mShader->bind(true);
+  mShader->seti("filterMode", static_cast<int32_t>(filter));
+  if (filter == MipFilter::Kaiser) {
+    const auto weights = kaiserWeights();
+    for (auto k = 0U; k < weights.size(); k++) {
+      mShader->setf("weights[" + std::to_string(k) + "]", weights[k]);
+    }
+  }
+  mShader->bindSampler("source", 0U, texture);
+
+  for (auto level = 1U; level < levels; level++) {
+    const auto width  = std::max(1U, texture->getWidth() >> level);
+    const auto height = std::max(1U, texture->getHeight() >> level);
+
+    mShader->seti("sourceLevel", static_cast<int32_t>(level - 1U));
+    mShader->bindImage2D(0U, texture, TextureAccess::WriteOnly,
+                         static_cast<int32_t>(level));
+    const auto groups = mShader->getGroupCount(width, height);
+    mShader->dispatchCompute(groups[0U], groups[1U], 1U);
+    // the next level fetches the texels stored by this one
+    mShader->memoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+  }
+  mShader->memoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT |
+                         GL_FRAMEBUFFER_BARRIER_BIT);
+
+  mShader->bind(false);
+}
+
+}  // namespace prgl
@@ -0,0 +1,635 @@
+#include "prgl/ParallelPrimitives.hxx"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace prgl {
+
+namespace {
+// elements scanned by one work group, two per invocation
+constexpr auto ScanBlockSize = 512U;
+// elements per work group of the radix sort, histogram and compaction
+constexpr auto TileSize = 1024U;
+constexpr auto GroupSize = 256U;
+constexpr auto RadixBits = 4U;
+constexpr auto RadixSize = 1U << RadixBits;
+// larger grids are folded into the y dimension
+constexpr auto MaxGroupsX = 65535U;
+
+// large dispatches use two dimensions, see dispatch()
+const char* const Common = R"(
+  #version 430
+
+  uint groupIndex()
+  {
+    return gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+  }
+)";
+
+// work efficient (Blelloch) scan of 512 elements in shared memory
+const char* const ScanShader = R"(
+  layout(local_size_x = 256) in;
+
+  layout(std430, binding = 0) buffer Data
+  {
+    uint data[];
+  };
+  layout(std430, binding = 1) writeonly buffer Sums
+  {
+    uint sums[];
+  };
+
+  uniform uint offset;
+  uniform uint count;
+  uniform bool inclusive;
+  uniform bool writeSums;
+
+  shared uint temp[512];
+
+  void main()
+  {
+    const uint local = gl_LocalInvocationID.x;
+    const uint block = groupIndex();
+    const uint i0    = block * 512u + local;
+    const uint i1    = i0 + 256u;
+    const uint a     = (i0 < count) ? data[offset + i0] : 0u;
+    const uint b     = (i1 < count) ? data[offset + i1] : 0u;
+    temp[local]        = a;
+    temp[local + 256u] = b;
+
+    uint stride = 1u;
+    for (uint d = 256u; d > 0u; d >>= 1u) {
+      barrier();
+      if (local < d) {
+        temp[stride * (2u * local + 2u) - 1u] +=
+          temp[stride * (2u * local + 1u) - 1u];
+      }
+      stride <<= 1u;
+    }
+    barrier();
+    if (local == 0u) {
+      if (writeSums && (block * 512u < count)) {
+        sums[block] = temp[511];
+      }
+      temp[511] = 0u;
+    }
+    for (uint d = 1u; d < 512u; d <<= 1u) {
+      stride >>= 1u;
+      barrier();
+      if (local < d) {
+        const uint left  = stride * (2u * local + 1u) - 1u;
+        const uint right = stride * (2u * local + 2u) - 1u;
+        const uint t     = temp[left];
+        temp[left]  = temp[right];
+        temp[right] += t;
+      }
+    }
+    barrier();
+
+    if (i0 < count) {
+      data[offset + i0] = temp[local] + (inclusive ? a : 0u);
+    }
+    if (i1 < count) {
+      data[offset + i1] = temp[local + 256u] + (inclusive ? b : 0u);
+    }
+  }
+)";
+
+// adds the scanned block sums to the elements of each block
+const char* const AddShader = R"(
+  layout(local_size_x = 256) in;
+
+  layout(std430, binding = 0) buffer Data
+  {
+    uint data[];
+  };
+  layout(std430, binding = 1) readonly buffer Sums
+  {
+    uint sums[];
+  };
+
+  uniform uint offset;
+  uniform uint count;
+
+  void main()
+  {
+    const uint i = groupIndex() * 256u + gl_LocalInvocationID.x;
+    if (i < count) {
+      data[offset + i] += sums[i / 512u];
+    }
+  }
+)";
+
+// digit histogram of each tile, stored digit major for a single scan
+const char* const CountShader = R"(
+  layout(local_size_x = 256) in;
+
+  layout(std430, binding = 0) readonly buffer Keys
+  {
+    uint keys[];
+  };
+  layout(std430, binding = 1) writeonly buffer Counts
+  {
+    uint counts[];
+  };
+
+  uniform uint offset;
+  uniform uint count;
+  uniform uint shift;
+  uniform uint tileCount;
+
+  shared uint histogram[16];
+
+  void main()
+  {
+    const uint local = gl_LocalInvocationID.x;
+    const uint tile  = groupIndex();
+    if (local < 16u) {
+      histogram[local] = 0u;
+    }
+    barrier();
+    for (uint k = 0u; k < 4u; ++k) {
+      const uint i = tile * 1024u + k * 256u + local;
+      if (i < count) {
+        atomicAdd(histogram[(keys[offset + i] >> shift) & 15u], 1u);
+      }
+    }
+    barrier();
+    if ((local < 16u) && (tile < tileCount)) {
+      counts[local * tileCount + tile] = histogram[local];
+    }
+  }
+)";
+
+// stable scatter, ranks inside a tile come from a scan of 16 counters packed
+// into 8 bit lanes of a uvec4, an exclusive rank never exceeds 255
+const char* const ScatterShader = R"(
+  layout(local_size_x = 256) in;
+
+  layout(std430, binding = 0) readonly buffer KeysIn
+  {
+    uint keysIn[];
+  };
+  layout(std430, binding = 1) writeonly buffer KeysOut
+  {
+    uint keysOut[];
+  };
+  layout(std430, binding = 2) readonly buffer ValuesIn
+  {
+    uint valuesIn[];
+  };
+  layout(std430, binding = 3) writeonly buffer ValuesOut
+  {
+    uint valuesOut[];
+  };
+  layout(std430, binding = 4) readonly buffer Offsets
+  {
+    uint offsets[];
+  };
+
+  uniform uint inOffset;
+  uniform uint outOffset;
+  uniform uint count;
+  uniform uint shift;
+  uniform uint tileCount;
+  uniform bool hasValues;
+
+  shared uvec4 ranks[256];
+  shared uint digitOffset[16];
+  shared uint totals[16];
+
+  uint lane(uvec4 packed, uint digit)
+  {
+    return (packed[digit >> 2u] >> ((digit & 3u) * 8u)) & 255u;
+  }
+
+  void main()
+  {
+    const uint local = gl_LocalInvocationID.x;
+    const uint tile  = groupIndex();
+    if ((local < 16u) && (tile < tileCount)) {
+      digitOffset[local] = offsets[local * tileCount + tile];
+    }
+    barrier();
+
+    for (uint k = 0u; k < 4u; ++k) {
+      const uint i      = tile * 1024u + k * 256u + local;
+      const bool valid  = i < count;
+      const uint key    = valid ? keysIn[inOffset + i] : 0u;
+      const uint digit  = (key >> shift) & 15u;
+      uvec4 flag        = uvec4(0u);
+      if (valid) {
+        flag[digit >> 2u] = 1u << ((digit & 3u) * 8u);
+      }
+      ranks[local] = flag;
+      barrier();
+      for (uint s = 1u; s < 256u; s <<= 1u) {
+        const uvec4 before = (local >= s) ? ranks[local - s] : uvec4(0u);
+        barrier();
+        ranks[local] += before;
+        barrier();
+      }
+      const uvec4 exclusive = ranks[local] - flag;
+
+      if (valid) {
+        const uint rank = digitOffset[digit] + lane(exclusive, digit);
+        keysOut[outOffset + rank] = key;
+        if (hasValues) {
+          valuesOut[outOffset + rank] = valuesIn[inOffset + i];
+        }
+      }
+      if (local == 255u) {
+        for (uint d = 0u; d < 16u; ++d) {
+          totals[d] = lane(exclusive, d) + ((valid && (digit == d)) ? 1u : 0u);
+        }
+      }
+      barrier();
+      if (local < 16u) {
+        digitOffset[local] += totals[local];
+      }
+      barrier();
+    }
+  }
+)";
+
+const char* const HistogramShader = R"(
+  layout(local_size_x = 256) in;
+
+  layout(std430, binding = 0) readonly buffer Values
+  {
+    uint values[];
+  };
+  layout(std430, binding = 1) buffer Bins
+  {
+    uint bins[];
+  };
+
+  uniform uint offset;
+  uniform uint count;
+  uniform uint binCount;
+  uniform uint binWidth;
+
+  shared uint localBins[256];
+
+  void main()
+  {
+    const uint local = gl_LocalInvocationID.x;
+    localBins[local] = 0u;
+    barrier();
+    for (uint k = 0u; k < 4u; ++k) {
+      const uint i = groupIndex() * 1024u + k * 256u + local;
+      if (i < count) {
+        const uint bin = min(values[offset + i] / binWidth, binCount - 1u);
+        atomicAdd(localBins[bin], 1u);
+      }
+    }
+    barrier();
+
+    // one global atomic per bin and work group
+    if ((local < binCount) && (localBins[local] != 0u)) {
+      atomicAdd(bins[local], localBins[local]);
+    }
+  }
+)";
+
+// flags turned into 0 or 1, scanned they give the output positions
+const char* const MarkShader = R"(
+  layout(local_size_x = 256) in;
+
+  layout(std430, binding = 0) readonly buffer Flags
+  {
+    uint flags[];
+  };
+  layout(std430, binding = 1) writeonly buffer Positions
+  {
+    uint positions[];
+  };
+
+  uniform uint offset;
+  uniform uint count;
+
+  void main()
+  {
+    const uint i = groupIndex() * 256u + gl_LocalInvocationID.x;
+    if (i < count) {
+      positions[i] = (flags[offset + i] != 0u) ? 1u : 0u;
+    }
+  }
+)";
+
+const char* const CompactShader = R"(
+  layout(local_size_x = 256) in;
+
+  layout(std430, binding = 0) readonly buffer Input
+  {
+    uint inputs[];
+  };
+  layout(std430, binding = 1) readonly buffer Flags
+  {
+    uint flags[];
+  };
+  layout(std430, binding = 2) readonly buffer Positions
+  {
+    uint positions[];
+  };
+  layout(std430, binding = 3) writeonly buffer Output
+  {
+    uint outputs[];
+  };
+  layout(std430, binding = 4) writeonly buffer Count
+  {
+    uint kept;
+  };
+
+  uniform uint offset;
+  uniform uint count;
+
+  void main()
+  {
+    const uint i = groupIndex() * 256u + gl_LocalInvocationID.x;
+    if (i >= count) {
+      return;
+    }
+    const bool keep = flags[offset + i] != 0u;
+    if (keep) {
+      outputs[positions[i]] = inputs[offset + i];
+    }
+    if (i == count - 1u) {
+      kept = positions[i] + (keep ? 1u : 0u);
+    }
+  }
+)";
+
+uint32_t divideRoundUp(uint32_t value, uint32_t divisor) {
+  return (value + divisor - 1U) / divisor;
+}
+
+std::shared_ptr<GlslComputeShader> createShader(const char* source) {
+  return GlslComputeShader::Create(std::string(Common) + source);
+}
+
+void storageBarrier() {
+  glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+// end of a primitive, the result may be read by shaders or downloaded
+void resultBarrier() {
+  glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT |
+                  GL_BUFFER_UPDATE_BARRIER_BIT);
+}
+}  // namespace
+
+std::shared_ptr<ParallelPrimitives> ParallelPrimitives::Create() {
+  return std::make_shared<ParallelPrimitives>();
+}
+
+ParallelPrimitives::ParallelPrimitives()
+    : mScanShader(createShader(ScanShader)),
+      mAddShader(createShader(AddShader)),
+      mCountShader(createShader(CountShader)),
+      mScatterShader(createShader(ScatterShader)),
+      mHistogramShader(createShader(HistogramShader)),
+      mMarkShader(createShader(MarkShader)),
+      mCompactShader(createShader(CompactShader)),
+      mSums(),
+      mKeys{ShaderStorageBuffer::Create(), 0U},
+      mValues{ShaderStorageBuffer::Create(), 0U},
+      mDigitCounts{ShaderStorageBuffer::Create(), 0U},
+      mPositions{ShaderStorageBuffer::Create(), 0U},
+      mCount(ShaderStorageBuffer::Create()) {
+  const uint32_t zero = 0U;
+  mCount->create(&zero, sizeof(zero));
+}
+
+ParallelPrimitives::~ParallelPrimitives() = default;
+
+void ParallelPrimitives::reserve(Scratch& scratch, uint32_t nBytes) {
+  if (nBytes > scratch.capacity) {
+    scratch.buffer->create(nullptr, nBytes);
+    scratch.capacity = nBytes;
+  }
+}
+
+void ParallelPrimitives::dispatch(GlslComputeShader& shader,
+                                  uint32_t groups) {
+  const auto groupsX = std::min(groups, MaxGroupsX);
+  shader.dispatchCompute(groupsX, divideRoundUp(groups, groupsX), 1U);
+}
+
+void ParallelPrimitives::scan(const std::shared_ptr<ShaderStorageBuffer>& data,
+                              uint32_t count, ScanType type,
+                              uint32_t offset) {
+  if (count == 0U) {
+    return;
+  }
+  scanLevel(data, offset, count, type == ScanType::Inclusive, 0U);
+  resultBarrier();
+  mScanShader->bind(false);
+}
+
+/**
+ * @brief Scan blocks of 512 elements, scan the block sums recursively on the
+ * next level and add them back.
+ */
+void ParallelPrimitives::scanLevel(
+  const std::shared_ptr<ShaderStorageBuffer>& data, uint32_t offset,
+  uint32_t count, bool inclusive, uint32_t level) {
+  const auto blocks = divideRoundUp(count, ScanBlockSize);
+  if (level >= mSums.size()) {
+    mSums.push_back(Scratch{ShaderStorageBuffer::Create(), 0U});
+  }
+  reserve(mSums[level], blocks * static_cast<uint32_t>(sizeof(uint32_t)));
+  // the vector may grow during the recursion
+  const auto sums = mSums[level].buffer;
+
+  mScanShader->bind(true);
+  mScanShader->setui("offset", offset);
+  mScanShader->setui("count", count);
+  mScanShader->seti("inclusive", inclusive ? 1 : 0);
+  mScanShader->seti("writeSums", (blocks > 1U) ? 1 : 0);
+  mScanShader->bindSSBO(0U, data);
+  mScanShader->bindSSBO(1U, sums);
+  dispatch(*mScanShader, blocks);
+  if (blocks == 1U) {
+    return;
+  }
+
+  storageBarrier();
+  scanLevel(sums, 0U, blocks, false, level + 1U);
+  storageBarrier();
+
+  mAddShader->bind(true);
+  mAddShader->setui("offset", offset);
+  mAddShader->setui("count", count);
+  mAddShader->bindSSBO(0U, data);
+  mAddShader->bindSSBO(1U, sums, false);
+  dispatch(*mAddShader, divideRoundUp(count, GroupSize));
+}
+
+void ParallelPrimitives::sort(
+  const std::shared_ptr<ShaderStorageBuffer>& keys,
+  const std::shared_ptr<ShaderStorageBuffer>& values, uint32_t count,
+  uint32_t offset, uint32_t keyBits) {
+  if ((keyBits == 0U) || (keyBits > 32U)) {
+    throw std::invalid_argument(
+      "ParallelPrimitives::sort: keyBits must be in [1, 32]");
+  }
+  if (count <= 1U) {
+    return;
+  }
+  const auto hasValues = values != nullptr;
+  const auto tileCount = divideRoundUp(count, TileSize);
+  const auto bytes     = count * static_cast<uint32_t>(sizeof(uint32_t));
+  reserve(mKeys, bytes);
+  if (hasValues) {
+    reserve(mValues, bytes);
+  }
+  reserve(mDigitCounts, RadixSize * tileCount *
+                          static_cast<uint32_t>(sizeof(uint32_t)));
+
+  const auto passes = divideRoundUp(keyBits, RadixBits);
+  for (auto pass = 0U; pass < passes; pass++) {
+    // ping pong between the caller's range and the scratch buffers
+    const auto toScratch = (pass % 2U) == 0U;
+    const auto& keysIn   = toScratch ? keys : mKeys.buffer;
+    const auto& keysOut  = toScratch ? mKeys.buffer : keys;
+    const auto& valuesIn = hasValues ? (toScratch ? values : mValues.buffer)
+                                     : keysIn;
+    const auto& valuesOut =
+      hasValues ? (toScratch ? mValues.buffer : values) : keysOut;
+    const auto inOffset  = toScratch ? offset : 0U;
+    const auto outOffset = toScratch ? 0U : offset;
+    const auto shift     = pass * RadixBits;
+
+    mCountShader->bind(true);
+    mCountShader->setui("offset", inOffset);
+    mCountShader->setui("count", count);
+    mCountShader->setui("shift", shift);
+    mCountShader->setui("tileCount", tileCount);
+    mCountShader->bindSSBO(0U, keysIn, false);
+    mCountShader->bindSSBO(1U, mDigitCounts.buffer);
+    dispatch(*mCountShader, tileCount);
+    storageBarrier();
+
+    // global position of every digit in every tile
+    scanLevel(mDigitCounts.buffer, 0U, RadixSize * tileCount, false, 0U);
+    storageBarrier();
+
+    mScatterShader->bind(true);
+    mScatterShader->setui("inOffset", inOffset);
+    mScatterShader->setui("outOffset", outOffset);
+    mScatterShader->setui("count", count);
+    mScatterShader->setui("shift", shift);
+    mScatterShader->setui("tileCount", tileCount);
+    mScatterShader->seti("hasValues", hasValues ? 1 : 0);
+    mScatterShader->bindSSBO(0U, keysIn, false);
+    mScatterShader->bindSSBO(1U, keysOut);
+    mScatterShader->bindSSBO(2U, valuesIn, false);
+    mScatterShader->bindSSBO(3U, valuesOut);
+    mScatterShader->bindSSBO(4U, mDigitCounts.buffer, false);
+    dispatch(*mScatterShader, tileCount);
+    storageBarrier();
+  }
+  mScatterShader->bind(false);
+  // for downloads of the result and the copy below, the storage barrier was
+  // issued after the last pass
+  glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+  // an odd number of passes leaves the result in the scratch buffers
+  if ((passes % 2U) == 1U) {
+    glCopyNamedBufferSubData(
+      mKeys.buffer->getHandle(), keys->getHandle(), 0,
+      static_cast<GLintptr>(keys->getOffset() + offset * 4U), bytes);
+    if (hasValues) {
+      glCopyNamedBufferSubData(
+        mValues.buffer->getHandle(), values->getHandle(), 0,
+        static_cast<GLintptr>(values->getOffset() + offset * 4U), bytes);
+    }
+  }
+}
+
+void ParallelPrimitives::histogram(
+  const std::shared_ptr<ShaderStorageBuffer>& values, uint32_t count,
+  const std::shared_ptr<ShaderStorageBuffer>& bins, uint32_t binCount,
+  uint32_t binWidth, uint32_t offset) {
+  if ((binCount == 0U) || (binCount > MaxBinCount)) {
+    throw std::invalid_argument(
+      "ParallelPrimitives::histogram: binCount must be in [1, 256]");
+  }
+  if (binWidth == 0U) {
+    throw std::invalid_argument(
+      "ParallelPrimitives::histogram: binWidth must not be zero");
+  }
+
+  glClearNamedBufferSubData(bins->getHandle(), GL_R32UI,
+                            static_cast<GLintptr>(bins->getOffset()),
+                            binCount * static_cast<GLsizeiptr>(4),
+                            GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+  if (count == 0U) {
+    return;
+  }
+  glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+  mHistogramShader->bind(true);
+  mHistogramShader->setui("offset", offset);
+  mHistogramShader->setui("count", count);
+  mHistogramShader->setui("binCount", binCount);
+  mHistogramShader->setui("binWidth", binWidth);
+  mHistogramShader->bindSSBO(0U, values, false);
+  mHistogramShader->bindSSBO(1U, bins);
+  dispatch(*mHistogramShader, divideRoundUp(count, TileSize));
+  resultBarrier();
+  mHistogramShader->bind(false);
+}
+
+void ParallelPrimitives::compact(
+  const std::shared_ptr<ShaderStorageBuffer>& input,
+  const std::shared_ptr<ShaderStorageBuffer>& flags,
+  const std::shared_ptr<ShaderStorageBuffer>& output, uint32_t count,
+  uint32_t offset) {
+  if (count == 0U) {
+    glClearNamedBufferData(mCount->getHandle(), GL_R32UI, GL_RED_INTEGER,
+                           GL_UNSIGNED_INT, nullptr);
+    return;
+  }
+  reserve(mPositions, count * static_cast<uint32_t>(sizeof(uint32_t)));
+
+  mMarkShader->bind(true);
+  mMarkShader->setui("offset", offset);
+  mMarkShader->setui("count", count);
+  mMarkShader->bindSSBO(0U, flags, false);
+  mMarkShader->bindSSBO(1U, mPositions.buffer);
+  dispatch(*mMarkShader, divideRoundUp(count, GroupSize));
+  storageBarrier();
+
+  scanLevel(mPositions.buffer, 0U, count, false, 0U);
+  storageBarrier();
+
+  mCompactShader->bind(true);
+  mCompactShader->setui("offset", offset);
+  mCompactShader->setui("count", count);
+  mCompactShader->bindSSBO(0U, input, false);
+  mCompactShader->bindSSBO(1U, flags, false);
+  mCompactShader->bindSSBO(2U, mPositions.buffer, false);
+  mCompactShader->bindSSBO(3U, output);
+  mCompactShader->bindSSBO(4U, mCount);
+  dispatch(*mCompactShader, divideRoundUp(count, GroupSize));
+  resultBarrier();
+  mCompactShader->bind(false);
+}
+
+const std::shared_ptr<ShaderStorageBuffer>& ParallelPrimitives::getCountBuffer()
+  const {
+  return mCount;
+}
+
+uint32_t ParallelPrimitives::getCompactedCount() const {
+  glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+  uint32_t count = 0U;
+  glGetNamedBufferSubData(mCount->getHandle(), 0,
+                          static_cast<GLsizeiptr>(sizeof(count)), &count);
+  return count;
+}
+
+}  // namespace prgl
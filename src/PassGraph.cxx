@@ -0,0 +1,501 @@
+#include "prgl/PassGraph.hxx"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+
+namespace prgl {
+
+PassGraph::PassGraph(std::shared_ptr<BarrierTracker> tracker)
+    : mTracker((tracker != nullptr) ? std::move(tracker)
+                                    : BarrierTracker::Create()),
+      mResources(),
+      mVersions(),
+      mPasses(),
+      mOrder(),
+      mTextures(),
+      mBuffers(),
+      mCompiled(false) {}
+
+PassGraph::~PassGraph() = default;
+
+PassGraph::Handle PassGraph::createTexture(
+  const std::string& name, const TextureDescriptor& descriptor) {
+  if (!isSizedFormat(descriptor.internalFormat)) {
+    throw std::invalid_argument(
+      "PassGraph: transient textures require a sized internal format");
+  }
+  if ((descriptor.width == 0U) || (descriptor.height == 0U)) {
+    throw std::invalid_argument(
+      "PassGraph: transient texture size must not be zero");
+  }
+  return addResource(Resource{name, Kind::Texture, descriptor, 0U, false,
+                              nullptr, nullptr, NoVersion, Culled});
+}
+
+PassGraph::Handle PassGraph::createBuffer(const std::string& name,
+                                          uint32_t nBytes) {
+  if (nBytes == 0U) {
+    throw std::invalid_argument(
+      "PassGraph: transient buffer size must not be zero");
+  }
+  return addResource(Resource{name, Kind::Buffer, TextureDescriptor(), nBytes,
+                              false, nullptr, nullptr, NoVersion, Culled});
+}
+
+PassGraph::Handle PassGraph::importTexture(
+  const std::string& name, const std::shared_ptr<Texture2d>& texture) {
+  if (texture == nullptr) {
+    throw std::invalid_argument("PassGraph::importTexture: texture is null");
+  }
+  return addResource(Resource{name, Kind::Texture, TextureDescriptor(), 0U,
+                              true, texture, nullptr, NoVersion, Culled});
+}
+
+PassGraph::Handle PassGraph::importBuffer(
+  const std::string& name, const std::shared_ptr<ShaderStorageBuffer>& buffer) {
+  if (buffer == nullptr) {
+    throw std::invalid_argument("PassGraph::importBuffer: buffer is null");
+  }
+  return addResource(Resource{name, Kind::Buffer, TextureDescriptor(), 0U,
+                              true, nullptr, buffer, NoVersion, Culled});
+}
+
+PassGraph::Handle PassGraph::addResource(Resource resource) {
+  const auto version = static_cast<Handle>(mVersions.size());
+  resource.latest    = version;
+  mVersions.push_back(Version{static_cast<uint32_t>(mResources.size()),
+                              NoVersion, NoPass, {}});
+  mResources.push_back(std::move(resource));
+  mCompiled = false;
+  return version;
+}
+
+uint32_t PassGraph::addPass(const std::string& name, Execute execute) {
+  mPasses.push_back(Pass{name, std::move(execute), {}, false, false});
+  mCompiled = false;
+  return static_cast<uint32_t>(mPasses.size() - 1U);
+}
+
+void PassGraph::read(uint32_t pass, Handle resource,
+                     BarrierTracker::Access access) {
+  auto& p = getPass(pass);
+  getVersion(resource);
+  auto& readers = mVersions[resource].readers;
+  if (std::find(readers.begin(), readers.end(), pass) == readers.end()) {
+    readers.push_back(pass);
+  }
+  p.uses.push_back(Use{resource, access, false});
+  mCompiled = false;
+}
+
+PassGraph::Handle PassGraph::write(uint32_t pass, Handle resource,
+                                   BarrierTracker::Access access) {
+  auto& p          = getPass(pass);
+  const auto index = getVersion(resource).resource;
+  if (mResources[index].latest != resource) {
+    throw std::invalid_argument("PassGraph::write: " + mResources[index].name +
+                                " was written since this version");
+  }
+  const auto version = static_cast<Handle>(mVersions.size());
+  mVersions.push_back(Version{index, resource, pass, {}});
+  mResources[index].latest = version;
+  p.uses.push_back(Use{version, access, true});
+  mCompiled = false;
+  return version;
+}
+
+void PassGraph::setSideEffect(uint32_t pass) {
+  getPass(pass).sideEffect = true;
+  mCompiled                = false;
+}
+
+const PassGraph::Version& PassGraph::getVersion(Handle resource) const {
+  if (resource >= mVersions.size()) {
+    throw std::invalid_argument("PassGraph: unknown resource handle");
+  }
+  return mVersions[resource];
+}
+
+PassGraph::Pass& PassGraph::getPass(uint32_t pass) {
+  if (pass >= mPasses.size()) {
+    throw std::invalid_argument("PassGraph: unknown pass");
+  }
+  return mPasses[pass];
+}
+
+std::vector<uint32_t> PassGraph::getDependencies(uint32_t pass,
+                                                 bool withReaders) const {
+  std::vector<uint32_t> dependencies;
+  const auto add = [&dependencies, pass](uint32_t other) {
+    if ((other != NoPass) && (other != pass)) {
+      dependencies.push_back(other);
+    }
+  };
+  for (const auto& use : mPasses[pass].uses) {
+    const auto& version = mVersions[use.version];
+    if (!use.writes) {
+      add(version.producer);
+      continue;
+    }
+    // a write keeps what it does not overwrite, so it needs the previous
+    // content and must not clobber it before it was read
+    const auto& previous = mVersions[version.previous];
+    add(previous.producer);
+    if (withReaders) {
+      for (const auto reader : previous.readers) {
+        add(reader);
+      }
+    }
+  }
+  std::sort(dependencies.begin(), dependencies.end());
+  dependencies.erase(std::unique(dependencies.begin(), dependencies.end()),
+                     dependencies.end());
+  return dependencies;
+}
+
+void PassGraph::compile() {
+  cull();
+  sort();
+  assignPhysical();
+  mCompiled = true;
+}
+
+/**
+ * @brief Keep passes with side effects or writing imported resources and
+ * everything they depend on.
+ */
+void PassGraph::cull() {
+  std::vector<uint32_t> stack;
+  for (auto i = 0U; i < mPasses.size(); i++) {
+    auto& pass  = mPasses[i];
+    pass.culled = true;
+    auto root   = pass.sideEffect;
+    for (const auto& use : pass.uses) {
+      root = root || (use.writes &&
+                      mResources[mVersions[use.version].resource].imported);
+    }
+    if (root) {
+      stack.push_back(i);
+    }
+  }
+  while (!stack.empty()) {
+    const auto i = stack.back();
+    stack.pop_back();
+    if (!mPasses[i].culled) {
+      continue;
+    }
+    mPasses[i].culled = false;
+    for (const auto dependency : getDependencies(i, false)) {
+      stack.push_back(dependency);
+    }
+  }
+}
+
+/**
+ * @brief Topological order of the passes left, independent passes keep the
+ * order they were added in.
+ */
+void PassGraph::sort() {
+  const auto count = static_cast<uint32_t>(mPasses.size());
+  std::vector<uint32_t> pending(count, 0U);
+  std::vector<std::vector<uint32_t>> successors(count);
+  auto alive = 0U;
+  for (auto i = 0U; i < count; i++) {
+    if (mPasses[i].culled) {
+      continue;
+    }
+    alive++;
+    for (const auto dependency : getDependencies(i, true)) {
+      if (!mPasses[dependency].culled) {
+        successors[dependency].push_back(i);
+        pending[i]++;
+      }
+    }
+  }
+
+  std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<>> ready;
+  for (auto i = 0U; i < count; i++) {
+    if (!mPasses[i].culled && (pending[i] == 0U)) {
+      ready.push(i);
+    }
+  }
+  mOrder.clear();
+  while (!ready.empty()) {
+    const auto i = ready.top();
+    ready.pop();
+    mOrder.push_back(i);
+    for (const auto successor : successors[i]) {
+      if (--pending[successor] == 0U) {
+        ready.push(successor);
+      }
+    }
+  }
+  if (mOrder.size() != alive) {
+    throw std::runtime_error(
+      "PassGraph::compile: passes read what each other overwrite");
+  }
+}
+
+/**
+ * @brief Assign transients to GL objects in the order of their first use, an
+ * object is reused once the last pass using its previous transient ran.
+ */
+void PassGraph::assignPhysical() {
+  const auto resourceCount = static_cast<uint32_t>(mResources.size());
+  std::vector<uint32_t> first(resourceCount, NoPass);
+  std::vector<uint32_t> last(resourceCount, 0U);
+  for (auto position = 0U; position < mOrder.size(); position++) {
+    for (const auto& use : mPasses[mOrder[position]].uses) {
+      const auto resource = mVersions[use.version].resource;
+      first[resource]     = std::min(first[resource], position);
+      last[resource]      = std::max(last[resource], position);
+    }
+  }
+
+  std::vector<uint32_t> transients;
+  for (auto i = 0U; i < resourceCount; i++) {
+    mResources[i].physical = Culled;
+    if (!mResources[i].imported && (first[i] != NoPass)) {
+      transients.push_back(i);
+    }
+  }
+  std::stable_sort(
+    transients.begin(), transients.end(),
+    [&first](uint32_t a, uint32_t b) { return first[a] < first[b]; });
+
+  for (auto& texture : mTextures) {
+    texture.freeFrom = 0U;
+  }
+  for (auto& buffer : mBuffers) {
+    buffer.freeFrom = 0U;
+  }
+  std::vector<bool> usedTextures(mTextures.size(), false);
+  std::vector<bool> usedBuffers(mBuffers.size(), false);
+
+  for (const auto i : transients) {
+    auto& resource = mResources[i];
+    if (resource.kind == Kind::Texture) {
+      auto slot = 0U;
+      while ((slot < mTextures.size()) &&
+             (!(mTextures[slot].descriptor == resource.descriptor) ||
+              (mTextures[slot].freeFrom > first[i]))) {
+        slot++;
+      }
+      if (slot == mTextures.size()) {
+        mTextures.push_back(PhysicalTexture{resource.descriptor, nullptr, 0U});
+        usedTextures.push_back(false);
+      }
+      mTextures[slot].freeFrom = last[i] + 1U;
+      usedTextures[slot]       = true;
+      resource.physical        = slot;
+      continue;
+    }
+
+    // smallest free buffer that fits, else the largest free one grows
+    auto best = NoPass;
+    for (auto slot = 0U; slot < mBuffers.size(); slot++) {
+      const auto& buffer = mBuffers[slot];
+      if (buffer.freeFrom > first[i]) {
+        continue;
+      }
+      if (best == NoPass) {
+        best = slot;
+        continue;
+      }
+      const auto capacity = mBuffers[best].capacity;
+      const auto fits     = buffer.capacity >= resource.nBytes;
+      const auto bestFits = capacity >= resource.nBytes;
+      if ((fits && (!bestFits || (buffer.capacity < capacity))) ||
+          (!fits && !bestFits && (buffer.capacity > capacity))) {
+        best = slot;
+      }
+    }
+    if (best == NoPass) {
+      best = static_cast<uint32_t>(mBuffers.size());
+      mBuffers.push_back(PhysicalBuffer{0U, 0U, nullptr, 0U});
+      usedBuffers.push_back(false);
+    }
+    auto& physical    = mBuffers[best];
+    physical.capacity = std::max(physical.capacity, resource.nBytes);
+    physical.freeFrom = last[i] + 1U;
+    usedBuffers[best] = true;
+    resource.physical = best;
+  }
+
+  // objects no transient needs any more are deleted
+  std::vector<uint32_t> textureSlots(mTextures.size(), Culled);
+  std::vector<uint32_t> bufferSlots(mBuffers.size(), Culled);
+  std::vector<PhysicalTexture> textures;
+  std::vector<PhysicalBuffer> buffers;
+  for (auto slot = 0U; slot < mTextures.size(); slot++) {
+    if (usedTextures[slot]) {
+      textureSlots[slot] = static_cast<uint32_t>(textures.size());
+      textures.push_back(std::move(mTextures[slot]));
+    }
+  }
+  for (auto slot = 0U; slot < mBuffers.size(); slot++) {
+    if (usedBuffers[slot]) {
+      bufferSlots[slot] = static_cast<uint32_t>(buffers.size());
+      buffers.push_back(std::move(mBuffers[slot]));
+    }
+  }
+  mTextures = std::move(textures);
+  mBuffers  = std::move(buffers);
+  for (const auto i : transients) {
+    auto& resource    = mResources[i];
+    resource.physical = (resource.kind == Kind::Texture)
+                          ? textureSlots[resource.physical]
+                          : bufferSlots[resource.physical];
+  }
+}
+
+void PassGraph::realize(const Resource& resource) {
+  if (resource.imported || (resource.physical == Culled)) {
+    return;
+  }
+  if (resource.kind == Kind::Texture) {
+    auto& physical = mTextures[resource.physical];
+    if (physical.texture == nullptr) {
+      const auto& descriptor = physical.descriptor;
+      physical.texture       = Texture2d::Create(
+        descriptor.width, descriptor.height, descriptor.internalFormat,
+        TextureFormat::Rgba, DataType::Float, TextureMinFilter::Linear,
+        TextureMagFilter::Linear, TextureEnvMode::Replace,
+        TextureWrapMode::ClampToEdge, descriptor.levels != 1U);
+      physical.texture->allocate(descriptor.levels);
+    }
+    return;
+  }
+  auto& physical = mBuffers[resource.physical];
+  if (physical.buffer == nullptr) {
+    physical.buffer = ShaderStorageBuffer::Create();
+  }
+  if (physical.allocated < physical.capacity) {
+    physical.buffer->create(nullptr, physical.capacity);
+    physical.allocated = physical.capacity;
+  }
+}
+
+void PassGraph::execute() {
+  if (!mCompiled) {
+    compile();
+  }
+  for (const auto& resource : mResources) {
+    realize(resource);
+  }
+
+  for (const auto i : mOrder) {
+    const auto& pass = mPasses[i];
+    for (const auto& use : pass.uses) {
+      const auto& resource = mResources[mVersions[use.version].resource];
+      // reads after the graph flush the writes through the same tracker
+      if (resource.kind == Kind::Texture) {
+        const auto& texture = getTexture(use.version);
+        mTracker->use(*texture, use.access, use.writes);
+        if (use.writes) {
+          texture->setBarrierTracker(mTracker);
+        }
+      } else {
+        const auto& buffer = getBuffer(use.version);
+        mTracker->use(*buffer, use.access, use.writes);
+        if (use.writes) {
+          buffer->setBarrierTracker(mTracker);
+        }
+      }
+    }
+    mTracker->flush();
+    if (pass.execute) {
+      pass.execute(*this);
+    }
+  }
+}
+
+void PassGraph::reset() {
+  mResources.clear();
+  mVersions.clear();
+  mPasses.clear();
+  mOrder.clear();
+  mCompiled = false;
+}
+
+const std::shared_ptr<Texture2d>& PassGraph::getTexture(
+  Handle resource) const {
+  const auto& r = mResources[getVersion(resource).resource];
+  if (r.kind != Kind::Texture) {
+    throw std::invalid_argument("PassGraph::getTexture: " + r.name +
+                                " is a buffer");
+  }
+  if (r.imported) {
+    return r.texture;
+  }
+  if ((r.physical == Culled) || (mTextures[r.physical].texture == nullptr)) {
+    throw std::runtime_error("PassGraph::getTexture: " + r.name +
+                             " is not allocated");
+  }
+  return mTextures[r.physical].texture;
+}
+
+const std::shared_ptr<ShaderStorageBuffer>& PassGraph::getBuffer(
+  Handle resource) const {
+  const auto& r = mResources[getVersion(resource).resource];
+  if (r.kind != Kind::Buffer) {
+    throw std::invalid_argument("PassGraph::getBuffer: " + r.name +
+                                " is a texture");
+  }
+  if (r.imported) {
+    return r.buffer;
+  }
+  if ((r.physical == Culled) || (mBuffers[r.physical].buffer == nullptr)) {
+    throw std::runtime_error("PassGraph::getBuffer: " + r.name +
+                             " is not allocated");
+  }
+  return mBuffers[r.physical].buffer;
+}
+
+const std::vector<uint32_t>& PassGraph::getOrder() const {
+  return mOrder;
+}
+
+bool PassGraph::isCulled(uint32_t pass) const {
+  if (pass >= mPasses.size()) {
+    throw std::invalid_argument("PassGraph: unknown pass");
+  }
+  return mPasses[pass].culled;
+}
+
+uint32_t PassGraph::getPhysicalIndex(Handle resource) const {
+  return mResources[getVersion(resource).resource].physical;
+}
+
+const std::shared_ptr<BarrierTracker>& PassGraph::getBarrierTracker() const {
+  return mTracker;
+}
+
+PassGraph::Statistics PassGraph::getStatistics() const {
+  Statistics statistics{static_cast<uint32_t>(mPasses.size()),
+                        0U,
+                        0U,
+                        0U,
+                        static_cast<uint32_t>(mTextures.size()),
+                        static_cast<uint32_t>(mBuffers.size())};
+  for (const auto& pass : mPasses) {
+    if (pass.culled) {
+      statistics.culled++;
+    }
+  }
+  for (const auto& resource : mResources) {
+    if (resource.imported || (resource.physical == Culled)) {
+      continue;
+    }
+    if (resource.kind == Kind::Texture) {
+      statistics.transientTextures++;
+    } else {
+      statistics.transientBuffers++;
+    }
+  }
+  return statistics;
+}
+
+}  // namespace prgl
@@ -0,0 +1,152 @@
+#include "prgl/PersistentBufferRing.hxx"
+
+#include <stdexcept>
+
+namespace prgl {
+
+namespace {
+// timeout per glClientWaitSync call, waiting is repeated until signaled
+constexpr GLuint64 FenceTimeoutNs = 1000000000U;
+}  // namespace
+
+PersistentBufferRing::PersistentBufferRing(GLenum target, std::size_t slotSize,
+                                           uint32_t slotCount, Access access,
+                                           std::size_t slotAlignment)
+    : mHandle(INVALID_HANDLE),
+      mTarget(target),
+      mSlotSize(slotSize),
+      mSlotStride(slotSize),
+      mSlotCount(slotCount),
+      mCurrent(slotCount - 1U),
+      mMapped(nullptr),
+      mFences(slotCount, nullptr) {
+  if ((slotSize == 0U) || (slotCount == 0U)) {
+    throw std::invalid_argument(
+      "PersistentBufferRing: slot size and slot count must not be zero");
+  }
+  if (slotAlignment > 1U) {
+    mSlotStride =
+      ((slotSize + slotAlignment - 1U) / slotAlignment) * slotAlignment;
+  }
+
+  GLbitfield flags = GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+  if (access == Access::Write) {
+    flags |= GL_MAP_WRITE_BIT;
+  } else {
+    flags |= GL_MAP_READ_BIT;
+  }
+  const auto storageFlags =
+    (access == Access::Read) ? (flags | GL_CLIENT_STORAGE_BIT) : flags;
+
+  const auto totalSize = static_cast<GLsizeiptr>(mSlotStride * mSlotCount);
+
+  glGenBuffers(1, &mHandle);
+  bind(true);
+  glBufferStorage(mTarget, totalSize, nullptr, storageFlags);
+  mMapped =
+    static_cast<uint8_t*>(glMapBufferRange(mTarget, 0, totalSize, flags));
+  bind(false);
+
+  if (mMapped == nullptr) {
+    glDeleteBuffers(1, &mHandle);
+    throw std::runtime_error(
+      "PersistentBufferRing: could not persistently map buffer storage");
+  }
+}
+
+PersistentBufferRing::~PersistentBufferRing() {
+  for (auto slot = 0U; slot < mSlotCount; slot++) {
+    releaseFence(slot);
+  }
+  if (mMapped != nullptr) {
+    bind(true);
+    glUnmapBuffer(mTarget);
+    bind(false);
+    mMapped = nullptr;
+  }
+  glDeleteBuffers(1, &mHandle);
+  mHandle = INVALID_HANDLE;
+}
+
+void PersistentBufferRing::bind(bool bind) const {
+  if (bind) {
+    glBindBuffer(mTarget, mHandle);
+  } else {
+    glBindBuffer(mTarget, 0);
+  }
+}
+
+uint32_t PersistentBufferRing::acquire() {
+  mCurrent = (mCurrent + 1U) % mSlotCount;
+  wait(mCurrent);
+  releaseFence(mCurrent);
+  return mCurrent;
+}
+
+void PersistentBufferRing::fence(uint32_t slot) {
+  releaseFence(slot);
+  mFences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool PersistentBufferRing::isSignaled(uint32_t slot) const {
+  const auto sync = mFences[slot];
+  if (sync == nullptr) {
+    return true;
+  }
+  const auto status = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 0U);
+  return (status == GL_ALREADY_SIGNALED) || (status == GL_CONDITION_SATISFIED);
+}
+
+void PersistentBufferRing::wait(uint32_t slot) const {
+  const auto sync = mFences[slot];
+  if (sync == nullptr) {
+    return;
+  }
+  while (true) {
+    const auto status =
+      glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, FenceTimeoutNs);
+    if ((status == GL_ALREADY_SIGNALED) || (status == GL_CONDITION_SATISFIED)) {
+      return;
+    }
+    if (status == GL_WAIT_FAILED) {
+      throw std::runtime_error("PersistentBufferRing: glClientWaitSync failed");
+    }
+  }
+}
+
+void PersistentBufferRing::releaseFence(uint32_t slot) {
+  if (mFences[slot] != nullptr) {
+    glDeleteSync(mFences[slot]);
+    mFences[slot] = nullptr;
+  }
+}
+
+void* PersistentBufferRing::getMappedSlot(uint32_t slot) const {
+  return mMapped + getSlotOffset(slot);
+}
+
+std::size_t PersistentBufferRing::getSlotOffset(uint32_t slot) const {
+  return mSlotStride * slot;
+}
+
+std::size_t PersistentBufferRing::getSlotSize() const {
+  return mSlotSize;
+}
+
+uint32_t PersistentBufferRing::getSlotCount() const {
+  return mSlotCount;
+}
+
+uint32_t PersistentBufferRing::getCurrentSlot() const {
+  return mCurrent;
+}
+
+uint32_t PersistentBufferRing::getHandle() const {
+  return mHandle;
+}
+
+GLenum PersistentBufferRing::getTarget() const {
+  return mTarget;
+}
+
+}  // namespace prgl
@@ -0,0 +1,186 @@
+#include "prgl/ProgramBinaryCache.hxx"
+
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "Hash.hxx"
+
+namespace prgl {
+
+namespace {
+// file header: magic, binary format, identity and binary size in bytes,
+// followed by the identity and the binary
+constexpr uint32_t Magic = 0x32475250U;  // "PRG2"
+
+std::string getString(GLenum name) {
+  const auto* value = glGetString(name);
+  return (value != nullptr) ? reinterpret_cast<const char*>(value) : "";
+}
+}  // namespace
+
+std::shared_ptr<ProgramBinaryCache> ProgramBinaryCache::Create(
+  const std::string& directory) {
+  return std::make_shared<ProgramBinaryCache>(directory);
+}
+
+ProgramBinaryCache::ProgramBinaryCache(const std::string& directory)
+    : mDirectory(directory),
+      mDriver(),
+      mHits(0U),
+      mMisses(0U),
+      mMutex() {
+  std::error_code error;
+  std::filesystem::create_directories(mDirectory, error);
+  if (error) {
+    throw std::runtime_error("ProgramBinaryCache: cannot create " +
+                             mDirectory + ": " + error.message());
+  }
+}
+
+ProgramBinaryCache::~ProgramBinaryCache() = default;
+
+ProgramBinaryCache::Key ProgramBinaryCache::makeKey(
+  const std::map<uint32_t, std::string>& sources) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (mDriver.empty()) {
+    mDriver = getString(GL_VENDOR) + "|" + getString(GL_RENDERER) + "|" +
+              getString(GL_VERSION);
+  }
+  // the sizes keep stage boundaries unambiguous
+  auto identity = mDriver;
+  for (const auto& source : sources) {
+    identity += "\n" + std::to_string(source.first) + " " +
+                std::to_string(source.second.size()) + "\n" + source.second;
+  }
+  std::stringstream ss;
+  ss << std::hex << std::setw(16) << std::setfill('0')
+     << hashString(HashSeed, identity);
+  return {ss.str(), identity};
+}
+
+std::string ProgramBinaryCache::getPath(const Key& key) const {
+  return (std::filesystem::path(mDirectory) / (key.name + ".bin")).string();
+}
+
+bool ProgramBinaryCache::load(uint32_t program, const Key& key) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  std::ifstream file(getPath(key), std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    mMisses++;
+    return false;
+  }
+
+  uint32_t magic        = 0U;
+  uint32_t format       = 0U;
+  uint64_t identitySize = 0U;
+  uint64_t size         = 0U;
+  file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  file.read(reinterpret_cast<char*>(&format), sizeof(format));
+  file.read(reinterpret_cast<char*>(&identitySize), sizeof(identitySize));
+  file.read(reinterpret_cast<char*>(&size), sizeof(size));
+  // the sizes in the header have to match the rest of the file, a corrupt
+  // header must not decide how much is allocated
+  std::error_code error;
+  const auto fileSize = std::filesystem::file_size(getPath(key), error);
+  const auto header =
+    sizeof(magic) + sizeof(format) + sizeof(identitySize) + sizeof(size);
+  std::vector<char> binary;
+  if (file && (magic == Magic) && !error && (fileSize >= header) &&
+      (identitySize == key.identity.size()) &&
+      (identitySize <= (fileSize - header)) &&
+      (size == (fileSize - header - identitySize)) &&
+      (size <= static_cast<uint64_t>(std::numeric_limits<GLsizei>::max()))) {
+    std::string identity(identitySize, '\0');
+    file.read(identity.data(), static_cast<std::streamsize>(identitySize));
+    // same hash but other sources or driver
+    if (file && (identity == key.identity)) {
+      binary.resize(size);
+      file.read(binary.data(), static_cast<std::streamsize>(size));
+    }
+  }
+  const auto complete = file && !binary.empty();
+  file.close();
+
+  int32_t linked = 0;
+  if (complete) {
+    glProgramBinary(program, format, binary.data(),
+                    static_cast<GLsizei>(binary.size()));
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+  }
+  if (linked == 0) {
+    // truncated, corrupt, a collision or the driver does not accept the
+    // format anymore
+    std::filesystem::remove(getPath(key), error);
+    mMisses++;
+    return false;
+  }
+  mHits++;
+  return true;
+}
+
+void ProgramBinaryCache::store(uint32_t program, const Key& key) const {
+  std::lock_guard<std::mutex> lock(mMutex);
+  int32_t length = 0;
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    // the driver supports no binary formats
+    return;
+  }
+  std::vector<char> binary(static_cast<std::size_t>(length));
+  GLenum format  = 0U;
+  GLsizei actual = 0;
+  glGetProgramBinary(program, length, &actual, &format, binary.data());
+  if (actual <= 0) {
+    return;
+  }
+
+  // write to a temporary file first so that readers never see partial data
+  const auto path      = getPath(key);
+  const auto temporary = path + ".tmp";
+  std::ofstream file(temporary,
+                     std::ios::out | std::ios::binary | std::ios::trunc);
+  const uint32_t magic        = Magic;
+  const uint32_t fileFormat   = format;
+  const uint64_t identitySize = key.identity.size();
+  const auto size             = static_cast<uint64_t>(actual);
+  file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+  file.write(reinterpret_cast<const char*>(&fileFormat), sizeof(fileFormat));
+  file.write(reinterpret_cast<const char*>(&identitySize),
+             sizeof(identitySize));
+  file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  file.write(key.identity.data(), static_cast<std::streamsize>(identitySize));
+  file.write(binary.data(), static_cast<std::streamsize>(actual));
+  file.close();
+
+  std::error_code error;
+  if (file.fail()) {
+    std::filesystem::remove(temporary, error);
+  } else {
+    std::filesystem::rename(temporary, path, error);
+  }
+  if (file.fail() || error) {
+    std::cerr << "ProgramBinaryCache: cannot write " << path << std::endl;
+  }
+}
+
+const std::string& ProgramBinaryCache::getDirectory() const {
+  return mDirectory;
+}
+
+uint32_t ProgramBinaryCache::getHits() const {
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mHits;
+}
+
+uint32_t ProgramBinaryCache::getMisses() const {
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mMisses;
+}
+
+}  // namespace prgl
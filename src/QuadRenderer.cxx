@@ -0,0 +1,234 @@
+#include "prgl/QuadRenderer.hxx"
+
+#include <algorithm>
+#include <string>
+
+#include "prgl/Projection.hxx"
+
+namespace prgl {
+
+namespace {
+const char* const QuadVertexShader = R"(
+  #version 330 core
+
+  // x, y, width, height in pixels
+  layout(location = 0) in vec4 rect;
+  // u0, v0, u1, v1
+  layout(location = 1) in vec4 texCoords;
+  // texture array layer
+  layout(location = 2) in float layer;
+
+  uniform mat4 projection;
+
+  out vec2 uv;
+  flat out float uvLayer;
+
+  void main()
+  {
+    // triangle strip corners (0,0) (1,0) (0,1) (1,1), top left first
+    vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1));
+    uv = vec2(mix(texCoords.x, texCoords.z, corner.x),
+              mix(texCoords.w, texCoords.y, corner.y));
+    uvLayer = layer;
+    gl_Position = projection * vec4(rect.xy + corner * rect.zw, 0.0, 1.0);
+  }
+)";
+
+const char* const QuadFragmentShader = R"(
+  #version 330 core
+
+  in vec2 uv;
+  flat in float uvLayer;
+
+  uniform SAMPLER image;
+  uniform bool convertSRGB;
+
+  out vec4 color;
+
+  vec3 linearToSRGB(vec3 c)
+  {
+    return mix(c * 12.92, 1.055 * pow(c, vec3(1.0 / 2.4)) - 0.055,
+               step(vec3(0.0031308), c));
+  }
+
+  void main()
+  {
+    color = texture(image, TEXCOORD);
+    if (convertSRGB) {
+      color.rgb = linearToSRGB(max(color.rgb, vec3(0.0)));
+    }
+  }
+)";
+
+std::string fragmentShader(bool isArray) {
+  // the sampler type is injected after the version line
+  std::string source    = QuadFragmentShader;
+  const auto lineEnd    = source.find('\n', source.find("#version"));
+  const auto definition = isArray ? "\n#define SAMPLER sampler2DArray"
+                                    "\n#define TEXCOORD vec3(uv, uvLayer)"
+                                  : "\n#define SAMPLER sampler2D"
+                                    "\n#define TEXCOORD uv";
+  source.insert(lineEnd, definition);
+  return source;
+}
+}  // namespace
+
+std::shared_ptr<QuadRenderer> QuadRenderer::Create() {
+  return std::make_shared<QuadRenderer>();
+}
+
+QuadRenderer::QuadRenderer()
+    : mProgram(GlslRenderingPipelineProgram::Create()),
+      mArrayProgram(GlslRenderingPipelineProgram::Create()),
+      mVao(VertexArrayObject::Create()),
+      mRects(
+        VertexBufferObject::Create(VertexBufferObject::Usage::DynamicDraw)),
+      mTexCoords(
+        VertexBufferObject::Create(VertexBufferObject::Usage::DynamicDraw)),
+      mLayers(
+        VertexBufferObject::Create(VertexBufferObject::Usage::DynamicDraw)),
+      mRectData(),
+      mTexCoordData(),
+      mLayerData(),
+      mBatches(),
+      mDrawCalls(0U),
+      mQuads(0U) {
+  // both programs compile concurrently, each is linked once
+  mProgram->build({{GL_VERTEX_SHADER, QuadVertexShader},
+                   {GL_FRAGMENT_SHADER, fragmentShader(false)}},
+                  false);
+  mArrayProgram->build({{GL_VERTEX_SHADER, QuadVertexShader},
+                        {GL_FRAGMENT_SHADER, fragmentShader(true)}},
+                       false);
+  mProgram->finish();
+  mArrayProgram->finish();
+
+  // the layout of the instance buffers stays the same, only their content is
+  // replaced on each flush
+  const std::vector<vec4f> initial = {{0.0F, 0.0F, 0.0F, 0.0F}};
+  mRects->createBuffer(initial);
+  mTexCoords->createBuffer(initial);
+  mLayers->createBuffer(std::vector<std::array<float, 1U>>{{0.0F}});
+  mVao->addVertexBufferObject(0U, mRects, 1U);
+  mVao->addVertexBufferObject(1U, mTexCoords, 1U);
+  mVao->addVertexBufferObject(2U, mLayers, 1U);
+}
+
+QuadRenderer::~QuadRenderer() = default;
+
+void QuadRenderer::add(const Texture2d& texture, float posX, float posY,
+                       float width, float height, const vec4f& texCoords) {
+  addQuad(texture.getId(), false, texture.getBarrierTracker(), 0U, posX, posY,
+          width, height, texCoords);
+}
+
+void QuadRenderer::add(const Texture2dArray& texture, uint32_t layer,
+                       float posX, float posY, float width, float height,
+                       const vec4f& texCoords) {
+  addQuad(texture.getId(), true, texture.getBarrierTracker(), layer, posX,
+          posY, width, height, texCoords);
+}
+
+void QuadRenderer::add(const TextureAtlas& atlas,
+                       const TextureAtlas::Region& region, float posX,
+                       float posY, float width, float height) {
+  const auto& texture = atlas.getTexture();
+  addQuad(texture->getId(), true, texture->getBarrierTracker(), region.layer,
+          posX, posY, width, height, region.texCoords);
+}
+
+void QuadRenderer::addQuad(uint32_t texture, bool isArray,
+                           const std::shared_ptr<BarrierTracker>& tracker,
+                           uint32_t layer, float posX, float posY, float width,
+                           float height, const vec4f& texCoords) {
+  const auto index = static_cast<uint32_t>(mRectData.size());
+  mRectData.push_back({posX, posY, width, height});
+  mTexCoordData.push_back(texCoords);
+  mLayerData.push_back({static_cast<float>(layer)});
+
+  // consecutive quads of the same texture share one draw call
+  if (mBatches.empty() || (mBatches.back().texture != texture) ||
+      (mBatches.back().isArray != isArray)) {
+    mBatches.push_back({texture, isArray, index, 0U, tracker});
+  }
+  mBatches.back().count++;
+}
+
+void QuadRenderer::flush(bool convert_sRGB) {
+  mDrawCalls = 0U;
+  mQuads     = static_cast<uint32_t>(mRectData.size());
+  if (mBatches.empty()) {
+    return;
+  }
+
+  mRects->createBuffer(mRectData);
+  mTexCoords->createBuffer(mTexCoordData);
+  mLayers->createBuffer(mLayerData);
+
+  // textures written by shaders have to be visible to the fetches
+  std::vector<BarrierTracker*> trackers;
+  for (const auto& batch : mBatches) {
+    if (batch.tracker) {
+      batch.tracker->useTexture(batch.texture,
+                                BarrierTracker::Access::TextureFetch, false);
+      if (std::find(trackers.begin(), trackers.end(), batch.tracker.get()) ==
+          trackers.end()) {
+        trackers.push_back(batch.tracker.get());
+      }
+    }
+  }
+  for (auto* tracker : trackers) {
+    tracker->flush();
+  }
+
+  std::array<int32_t, 4U> viewport{};
+  glGetIntegerv(GL_VIEWPORT, viewport.data());
+  const auto left   = static_cast<float>(viewport[0U]);
+  const auto top    = static_cast<float>(viewport[1U]);
+  const auto right  = left + static_cast<float>(viewport[2U]);
+  const auto bottom = top + static_cast<float>(viewport[3U]);
+
+  const auto projectionMatrix =
+    projection::ortho<float>(left, right, bottom, top, -1.0F, 1.0F);
+
+  const auto depthTest = glIsEnabled(GL_DEPTH_TEST);
+  glDisable(GL_DEPTH_TEST);
+  {
+    const auto vaoBinder = Binder(mVao);
+    const GlslRenderingPipelineProgram* bound = nullptr;
+    for (const auto& batch : mBatches) {
+      const auto& program = batch.isArray ? mArrayProgram : mProgram;
+      if (program.get() != bound) {
+        program->bind(true);
+        program->setMatrix("projection", projectionMatrix);
+        program->seti("image", 0);
+        program->seti("convertSRGB", convert_sRGB ? 1 : 0);
+        bound = program.get();
+      }
+      glBindTextureUnit(0U, batch.texture);
+      mVao->renderInstanced(DrawMode::TriangleStrip, 0U, 4U, batch.count,
+                            batch.first);
+      mDrawCalls++;
+    }
+    glBindTextureUnit(0U, 0U);
+    mProgram->bind(false);
+  }
+  if (depthTest == GL_TRUE) {
+    glEnable(GL_DEPTH_TEST);
+  }
+
+  mRectData.clear();
+  mTexCoordData.clear();
+  mLayerData.clear();
+  mBatches.clear();
+}
+
+uint32_t QuadRenderer::getDrawCallCount() const {
+  return mDrawCalls;
+}
+
+uint32_t QuadRenderer::getQuadCount() const {
+  return mQuads;
+}
+
+}  // namespace prgl
@@ -0,0 +1,87 @@
+#include "prgl/ReadbackQueue.hxx"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace prgl {
+
+ReadbackQueue::ReadbackQueue(GLenum target, std::size_t slotSize,
+                             uint32_t depth)
+    : mRing(std::make_unique<PersistentBufferRing>(
+        target, slotSize, depth, PersistentBufferRing::Access::Read)),
+      mPending() {}
+
+ReadbackQueue::~ReadbackQueue() {
+  // do not leave broken promises behind
+  finish();
+}
+
+std::future<std::vector<uint8_t>> ReadbackQueue::enqueue(
+  std::size_t nBytes, const CopyCommand& copy, Callback callback) {
+  if (nBytes > mRing->getSlotSize()) {
+    throw std::invalid_argument(
+      "ReadbackQueue::enqueue: readback exceeds the slot size");
+  }
+
+  // the slot about to be reused still holds the oldest result
+  if (mPending.size() >= mRing->getSlotCount()) {
+    deliverOldest();
+  }
+
+  const auto slot = mRing->acquire();
+  mRing->bind(true);
+  copy(mRing->getSlotOffset(slot));
+  mRing->bind(false);
+  mRing->fence(slot);
+
+  Pending pending{slot, nBytes, std::promise<std::vector<uint8_t>>(),
+                  std::move(callback)};
+  auto future = pending.promise.get_future();
+  mPending.push_back(std::move(pending));
+  return future;
+}
+
+uint32_t ReadbackQueue::poll() {
+  auto delivered = 0U;
+  while (!mPending.empty() && mRing->isSignaled(mPending.front().slot)) {
+    deliverOldest();
+    delivered++;
+  }
+  return delivered;
+}
+
+void ReadbackQueue::finish() {
+  while (!mPending.empty()) {
+    deliverOldest();
+  }
+}
+
+void ReadbackQueue::deliverOldest() {
+  auto pending = std::move(mPending.front());
+  mPending.pop_front();
+
+  mRing->wait(pending.slot);
+
+  const auto* src =
+    static_cast<const uint8_t*>(mRing->getMappedSlot(pending.slot));
+  std::vector<uint8_t> data(src, src + pending.nBytes);
+
+  if (pending.callback) {
+    pending.callback(data);
+  }
+  pending.promise.set_value(std::move(data));
+}
+
+uint32_t ReadbackQueue::getPendingCount() const {
+  return static_cast<uint32_t>(mPending.size());
+}
+
+uint32_t ReadbackQueue::getDepth() const {
+  return mRing->getSlotCount();
+}
+
+std::size_t ReadbackQueue::getSlotSize() const {
+  return mRing->getSlotSize();
+}
+
+}  // namespace prgl
@@ -0,0 +1,131 @@
+#include "prgl/RectanglePacker.hxx"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+namespace prgl {
+
+RectanglePacker::RectanglePacker(uint32_t width, uint32_t height)
+    : mWidth(width), mHeight(height), mUsedArea(0U), mSkyline() {
+  clear();
+}
+
+void RectanglePacker::clear() {
+  mUsedArea = 0U;
+  mSkyline.clear();
+  mSkyline.push_back({0U, 0U, mWidth});
+}
+
+/**
+ * @brief Lowest y the rectangle can be placed at when its left edge is aligned
+ * with the skyline node at index.
+ */
+std::optional<uint32_t> RectanglePacker::fit(std::size_t index, uint32_t width,
+                                             uint32_t height) const {
+  const auto x = mSkyline[index].x;
+  if ((x + width) > mWidth) {
+    return std::nullopt;
+  }
+
+  auto y         = 0U;
+  auto widthLeft = width;
+  for (auto i = index; widthLeft > 0U; i++) {
+    if (i >= mSkyline.size()) {
+      return std::nullopt;
+    }
+    y = std::max(y, mSkyline[i].y);
+    if ((y + height) > mHeight) {
+      return std::nullopt;
+    }
+    widthLeft -= std::min(widthLeft, mSkyline[i].width);
+  }
+  return y;
+}
+
+std::optional<RectanglePacker::Rect> RectanglePacker::insert(uint32_t width,
+                                                             uint32_t height) {
+  if ((width == 0U) || (height == 0U)) {
+    return std::nullopt;
+  }
+
+  auto bestIndex = mSkyline.size();
+  auto bestTop   = std::numeric_limits<uint32_t>::max();
+  auto bestWidth = std::numeric_limits<uint32_t>::max();
+  auto bestY     = 0U;
+  for (auto i = std::size_t{0U}; i < mSkyline.size(); i++) {
+    const auto y = fit(i, width, height);
+    if (!y) {
+      continue;
+    }
+    const auto top = *y + height;
+    // bottom-left: lowest top edge first, then the tighter node
+    if ((top < bestTop) ||
+        ((top == bestTop) && (mSkyline[i].width < bestWidth))) {
+      bestIndex = i;
+      bestTop   = top;
+      bestWidth = mSkyline[i].width;
+      bestY     = *y;
+    }
+  }
+  if (bestIndex == mSkyline.size()) {
+    return std::nullopt;
+  }
+
+  const Rect rect{mSkyline[bestIndex].x, bestY, width, height};
+  addSkylineLevel(bestIndex, rect);
+  mUsedArea += static_cast<uint64_t>(width) * height;
+  return rect;
+}
+
+void RectanglePacker::addSkylineLevel(std::size_t index, const Rect& rect) {
+  mSkyline.insert(mSkyline.begin() + static_cast<std::ptrdiff_t>(index),
+                  {rect.x, rect.y + rect.height, rect.width});
+
+  // cut away the parts of the following nodes now covered by the new one
+  for (auto i = index + 1U; i < mSkyline.size();) {
+    const auto& previous   = mSkyline[i - 1U];
+    auto& node             = mSkyline[i];
+    const auto previousEnd = previous.x + previous.width;
+    if (node.x >= previousEnd) {
+      break;
+    }
+    const auto shrink = previousEnd - node.x;
+    if (node.width <= shrink) {
+      mSkyline.erase(mSkyline.begin() + static_cast<std::ptrdiff_t>(i));
+      continue;
+    }
+    node.x += shrink;
+    node.width -= shrink;
+    break;
+  }
+
+  // merge neighbours of equal height
+  for (auto i = std::size_t{0U}; (i + 1U) < mSkyline.size();) {
+    if (mSkyline[i].y == mSkyline[i + 1U].y) {
+      mSkyline[i].width += mSkyline[i + 1U].width;
+      mSkyline.erase(mSkyline.begin() + static_cast<std::ptrdiff_t>(i + 1U));
+    } else {
+      i++;
+    }
+  }
+}
+
+uint32_t RectanglePacker::getWidth() const {
+  return mWidth;
+}
+
+uint32_t RectanglePacker::getHeight() const {
+  return mHeight;
+}
+
+float RectanglePacker::getOccupancy() const {
+  const auto area = static_cast<uint64_t>(mWidth) * mHeight;
+  if (area == 0U) {
+    return 0.0F;
+  }
+  return static_cast<float>(static_cast<double>(mUsedArea) /
+                            static_cast<double>(area));
+}
+
+}  // namespace prgl
@@ -0,0 +1,178 @@
+#include "prgl/RenderTargetPool.hxx"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace prgl {
+
+bool RenderTargetPool::Descriptor::operator==(const Descriptor& other) const {
+  return (width == other.width) && (height == other.height) &&
+         (internalFormat == other.internalFormat) && (levels == other.levels);
+}
+
+std::size_t RenderTargetPool::DescriptorHash::operator()(
+  const Descriptor& descriptor) const {
+  auto seed         = std::hash<uint32_t>{}(descriptor.width);
+  const auto append = [&seed](std::size_t value) {
+    seed ^= value + 0x9e3779b9U + (seed << 6U) + (seed >> 2U);
+  };
+  append(std::hash<uint32_t>{}(descriptor.height));
+  append(std::hash<uint32_t>{}(
+    static_cast<uint32_t>(descriptor.internalFormat)));
+  append(std::hash<uint32_t>{}(descriptor.levels));
+  return seed;
+}
+
+RenderTargetPool::RenderTargetPool(uint32_t maxIdleFrames)
+    : mMaxIdleFrames(maxIdleFrames),
+      mFrame(0U),
+      mAvailable(),
+      mInUse(),
+      mStatistics() {}
+
+RenderTargetPool::~RenderTargetPool() = default;
+
+std::shared_ptr<FrameBufferObject> RenderTargetPool::acquire(
+  const Descriptor& requested) {
+  reclaim();
+
+  const auto descriptor                     = normalize(requested);
+  std::shared_ptr<FrameBufferObject> target = nullptr;
+
+  auto it = mAvailable.find(descriptor);
+  if ((it != mAvailable.end()) && !it->second.empty()) {
+    // most recently released first, its memory is likely still resident
+    target = it->second.back().target;
+    it->second.pop_back();
+    mStatistics.hits++;
+  } else {
+    target = createTarget(descriptor);
+    mStatistics.misses++;
+  }
+
+  // the handle owns the target too but has its own reference count, the pool
+  // sees it expire when the user drops it
+  std::shared_ptr<FrameBufferObject> handle(target.get(),
+                                            [target](FrameBufferObject*) {});
+  mInUse.push_back({target, handle, descriptor});
+  return handle;
+}
+
+std::shared_ptr<FrameBufferObject> RenderTargetPool::acquire(
+  uint32_t width, uint32_t height, TextureFormatInternal internalFormat,
+  uint32_t levels) {
+  return acquire(Descriptor{width, height, internalFormat, levels});
+}
+
+void RenderTargetPool::release(
+  const std::shared_ptr<FrameBufferObject>& target) {
+  if (target == nullptr) {
+    return;
+  }
+  const auto it = std::find_if(
+    mInUse.begin(), mInUse.end(),
+    [&target](const Lease& lease) { return lease.target == target; });
+  if (it == mInUse.end()) {
+    throw std::invalid_argument(
+      "RenderTargetPool::release: target was not acquired from this pool");
+  }
+  mAvailable[it->descriptor].push_back({it->target, mFrame});
+  mInUse.erase(it);
+}
+
+void RenderTargetPool::reclaim() {
+  for (auto it = mInUse.begin(); it != mInUse.end();) {
+    if (it->handle.expired()) {
+      mAvailable[it->descriptor].push_back({it->target, mFrame});
+      it = mInUse.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void RenderTargetPool::nextFrame() {
+  reclaim();
+  mFrame++;
+  for (auto it = mAvailable.begin(); it != mAvailable.end();) {
+    auto& entries       = it->second;
+    const auto idleTest = [this](const Entry& entry) {
+      return (mFrame - entry.releaseFrame) > mMaxIdleFrames;
+    };
+    const auto end = std::remove_if(entries.begin(), entries.end(), idleTest);
+    mStatistics.evictions +=
+      static_cast<uint64_t>(std::distance(end, entries.end()));
+    entries.erase(end, entries.end());
+
+    if (entries.empty()) {
+      it = mAvailable.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void RenderTargetPool::clear() {
+  for (const auto& available : mAvailable) {
+    mStatistics.evictions += available.second.size();
+  }
+  mAvailable.clear();
+}
+
+RenderTargetPool::Statistics RenderTargetPool::getStatistics() const {
+  auto statistics      = mStatistics;
+  statistics.available = 0U;
+  statistics.inUse     = 0U;
+  for (const auto& available : mAvailable) {
+    statistics.available += static_cast<uint32_t>(available.second.size());
+  }
+  // dropped targets count as available before they are reclaimed
+  for (const auto& lease : mInUse) {
+    if (lease.handle.expired()) {
+      statistics.available++;
+    } else {
+      statistics.inUse++;
+    }
+  }
+  return statistics;
+}
+
+void RenderTargetPool::resetStatistics() {
+  mStatistics = Statistics();
+}
+
+RenderTargetPool::Descriptor RenderTargetPool::normalize(
+  const Descriptor& descriptor) {
+  auto normalized      = descriptor;
+  const auto fullChain = getMipLevelCount(descriptor.width, descriptor.height);
+  if ((normalized.levels == 0U) || (normalized.levels > fullChain)) {
+    normalized.levels = fullChain;
+  }
+  return normalized;
+}
+
+std::shared_ptr<FrameBufferObject> RenderTargetPool::createTarget(
+  const Descriptor& descriptor) const {
+  if (!isSizedFormat(descriptor.internalFormat)) {
+    throw std::invalid_argument(
+      "RenderTargetPool: render targets require a sized internal format");
+  }
+  if ((descriptor.width == 0U) || (descriptor.height == 0U)) {
+    throw std::invalid_argument(
+      "RenderTargetPool: render target size must not be zero");
+  }
+
+  auto texture = Texture2d::Create(
+    descriptor.width, descriptor.height, descriptor.internalFormat,
+    TextureFormat::Rgba, DataType::Float, TextureMinFilter::Linear,
+    TextureMagFilter::Linear, TextureEnvMode::Replace,
+    TextureWrapMode::ClampToEdge, descriptor.levels > 1U);
+  texture->allocate(descriptor.levels);
+
+  auto target = FrameBufferObject::Create();
+  target->attachTexture(texture);
+  return target;
+}
+
+}  // namespace prgl
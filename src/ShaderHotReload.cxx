@@ -0,0 +1,247 @@
+#include "prgl/ShaderHotReload.hxx"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#define PRGL_HAS_INOTIFY
+#endif
+
+namespace prgl {
+
+namespace {
+// how long the worker waits for file events before checking for shutdown
+constexpr int PollTimeoutMs = 100;
+// editors write in several steps, wait for the burst to end
+constexpr auto SettleTime = std::chrono::milliseconds(50);
+}  // namespace
+
+ShaderHotReload::ShaderHotReload(
+  std::shared_ptr<ShaderPreprocessor> preprocessor)
+    : mPreprocessor(std::move(preprocessor)),
+      mWorkerContext(nullptr),
+      mNotify(-1),
+      mDirectories(),
+      mEntries(),
+      mFinished(),
+      mMutex(),
+      mRunning(false),
+      mWorker() {
+#if defined(PRGL_HAS_INOTIFY)
+  auto* renderContext = glfwGetCurrentContext();
+  if (renderContext == nullptr) {
+    throw std::runtime_error(
+      "ShaderHotReload: no current context to share objects with");
+  }
+  mNotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (mNotify < 0) {
+    throw std::runtime_error("ShaderHotReload: inotify is not available");
+  }
+
+  // windows have to be created on the main thread, the hidden one only
+  // provides the worker context
+  glfwDefaultWindowHints();
+  glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+  mWorkerContext = glfwCreateWindow(1, 1, "", nullptr, renderContext);
+  glfwDefaultWindowHints();
+  if (mWorkerContext == nullptr) {
+    close(mNotify);
+    throw std::runtime_error(
+      "ShaderHotReload: could not create the worker context");
+  }
+
+  mRunning = true;
+  mWorker  = std::thread(&ShaderHotReload::run, this);
+#else
+  throw std::runtime_error(
+    "ShaderHotReload: file watching is not supported on this platform");
+#endif
+}
+
+ShaderHotReload::~ShaderHotReload() {
+  mRunning = false;
+  if (mWorker.joinable()) {
+    mWorker.join();
+  }
+#if defined(PRGL_HAS_INOTIFY)
+  if (mNotify >= 0) {
+    close(mNotify);
+    mNotify = -1;
+  }
+#endif
+  if (mWorkerContext != nullptr) {
+    glfwDestroyWindow(mWorkerContext);
+    mWorkerContext = nullptr;
+  }
+}
+
+std::shared_ptr<const ShaderHotReload::Program> ShaderHotReload::watch(
+  const std::map<uint32_t, std::string>& files) {
+  auto entry   = std::make_shared<Entry>();
+  entry->files = files;
+  // the first build happens here, errors are thrown like for any program
+  auto program   = build(files, entry->dependencies);
+  entry->program = std::make_shared<Program>(Program{program, 0U});
+
+  std::lock_guard<std::mutex> lock(mMutex);
+  addWatches(entry->dependencies);
+  mEntries.push_back(entry);
+  return entry->program;
+}
+
+uint32_t ShaderHotReload::update() {
+  decltype(mFinished) finished;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    finished.swap(mFinished);
+  }
+  for (auto& swap : finished) {
+    swap.first->program = std::move(swap.second);
+    swap.first->generation++;
+  }
+  return static_cast<uint32_t>(finished.size());
+}
+
+const std::shared_ptr<ShaderPreprocessor>& ShaderHotReload::getPreprocessor()
+  const {
+  return mPreprocessor;
+}
+
+/**
+ * @brief Preprocess, compile and link, dependencies receives the files the
+ * program was built from even if compiling fails.
+ */
+std::shared_ptr<GlslRenderingPipelineProgram> ShaderHotReload::build(
+  const std::map<uint32_t, std::string>& files,
+  std::vector<std::string>& dependencies) const {
+  std::map<uint32_t, std::string> sources;
+  std::vector<std::string> used;
+  for (const auto& file : files) {
+    auto result         = mPreprocessor->process(file.second);
+    sources[file.first] = std::move(result.source);
+    used.insert(used.end(), result.files.begin(), result.files.end());
+  }
+  std::sort(used.begin(), used.end());
+  used.erase(std::unique(used.begin(), used.end()), used.end());
+  dependencies = std::move(used);
+
+  auto program = GlslRenderingPipelineProgram::Create();
+  program->build(sources);
+  return program;
+}
+
+/**
+ * @brief Watch the directories of the files, editors often replace a file
+ * instead of writing to it, which a watch on the file itself would miss.
+ */
+void ShaderHotReload::addWatches(const std::vector<std::string>& files) {
+#if defined(PRGL_HAS_INOTIFY)
+  for (const auto& file : files) {
+    const auto directory = std::filesystem::path(file).parent_path().string();
+    const auto watch     = inotify_add_watch(mNotify, directory.c_str(),
+                                         IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (watch < 0) {
+      std::cerr << "ShaderHotReload: cannot watch " << directory << std::endl;
+      continue;
+    }
+    mDirectories[watch] = directory;
+  }
+#else
+  static_cast<void>(files);
+#endif
+}
+
+// canonical paths of the files changed since the last call
+std::vector<std::string> ShaderHotReload::readChanges() const {
+  std::vector<std::string> changed;
+#if defined(PRGL_HAS_INOTIFY)
+  alignas(inotify_event) char buffer[4096];
+  for (;;) {
+    const auto length = read(mNotify, buffer, sizeof(buffer));
+    if (length <= 0) {
+      break;
+    }
+    for (auto offset = 0L; offset < length;) {
+      const auto* event =
+        reinterpret_cast<const inotify_event*>(buffer + offset);
+      offset += static_cast<long>(sizeof(inotify_event) + event->len);
+      if (event->len == 0U) {
+        continue;
+      }
+      std::lock_guard<std::mutex> lock(mMutex);
+      const auto directory = mDirectories.find(event->wd);
+      if (directory != mDirectories.end()) {
+        changed.push_back(std::filesystem::weakly_canonical(
+                            std::filesystem::path(directory->second) /
+                            event->name)
+                            .string());
+      }
+    }
+  }
+#endif
+  return changed;
+}
+
+void ShaderHotReload::run() {
+#if defined(PRGL_HAS_INOTIFY)
+  glfwMakeContextCurrent(mWorkerContext);
+
+  while (mRunning) {
+    pollfd descriptor{mNotify, POLLIN, 0};
+    if (poll(&descriptor, 1U, PollTimeoutMs) <= 0) {
+      continue;
+    }
+    std::this_thread::sleep_for(SettleTime);
+    const auto changed = readChanges();
+    for (const auto& file : changed) {
+      mPreprocessor->invalidate(file);
+    }
+
+    std::vector<std::shared_ptr<Entry>> affected;
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      for (const auto& entry : mEntries) {
+        const auto& dependencies = entry->dependencies;
+        if (std::any_of(changed.begin(), changed.end(),
+                        [&dependencies](const std::string& file) {
+                          return std::binary_search(dependencies.begin(),
+                                                    dependencies.end(), file);
+                        })) {
+          affected.push_back(entry);
+        }
+      }
+    }
+
+    for (const auto& entry : affected) {
+      std::vector<std::string> dependencies;
+      std::shared_ptr<GlslRenderingPipelineProgram> program;
+      try {
+        program = build(entry->files, dependencies);
+        // the render context may only use the program once it is complete
+        glFinish();
+      } catch (const std::exception& e) {
+        std::cerr << "ShaderHotReload: keeping the previous program\n"
+                  << e.what() << std::endl;
+      }
+
+      std::lock_guard<std::mutex> lock(mMutex);
+      if (!dependencies.empty()) {
+        entry->dependencies = dependencies;
+        addWatches(dependencies);
+      }
+      if (program) {
+        mFinished.emplace_back(entry->program, std::move(program));
+      }
+    }
+  }
+
+  glfwMakeContextCurrent(nullptr);
+#endif
+}
+
+}  // namespace prgl
@@ -0,0 +1,166 @@
+#include "prgl/ShaderPreprocessor.hxx"
+
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "prgl/GlslProgram.hxx"
+
+namespace prgl {
+
+namespace {
+std::string canonical(const std::string& path) {
+  return std::filesystem::weakly_canonical(std::filesystem::path(path))
+    .string();
+}
+
+std::string trimLeft(const std::string& line) {
+  const auto first = line.find_first_not_of(" \t");
+  return (first == std::string::npos) ? std::string() : line.substr(first);
+}
+
+// true for "#  directive", the rest of the line is stored in argument
+bool isDirective(const std::string& line, const std::string& directive,
+                 std::string& argument) {
+  const auto trimmed = trimLeft(line);
+  if (trimmed.empty() || (trimmed[0U] != '#')) {
+    return false;
+  }
+  const auto rest = trimLeft(trimmed.substr(1U));
+  if (rest.compare(0U, directive.size(), directive) != 0) {
+    return false;
+  }
+  argument = trimLeft(rest.substr(directive.size()));
+  return true;
+}
+
+bool hasPragmaOnce(const std::string& content) {
+  std::istringstream lines(content);
+  std::string line;
+  std::string argument;
+  while (std::getline(lines, line)) {
+    if (isDirective(line, "pragma", argument) &&
+        (argument.compare(0U, 4U, "once") == 0)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// source string number of a file, a new one if it was not included before
+std::size_t getFileIndex(const std::vector<std::string>& files,
+                         const std::string& path) {
+  return static_cast<std::size_t>(
+    std::find(files.begin(), files.end(), path) - files.begin());
+}
+}  // namespace
+
+ShaderPreprocessor::ShaderPreprocessor(std::vector<std::string> includePaths)
+    : mIncludePaths(std::move(includePaths)), mFiles(), mMutex() {}
+
+ShaderPreprocessor::~ShaderPreprocessor() = default;
+
+ShaderPreprocessor::Result ShaderPreprocessor::process(
+  const std::string& filename) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  Result result;
+  std::vector<std::string> stack;
+  expand(canonical(filename), result, stack);
+  return result;
+}
+
+void ShaderPreprocessor::invalidate(const std::string& filename) {
+  std::lock_guard<std::mutex> lock(mMutex);
+  mFiles.erase(canonical(filename));
+}
+
+void ShaderPreprocessor::clear() {
+  std::lock_guard<std::mutex> lock(mMutex);
+  mFiles.clear();
+}
+
+const std::string& ShaderPreprocessor::read(const std::string& path) {
+  auto it = mFiles.find(path);
+  if (it == mFiles.end()) {
+    it = mFiles.emplace(path, GlslProgram::ReadShaderFromFile(path)).first;
+  }
+  return it->second;
+}
+
+std::string ShaderPreprocessor::resolve(const std::string& name,
+                                        const std::string& includer,
+                                        bool quoted) const {
+  if (quoted) {
+    const auto local = std::filesystem::path(includer).parent_path() / name;
+    if (std::filesystem::exists(local)) {
+      return canonical(local.string());
+    }
+  }
+  for (const auto& includePath : mIncludePaths) {
+    const auto candidate = std::filesystem::path(includePath) / name;
+    if (std::filesystem::exists(candidate)) {
+      return canonical(candidate.string());
+    }
+  }
+  throw std::runtime_error("ShaderPreprocessor: cannot find " + name +
+                           " included from " + includer);
+}
+
+void ShaderPreprocessor::expand(const std::string& path, Result& result,
+                                std::vector<std::string>& stack) {
+  if (std::find(stack.begin(), stack.end(), path) != stack.end()) {
+    throw std::runtime_error("ShaderPreprocessor: " + path +
+                             " includes itself");
+  }
+
+  const auto index      = getFileIndex(result.files, path);
+  const auto& content   = read(path);
+  const auto pragmaOnce = hasPragmaOnce(content);
+  if (index < result.files.size()) {
+    if (pragmaOnce) {
+      return;
+    }
+  } else {
+    result.files.push_back(path);
+  }
+
+  stack.push_back(path);
+  std::istringstream lines(content);
+  std::string line;
+  std::string argument;
+  auto number = 0U;
+  while (std::getline(lines, line)) {
+    number++;
+    if (pragmaOnce && isDirective(line, "pragma", argument) &&
+        (argument.compare(0U, 4U, "once") == 0)) {
+      // keep the line count
+      result.source += "\n";
+      continue;
+    }
+    if (!isDirective(line, "include", argument)) {
+      result.source += line + "\n";
+      continue;
+    }
+
+    const auto quoted = !argument.empty() && (argument[0U] == '"');
+    const auto close  = argument.find(quoted ? '"' : '>', 1U);
+    if (argument.empty() || (!quoted && (argument[0U] != '<')) ||
+        (close == std::string::npos)) {
+      throw std::runtime_error("ShaderPreprocessor: malformed #include in " +
+                               path + ":" + std::to_string(number));
+    }
+    const auto include = resolve(argument.substr(1U, close - 1U), path, quoted);
+    result.source +=
+      "#line 1 " + std::to_string(getFileIndex(result.files, include)) + "\n";
+    expand(include, result, stack);
+    // continue with the line after the #include in this file
+    result.source +=
+      "#line " + std::to_string(number + 1U) + " " + std::to_string(index) +
+      "\n";
+  }
+  stack.pop_back();
+}
+
+}  // namespace prgl
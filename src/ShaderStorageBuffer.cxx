@@ -1,115 +1,445 @@
-#include "prgl/ShaderStorageBuffer.hxx"
-
-#include <cstring>
-#include <iostream>
-
-#include "prgl/glCommon.hxx"
-
-namespace prgl {
-
-std::shared_ptr<ShaderStorageBuffer> ShaderStorageBuffer::Create() {
-  return std::make_shared<ShaderStorageBuffer>();
-}
-
-ShaderStorageBuffer::ShaderStorageBuffer() : mHandle(INVALID_HANDLE) {
-  glGenBuffers(1, &mHandle);
-}
-
-ShaderStorageBuffer::~ShaderStorageBuffer() {
-  glDeleteBuffers(1, &mHandle);
-  mHandle = INVALID_HANDLE;
-}
-
-uint32_t ShaderStorageBuffer::getSizeInBytes() const {
-  GLint64 size = 0;
-  bind(true);
-  glGetBufferParameteri64v(GL_SHADER_STORAGE_BUFFER, GL_BUFFER_SIZE, &size);
-
-  bind(false);
-  return static_cast<uint32_t>(size);
-}
-
-void ShaderStorageBuffer::create(const void* dataStart, uint32_t nBytes) {
-  bind(true);
-
-  glBufferData(GL_SHADER_STORAGE_BUFFER, nBytes, dataStart, GL_STATIC_DRAW);
-  // std::cout << "ShaderStorageBuffer::allocated:size: " << nBytes <<
-  // std::endl;
-
-  bind(false);
-}
-
-void ShaderStorageBuffer::upload(const void* dataStart, uint32_t nBytes) {
-  // check if enough bytes allocated
-  if (nBytes != static_cast<uint32_t>(getSizeInBytes())) {
-    std::cout << "ShaderStorageBuffer::reallocated:size: " << nBytes
-              << std::endl;
-    create(dataStart, nBytes);
-    return;
-  }
-
-  bind(true);
-
-  GLvoid* data = glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_WRITE_ONLY);
-
-  std::memcpy(data, dataStart, nBytes);
-
-  glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-
-  bind(false);
-}
-
-void ShaderStorageBuffer::download(void* dataStart, uint32_t nBytes) const {
-  bind(true);
-
-  void* data = glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_WRITE_ONLY);
-
-  // std::cout << "ShaderStorageBuffer::download:size: " << nBytes << std::endl;
-
-  memcpy(dataStart, data, nBytes);
-
-  glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-
-  bind(false);
-}
-
-void ShaderStorageBuffer::bind(bool bind) const {
-  if (bind) {
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, mHandle);
-  } else {
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-  }
-}
-
-void ShaderStorageBuffer::bindBase(uint32_t location) const {
-  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, location, mHandle);
-}
-
-void ShaderStorageBuffer::copyTo(ShaderStorageBuffer& other) const {
-  const auto otherSize = other.getSizeInBytes();
-  const auto thisSize  = getSizeInBytes();
-
-  int32_t cReadBuffer = 0;
-  glGetIntegerv(GL_COPY_READ_BUFFER, &cReadBuffer);
-  int32_t cWriteBuffer = 0;
-  glGetIntegerv(GL_COPY_WRITE_BUFFER, &cWriteBuffer);
-
-  if (thisSize != otherSize) {
-    other.create(nullptr, thisSize);
-  }
-
-  glBindBuffer(GL_COPY_READ_BUFFER, mHandle);
-  glBindBuffer(GL_COPY_WRITE_BUFFER, other.getHandle());
-
-  glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
-                      thisSize);
-
-  glBindBuffer(GL_COPY_READ_BUFFER, cReadBuffer);
-  glBindBuffer(GL_COPY_WRITE_BUFFER, cWriteBuffer);
-}
-
-uint32_t ShaderStorageBuffer::getHandle() const {
-  return mHandle;
-}
-
-}  // namespace prgl
+#include "prgl/ShaderStorageBuffer.hxx"
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "prgl/BarrierTracker.hxx"
+#include "prgl/glCommon.hxx"
+
+namespace prgl {
+
+std::shared_ptr<ShaderStorageBuffer> ShaderStorageBuffer::Create() {
+  return std::make_shared<ShaderStorageBuffer>();
+}
+
+std::shared_ptr<ShaderStorageBuffer> ShaderStorageBuffer::Create(
+  const std::shared_ptr<BufferHeap>& heap) {
+  return std::make_shared<ShaderStorageBuffer>(heap);
+}
+
+ShaderStorageBuffer::ShaderStorageBuffer()
+    : mHandle(INVALID_HANDLE),
+      mSize(0U),
+      mMapped(false),
+      mRing(nullptr),
+      mSlot(0U),
+      mWritten(false),
+      mUploadSlot(-1),
+      mDownloadQueue(nullptr),
+      mHeap(nullptr),
+      mAllocation({INVALID_HANDLE, 0U, 0U, 0U, 0U}),
+      mBarrierTracker(nullptr) {
+  glGenBuffers(1, &mHandle);
+}
+
+ShaderStorageBuffer::ShaderStorageBuffer(
+  const std::shared_ptr<BufferHeap>& heap)
+    : mHandle(INVALID_HANDLE),
+      mSize(0U),
+      mMapped(false),
+      mRing(nullptr),
+      mSlot(0U),
+      mWritten(false),
+      mUploadSlot(-1),
+      mDownloadQueue(nullptr),
+      mHeap(heap),
+      mAllocation({INVALID_HANDLE, 0U, 0U, 0U, 0U}),
+      mBarrierTracker(nullptr) {
+  if ((heap == nullptr) || (heap->getTarget() != GL_SHADER_STORAGE_BUFFER)) {
+    throw std::invalid_argument(
+      "ShaderStorageBuffer: heap has to be a shader storage buffer heap");
+  }
+}
+
+ShaderStorageBuffer::~ShaderStorageBuffer() {
+  if (mMapped) {
+    unmap();
+  }
+  if (mHeap != nullptr) {
+    if (mAllocation.size > 0U) {
+      mHeap->free(mAllocation);
+    }
+    return;
+  }
+  glDeleteBuffers(1, &mHandle);
+  mHandle = INVALID_HANDLE;
+}
+
+uint64_t ShaderStorageBuffer::getSizeInBytes() const {
+  return mSize;
+}
+
+void ShaderStorageBuffer::create(const void* dataStart, uint64_t nBytes) {
+  if (mUploadSlot >= 0) {
+    throw std::runtime_error(
+      "ShaderStorageBuffer::create: streaming upload in progress");
+  }
+  if (mMapped) {
+    unmap();
+  }
+  mRing.reset();
+  mWritten = false;
+  mSize    = nBytes;
+  if (mHeap != nullptr) {
+    if (mAllocation.size > 0U) {
+      mHeap->free(mAllocation);
+      mAllocation.size = 0U;
+    }
+    if (nBytes > 0U) {
+      mAllocation = mHeap->allocate(nBytes);
+      if (dataStart != nullptr) {
+        mHeap->upload(mAllocation, dataStart, nBytes);
+      }
+    }
+    return;
+  }
+  bind(true);
+
+  glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(nBytes),
+               dataStart, GL_STATIC_DRAW);
+  // std::cout << "ShaderStorageBuffer::allocated:size: " << nBytes <<
+  // std::endl;
+
+  bind(false);
+}
+
+void ShaderStorageBuffer::upload(const void* dataStart, uint64_t nBytes) {
+  if (mRing != nullptr) {
+    if (nBytes != mSize) {
+      throw std::invalid_argument(
+        "ShaderStorageBuffer::upload: size differs from the streaming slots");
+    }
+    uploadStreaming(dataStart);
+    return;
+  }
+  // check if enough bytes allocated
+  if (nBytes != getSizeInBytes()) {
+    std::cout << "ShaderStorageBuffer::reallocated:size: " << nBytes
+              << std::endl;
+    create(dataStart, nBytes);
+    return;
+  }
+
+  uploadRange(dataStart, 0U, nBytes);
+}
+
+void ShaderStorageBuffer::uploadRange(const void* dataStart, uint64_t offset,
+                                      uint64_t nBytes) {
+  checkRange("uploadRange", offset, nBytes);
+  bind(true);
+  // lets the driver stage the data instead of waiting like a mapping would
+  glBufferSubData(GL_SHADER_STORAGE_BUFFER,
+                  static_cast<GLintptr>(getOffset() + offset),
+                  static_cast<GLsizeiptr>(nBytes), dataStart);
+  bind(false);
+}
+
+void ShaderStorageBuffer::download(void* dataStart, uint64_t nBytes) const {
+  if (mBarrierTracker) {
+    mBarrierTracker->flush(*this, BarrierTracker::Access::BufferUpdate);
+  }
+  bind(true);
+
+  // the ring is not mapped for reading, read through GL in both modes
+  glGetBufferSubData(GL_SHADER_STORAGE_BUFFER,
+                     static_cast<GLintptr>(getOffset()),
+                     static_cast<GLsizeiptr>(nBytes), dataStart);
+
+  bind(false);
+}
+
+void ShaderStorageBuffer::downloadRange(void* dataStart, uint64_t offset,
+                                        uint64_t nBytes) const {
+  if (mMapped) {
+    throw std::runtime_error(
+      "ShaderStorageBuffer::downloadRange: buffer is mapped");
+  }
+  if ((offset > mSize) || (nBytes > (mSize - offset))) {
+    throw std::invalid_argument(
+      "ShaderStorageBuffer::downloadRange: range exceeds the buffer");
+  }
+  if (mBarrierTracker) {
+    mBarrierTracker->flush(*this, BarrierTracker::Access::BufferUpdate);
+  }
+  bind(true);
+  glGetBufferSubData(GL_SHADER_STORAGE_BUFFER,
+                     static_cast<GLintptr>(getOffset() + offset),
+                     static_cast<GLsizeiptr>(nBytes), dataStart);
+  bind(false);
+}
+
+void* ShaderStorageBuffer::mapRange(uint64_t offset, uint64_t nBytes,
+                                    GLbitfield access) {
+  checkRange("mapRange", offset, nBytes);
+  if (mHeap != nullptr) {
+    // heap pages are not created mappable
+    throw std::runtime_error(
+      "ShaderStorageBuffer::mapRange: not supported for heap allocations");
+  }
+  if (mBarrierTracker) {
+    // mapped reads and writes are buffer updates as well
+    mBarrierTracker->flush(*this, BarrierTracker::Access::BufferUpdate,
+                           (access & GL_MAP_WRITE_BIT) != 0U);
+  }
+  bind(true);
+  auto* data = glMapBufferRange(GL_SHADER_STORAGE_BUFFER,
+                                static_cast<GLintptr>(offset),
+                                static_cast<GLsizeiptr>(nBytes), access);
+  bind(false);
+  if (data == nullptr) {
+    throw std::runtime_error(
+      "ShaderStorageBuffer::mapRange: could not map the range");
+  }
+  mMapped = true;
+  return data;
+}
+
+void ShaderStorageBuffer::flushMappedRange(uint64_t offset,
+                                           uint64_t nBytes) const {
+  if (!mMapped) {
+    throw std::runtime_error(
+      "ShaderStorageBuffer::flushMappedRange: buffer is not mapped");
+  }
+  glFlushMappedNamedBufferRange(mHandle, static_cast<GLintptr>(offset),
+                                static_cast<GLsizeiptr>(nBytes));
+}
+
+void ShaderStorageBuffer::unmap() {
+  if (!mMapped) {
+    return;
+  }
+  glUnmapNamedBuffer(mHandle);
+  mMapped = false;
+}
+
+bool ShaderStorageBuffer::isMapped() const {
+  return mMapped;
+}
+
+/**
+ * @brief Ranged transfers and mappings work on regular buffers only, a
+ * streaming slot is always written as a whole.
+ */
+void ShaderStorageBuffer::checkRange(const char* function, uint64_t offset,
+                                     uint64_t nBytes) const {
+  const auto name = std::string("ShaderStorageBuffer::") + function;
+  if (mRing != nullptr) {
+    throw std::runtime_error(name + ": not supported while streaming");
+  }
+  if (mMapped) {
+    throw std::runtime_error(name + ": buffer is mapped");
+  }
+  if ((offset > mSize) || (nBytes > (mSize - offset))) {
+    throw std::invalid_argument(name + ": range exceeds the buffer");
+  }
+}
+
+void ShaderStorageBuffer::enableAsyncDownload(uint64_t maxBytes,
+                                              uint32_t ringDepth) {
+  if (mDownloadQueue != nullptr) {
+    mDownloadQueue->finish();
+  }
+  mDownloadQueue = std::make_unique<ReadbackQueue>(
+    GL_COPY_WRITE_BUFFER, (maxBytes > 0U) ? maxBytes : mSize, ringDepth);
+}
+
+std::future<std::vector<uint8_t>> ShaderStorageBuffer::downloadAsync(
+  uint64_t offset, uint64_t nBytes, ReadbackQueue::Callback callback) {
+  if (mDownloadQueue == nullptr) {
+    throw std::runtime_error(
+      "ShaderStorageBuffer::downloadAsync: async download is not enabled");
+  }
+  if ((offset > mSize) || (nBytes > (mSize - offset))) {
+    throw std::invalid_argument(
+      "ShaderStorageBuffer::downloadAsync: range exceeds the buffer");
+  }
+  return mDownloadQueue->enqueue(
+    nBytes,
+    [this, offset, nBytes](std::size_t stagingOffset) {
+      // shader writes have to be visible to the copy
+      if (mBarrierTracker) {
+        mBarrierTracker->flush(*this, BarrierTracker::Access::BufferUpdate);
+      } else {
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+      }
+      glBindBuffer(GL_COPY_READ_BUFFER, getHandle());
+      glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                          static_cast<GLintptr>(getOffset() + offset),
+                          static_cast<GLintptr>(stagingOffset),
+                          static_cast<GLsizeiptr>(nBytes));
+      glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    },
+    std::move(callback));
+}
+
+std::future<std::vector<uint8_t>> ShaderStorageBuffer::downloadAsync(
+  ReadbackQueue::Callback callback) {
+  return downloadAsync(0U, mSize, std::move(callback));
+}
+
+uint32_t ShaderStorageBuffer::pollDownloads() {
+  if (mDownloadQueue == nullptr) {
+    return 0U;
+  }
+  return mDownloadQueue->poll();
+}
+
+void ShaderStorageBuffer::enableStreaming(uint64_t nBytes,
+                                          uint32_t frameCount) {
+  if (mUploadSlot >= 0) {
+    throw std::runtime_error(
+      "ShaderStorageBuffer::enableStreaming: streaming upload in progress");
+  }
+  if (mHeap != nullptr) {
+    throw std::runtime_error(
+      "ShaderStorageBuffer::enableStreaming: not supported for heap "
+      "allocations");
+  }
+  int32_t alignment = 0;
+  glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+  mRing = std::make_unique<PersistentBufferRing>(
+    GL_SHADER_STORAGE_BUFFER, nBytes, frameCount,
+    PersistentBufferRing::Access::Write,
+    (alignment > 0) ? static_cast<std::size_t>(alignment) : 256U);
+  mSize    = nBytes;
+  mSlot    = mRing->getCurrentSlot();
+  mWritten = false;
+
+  // the data lives in the ring from now on
+  bind(true);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, 0, nullptr, GL_STATIC_DRAW);
+  bind(false);
+}
+
+bool ShaderStorageBuffer::isStreaming() const {
+  return mRing != nullptr;
+}
+
+/**
+ * @brief Acquire the next free slot. Blocks only if the GPU still uses all of
+ * them, frameCount - 1 frames after their upload.
+ */
+void* ShaderStorageBuffer::beginStreamingUpload() {
+  if (mRing == nullptr) {
+    throw std::runtime_error(
+      "ShaderStorageBuffer::beginStreamingUpload: streaming is not enabled");
+  }
+  if (mUploadSlot >= 0) {
+    throw std::runtime_error(
+      "ShaderStorageBuffer::beginStreamingUpload: previous upload not "
+      "finished");
+  }
+  // the commands issued since the last upload are the last users of its slot
+  if (mWritten) {
+    mRing->fence(mSlot);
+  }
+  mUploadSlot = static_cast<int32_t>(mRing->acquire());
+  return mRing->getMappedSlot(static_cast<uint32_t>(mUploadSlot));
+}
+
+void ShaderStorageBuffer::endStreamingUpload() {
+  if (mUploadSlot < 0) {
+    throw std::runtime_error(
+      "ShaderStorageBuffer::endStreamingUpload: no upload in progress");
+  }
+  // the mapping is coherent, commands issued from now on see the data
+  mSlot       = static_cast<uint32_t>(mUploadSlot);
+  mUploadSlot = -1;
+  mWritten    = true;
+}
+
+void ShaderStorageBuffer::uploadStreaming(const void* dataStart) {
+  auto* dst = beginStreamingUpload();
+  std::memcpy(dst, dataStart, mSize);
+  endStreamingUpload();
+}
+
+void ShaderStorageBuffer::bind(bool bind) const {
+  if (bind) {
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, getHandle());
+  } else {
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+  }
+}
+
+void ShaderStorageBuffer::bindBase(uint32_t location) const {
+  if ((mRing != nullptr) || ((mHeap != nullptr) && (mSize > 0U))) {
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, location, getHandle(),
+                      static_cast<GLintptr>(getOffset()),
+                      static_cast<GLsizeiptr>(mSize));
+    return;
+  }
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, location, mHandle);
+}
+
+void ShaderStorageBuffer::copyTo(ShaderStorageBuffer& other) const {
+  const auto otherSize = other.getSizeInBytes();
+  const auto thisSize  = getSizeInBytes();
+
+  int32_t cReadBuffer = 0;
+  glGetIntegerv(GL_COPY_READ_BUFFER, &cReadBuffer);
+  int32_t cWriteBuffer = 0;
+  glGetIntegerv(GL_COPY_WRITE_BUFFER, &cWriteBuffer);
+
+  if (thisSize != otherSize) {
+    other.create(nullptr, thisSize);
+  }
+  if (mBarrierTracker) {
+    mBarrierTracker->flush(*this, BarrierTracker::Access::BufferUpdate);
+  }
+  if (other.mBarrierTracker) {
+    other.mBarrierTracker->flush(other, BarrierTracker::Access::BufferUpdate,
+                                 true);
+  }
+
+  glBindBuffer(GL_COPY_READ_BUFFER, getHandle());
+  glBindBuffer(GL_COPY_WRITE_BUFFER, other.getHandle());
+
+  glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                      static_cast<GLintptr>(getOffset()),
+                      static_cast<GLintptr>(other.getOffset()),
+                      static_cast<GLsizeiptr>(thisSize));
+
+  glBindBuffer(GL_COPY_READ_BUFFER, cReadBuffer);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, cWriteBuffer);
+}
+
+uint32_t ShaderStorageBuffer::getHandle() const {
+  if (mRing != nullptr) {
+    return mRing->getHandle();
+  }
+  if ((mHeap != nullptr) && (mAllocation.size > 0U)) {
+    return mHeap->resolve(mAllocation).buffer;
+  }
+  return mHandle;
+}
+
+std::size_t ShaderStorageBuffer::getOffset() const {
+  if (mRing != nullptr) {
+    return mRing->getSlotOffset(mSlot);
+  }
+  if ((mHeap != nullptr) && (mAllocation.size > 0U)) {
+    // moves with BufferHeap::defragment
+    return mHeap->resolve(mAllocation).offset;
+  }
+  return 0U;
+}
+
+bool ShaderStorageBuffer::isHeapAllocated() const {
+  return mHeap != nullptr;
+}
+
+void ShaderStorageBuffer::setBarrierTracker(
+  const std::shared_ptr<BarrierTracker>& tracker) {
+  mBarrierTracker = tracker;
+}
+
+const std::shared_ptr<BarrierTracker>& ShaderStorageBuffer::getBarrierTracker()
+  const {
+  return mBarrierTracker;
+}
+
+}  // namespace prgl
@@ -0,0 +1,85 @@
+#include "prgl/ShaderVariantCache.hxx"
+
+#include "Hash.hxx"
+
+namespace prgl {
+
+std::shared_ptr<ShaderVariantCache> ShaderVariantCache::Create() {
+  return std::make_shared<ShaderVariantCache>();
+}
+
+ShaderVariantCache::ShaderVariantCache()
+    : mComputeShaders(), mPipelinePrograms(), mHits(0U), mMisses(0U) {}
+
+ShaderVariantCache::~ShaderVariantCache() = default;
+
+std::shared_ptr<GlslComputeShader> ShaderVariantCache::getComputeShader(
+  const std::string& source, const GlslProgram::Defines& defines) {
+  const auto key   = makeKey({{GL_COMPUTE_SHADER, source}}, defines);
+  const auto range = mComputeShaders.equal_range(key);
+  // the key is only a hash, compare the variant itself
+  for (auto it = range.first; it != range.second; ++it) {
+    if ((it->second.source == source) && (it->second.defines == defines)) {
+      mHits++;
+      return it->second.program;
+    }
+  }
+  mMisses++;
+  auto shader = GlslComputeShader::Create(source, defines);
+  mComputeShaders.emplace(key, ComputeVariant{source, defines, shader});
+  return shader;
+}
+
+std::shared_ptr<GlslRenderingPipelineProgram>
+ShaderVariantCache::getPipelineProgram(
+  const std::map<uint32_t, std::string>& sources,
+  const GlslProgram::Defines& defines, bool wait) {
+  const auto key   = makeKey(sources, defines);
+  const auto range = mPipelinePrograms.equal_range(key);
+  for (auto it = range.first; it != range.second; ++it) {
+    if ((it->second.sources == sources) && (it->second.defines == defines)) {
+      mHits++;
+      return it->second.program;
+    }
+  }
+  mMisses++;
+  auto program = GlslRenderingPipelineProgram::Create();
+  program->build(sources, defines, wait);
+  mPipelinePrograms.emplace(key, PipelineVariant{sources, defines, program});
+  return program;
+}
+
+uint64_t ShaderVariantCache::makeKey(
+  const std::map<uint32_t, std::string>& sources,
+  const GlslProgram::Defines& defines) {
+  auto hash = HashSeed;
+  for (const auto& source : sources) {
+    hash = hashBytes(hash, &source.first, sizeof(source.first));
+    hash = hashString(hash, source.second);
+  }
+  // the map is ordered, so equal sets give equal keys
+  for (const auto& define : defines) {
+    hash = hashString(hash, define.first);
+    hash = hashString(hash, define.second);
+  }
+  return hash;
+}
+
+std::size_t ShaderVariantCache::getSize() const {
+  return mComputeShaders.size() + mPipelinePrograms.size();
+}
+
+uint32_t ShaderVariantCache::getHits() const {
+  return mHits;
+}
+
+uint32_t ShaderVariantCache::getMisses() const {
+  return mMisses;
+}
+
+void ShaderVariantCache::clear() {
+  mComputeShaders.clear();
+  mPipelinePrograms.clear();
+}
+
+}  // namespace prgl
@@ -1,8 +1,39 @@
 #include "prgl/Texture2d.hxx"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "prgl/BarrierTracker.hxx"
+#include "prgl/ContextImplementation.hxx"
+#include "prgl/QuadRenderer.hxx"
 
 namespace prgl {
+
+namespace {
+/**
+ * @brief Renderer for a context that was not created by a
+ * ContextImplementation, by the current GLFW window (nullptr for contexts of
+ * other libraries). The renderers are never destroyed since their contexts may
+ * be gone at exit.
+ */
+QuadRenderer& getFallbackRenderer() {
+  static std::mutex mutex;
+  static auto& renderers =
+    *new std::unordered_map<GLFWwindow*, std::shared_ptr<QuadRenderer>>();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& renderer = renderers[glfwGetCurrentContext()];
+  if (renderer == nullptr) {
+    renderer = QuadRenderer::Create();
+  }
+  return *renderer;
+}
+}  // namespace
+
 // Create empty texture
 Texture2d::Texture2d()
     : Texture2d(0, 0, TextureFormatInternal::Rgb32F, TextureFormat::Rgb,
@@ -28,9 +59,17 @@ Texture2d::Texture2d(uint32_t width, uint32_t height,
       mMagFilter(magFilter),
       mWrap(wrapMode),
       mEnvMode(envMode),
-      mCreateMipMaps(createMipMaps),
-      mMaxAnisotropy(1.0F) {
-  glGenTextures(1, &mHandle);
+      mMaxAnisotropy(1.0F),
+      mStorageAllocated(false),
+      mImmutable(false),
+      mLevelCount(createMipMaps ? prgl::getMipLevelCount(width, height) : 1U),
+      mUploadRing(nullptr),
+      mUploadSlot(-1),
+      mDownloadQueue(nullptr),
+      mDownloadFormat(format),
+      mDownloadType(type),
+      mBarrierTracker(nullptr) {
+  glCreateTextures(mTarget, 1, &mHandle);
 }
 
 Texture2d::~Texture2d() {
@@ -39,42 +78,350 @@ Texture2d::~Texture2d() {
 }
 
 void Texture2d::upload(void* data) {
-  bind(true);
+  if (!mStorageAllocated) {
+    allocateStorage();
+  }
+
+  if (data != nullptr) {
+    if (isCompressedFormat(mInternalFormat)) {
+      uploadCompressed(
+        0U, data, getCompressedImageSize(mInternalFormat, mWidth, mHeight));
+    } else if (mImmutable) {
+      uploadRegion(0U, 0U, mWidth, mHeight, 0U, data, 0U);
+    } else {
+      // unsized internal formats cannot use immutable storage
+      bind(true);
+      glTexImage2D(mTarget, mMipLevel, static_cast<GLint>(mInternalFormat),
+                   static_cast<GLint>(mWidth), static_cast<GLint>(mHeight),
+                   static_cast<GLint>(mBorder), static_cast<GLuint>(mFormat),
+                   static_cast<GLuint>(mType), data);
+      bind(false);
+    }
+  }
+}
+
+/**
+ * @brief Update a part of a mip level of the allocated storage.
+ *
+ * @param x left column of the region.
+ * @param y bottom row of the region.
+ * @param width width of the region.
+ * @param height height of the region.
+ * @param level mip level to update.
+ * @param data pixel data in the format and type given on construction.
+ * @param rowStride number of pixels between two rows in data, 0 if the rows
+ * are tightly packed. Allows updating tiles of a larger host image in place.
+ */
+void Texture2d::uploadRegion(uint32_t x, uint32_t y, uint32_t width,
+                             uint32_t height, uint32_t level, const void* data,
+                             uint32_t rowStride) {
+  if (!mStorageAllocated) {
+    allocateStorage();
+  }
+  if (level >= mLevelCount) {
+    throw std::invalid_argument("Texture2d::uploadRegion: invalid mip level");
+  }
+  const auto levelWidth  = std::max(1U, mWidth >> level);
+  const auto levelHeight = std::max(1U, mHeight >> level);
+  if (((x + width) > levelWidth) || ((y + height) > levelHeight)) {
+    throw std::invalid_argument(
+      "Texture2d::uploadRegion: region exceeds the texture size");
+  }
+
+  int32_t alignment = 0;
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+  int32_t rowLength = 0;
+  glGetIntegerv(GL_UNPACK_ROW_LENGTH, &rowLength);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(rowStride));
+
+  glTextureSubImage2D(mHandle, static_cast<GLint>(level),
+                      static_cast<GLint>(x), static_cast<GLint>(y),
+                      static_cast<GLsizei>(width), static_cast<GLsizei>(height),
+                      static_cast<GLenum>(mFormat), static_cast<GLenum>(mType),
+                      data);
+
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+}
+
+/**
+ * @brief Update a part of a mip level of a block compressed texture. The data
+ * is uploaded as is, see BlockCompressor to encode images on the host.
+ *
+ * @param size number of bytes in data, getCompressedImageSize(format, width,
+ * height).
+ */
+void Texture2d::uploadCompressedRegion(uint32_t x, uint32_t y, uint32_t width,
+                                       uint32_t height, uint32_t level,
+                                       const void* data, std::size_t size) {
+  if (!isCompressedFormat(mInternalFormat)) {
+    throw std::invalid_argument(
+      "Texture2d::uploadCompressedRegion: texture format is not compressed");
+  }
+  if (!mStorageAllocated) {
+    allocateStorage();
+  }
+  if (level >= mLevelCount) {
+    throw std::invalid_argument(
+      "Texture2d::uploadCompressedRegion: invalid mip level");
+  }
+  const auto levelWidth  = std::max(1U, mWidth >> level);
+  const auto levelHeight = std::max(1U, mHeight >> level);
+  if (((x + width) > levelWidth) || ((y + height) > levelHeight)) {
+    throw std::invalid_argument(
+      "Texture2d::uploadCompressedRegion: region exceeds the texture size");
+  }
+  if (size < getCompressedImageSize(mInternalFormat, width, height)) {
+    throw std::invalid_argument(
+      "Texture2d::uploadCompressedRegion: not enough data for the region");
+  }
+
+  glCompressedTextureSubImage2D(
+    mHandle, static_cast<GLint>(level), static_cast<GLint>(x),
+    static_cast<GLint>(y), static_cast<GLsizei>(width),
+    static_cast<GLsizei>(height), static_cast<GLenum>(mInternalFormat),
+    static_cast<GLsizei>(size), data);
+}
+
+void Texture2d::uploadCompressed(uint32_t level, const void* data,
+                                 std::size_t size) {
+  uploadCompressedRegion(0U, 0U, std::max(1U, mWidth >> level),
+                         std::max(1U, mHeight >> level), level, data, size);
+}
+
+/**
+ * @brief Recompute all mip levels from level 0. Not done by the uploads, call
+ * it once after all dirty regions of a frame were updated.
+ */
+void Texture2d::generateMipMaps() {
+  glGenerateTextureMipmap(mHandle);
+}
+
+/**
+ * @brief Allocate the storage once. Sized internal formats get immutable
+ * storage for all mip levels, unsized formats fall back to glTexImage2D.
+ */
+void Texture2d::allocateStorage() {
+  if ((mWidth == 0U) || (mHeight == 0U)) {
+    return;
+  }
+
+  if (isSizedFormat(mInternalFormat)) {
+    glTextureStorage2D(mHandle, static_cast<GLsizei>(mLevelCount),
+                       static_cast<GLenum>(mInternalFormat),
+                       static_cast<GLsizei>(mWidth),
+                       static_cast<GLsizei>(mHeight));
+    mImmutable = true;
+  } else {
+    bind(true);
+    glTexImage2D(mTarget, mMipLevel, static_cast<GLint>(mInternalFormat),
+                 static_cast<GLint>(mWidth), static_cast<GLint>(mHeight),
+                 static_cast<GLint>(mBorder), static_cast<GLuint>(mFormat),
+                 static_cast<GLuint>(mType), nullptr);
+    bind(false);
+  }
+  mStorageAllocated = true;
 
-  glTexImage2D(mTarget, mMipLevel, static_cast<GLint>(mInternalFormat),
-               static_cast<GLint>(mWidth), static_cast<GLint>(mHeight),
-               static_cast<GLint>(mBorder), static_cast<GLuint>(mFormat),
-               static_cast<GLuint>(mType), data);
+  applyParameters();
+}
 
-  if (mCreateMipMaps) {
-    glTexParameteri(mTarget, GL_GENERATE_MIPMAP, GL_TRUE);
-    glGenerateMipmap(GL_TEXTURE_2D);
+/**
+ * @brief Allocate the storage without uploading data, with levelCount mip
+ * levels instead of the count implied by createMipMaps, e.g. for render
+ * targets.
+ *
+ * @param levelCount number of mip levels, 0 or more than the full chain
+ * allocates the full chain.
+ */
+void Texture2d::allocate(uint32_t levelCount) {
+  if (mStorageAllocated) {
+    throw std::runtime_error("Texture2d::allocate: storage is allocated");
   }
+  const auto fullChain = prgl::getMipLevelCount(mWidth, mHeight);
+  mLevelCount          = ((levelCount == 0U) || (levelCount > fullChain))
+                           ? fullChain
+                           : levelCount;
+  allocateStorage();
+}
 
-  glTexParameteri(mTarget, GL_TEXTURE_MIN_FILTER,
-                  static_cast<GLint>(mMinFilter));
-  glTexParameteri(mTarget, GL_TEXTURE_MAG_FILTER,
-                  static_cast<GLint>(mMagFilter));
+void Texture2d::applyParameters() const {
+  glTextureParameteri(mHandle, GL_TEXTURE_MIN_FILTER,
+                      static_cast<GLint>(mMinFilter));
+  glTextureParameteri(mHandle, GL_TEXTURE_MAG_FILTER,
+                      static_cast<GLint>(mMagFilter));
 
   glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, static_cast<GLint>(mEnvMode));
 
-  glTexParameteri(mTarget, GL_TEXTURE_WRAP_S, static_cast<GLint>(mWrap));
-  glTexParameteri(mTarget, GL_TEXTURE_WRAP_T, static_cast<GLint>(mWrap));
-  glTexParameteri(mTarget, GL_TEXTURE_WRAP_R, static_cast<GLint>(mWrap));
+  glTextureParameteri(mHandle, GL_TEXTURE_WRAP_S, static_cast<GLint>(mWrap));
+  glTextureParameteri(mHandle, GL_TEXTURE_WRAP_T, static_cast<GLint>(mWrap));
+  glTextureParameteri(mHandle, GL_TEXTURE_WRAP_R, static_cast<GLint>(mWrap));
+
+  glTextureParameterf(mHandle, GL_TEXTURE_MAX_ANISOTROPY_EXT, mMaxAnisotropy);
+}
+
+/**
+ * @brief Enable streaming uploads. The texture data is written directly into
+ * persistently mapped pixel unpack buffers, the transfer to the texture runs
+ * asynchronously while the next frame is prepared.
+ *
+ * @param ringSize number of frames that can be in flight.
+ */
+void Texture2d::enableStreaming(uint32_t ringSize) {
+  if (mUploadSlot >= 0) {
+    throw std::runtime_error(
+      "Texture2d::enableStreaming: streaming upload in progress");
+  }
+  mUploadRing = std::make_unique<PersistentBufferRing>(
+    GL_PIXEL_UNPACK_BUFFER, getSizeInBytes(), ringSize,
+    PersistentBufferRing::Access::Write);
+}
+
+bool Texture2d::isStreaming() const {
+  return mUploadRing != nullptr;
+}
+
+/**
+ * @brief Acquire the next free slot of the upload ring. Blocks only if all
+ * slots are still in use by the GPU.
+ *
+ * @return pointer to getSizeInBytes() bytes of mapped memory.
+ */
+void* Texture2d::beginStreamingUpload() {
+  if (mUploadRing == nullptr) {
+    throw std::runtime_error(
+      "Texture2d::beginStreamingUpload: streaming is not enabled");
+  }
+  if (mUploadSlot >= 0) {
+    throw std::runtime_error(
+      "Texture2d::beginStreamingUpload: previous upload not finished");
+  }
+  mUploadSlot = static_cast<int32_t>(mUploadRing->acquire());
+  return mUploadRing->getMappedSlot(static_cast<uint32_t>(mUploadSlot));
+}
+
+void Texture2d::endStreamingUpload() {
+  if (mUploadSlot < 0) {
+    throw std::runtime_error(
+      "Texture2d::endStreamingUpload: no upload in progress");
+  }
+  const auto slot = static_cast<uint32_t>(mUploadSlot);
+  mUploadSlot     = -1;
+
+  if (!mStorageAllocated) {
+    allocateStorage();
+  }
+  bind(true);
+
+  int32_t alignment = 0;
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  mUploadRing->bind(true);
+  // the data pointer is an offset into the bound pixel unpack buffer
+  const auto offset = mUploadRing->getSlotOffset(slot);
+  glTexSubImage2D(mTarget, mMipLevel, 0, 0, static_cast<GLsizei>(mWidth),
+                  static_cast<GLsizei>(mHeight), static_cast<GLenum>(mFormat),
+                  static_cast<GLenum>(mType),
+                  reinterpret_cast<const void*>(offset));
+  mUploadRing->bind(false);
+  // the slot can be reused as soon as the copy into the texture is done
+  mUploadRing->fence(slot);
 
-  glTexParameterf(mTarget, GL_TEXTURE_MAX_ANISOTROPY_EXT, mMaxAnisotropy);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
 
   bind(false);
 }
 
+void Texture2d::uploadStreaming(const void* data) {
+  auto* dst = beginStreamingUpload();
+  std::memcpy(dst, data, getSizeInBytes());
+  endStreamingUpload();
+}
+
+/**
+ * @brief Size of the tightly packed pixel data of a single image (format and
+ * type as given on construction).
+ */
+std::size_t Texture2d::getSizeInBytes() const {
+  return static_cast<std::size_t>(mWidth) * mHeight *
+         getChannelCount(mFormat) * prgl::getSizeInBytes(mType);
+}
+
 void Texture2d::download(void* dataPtr, const TextureFormat format,
                          const DataType type) {
+  if (mBarrierTracker) {
+    mBarrierTracker->flush(*this, BarrierTracker::Access::TextureUpdate);
+  }
   bind(true);
   glGetTexImage(GL_TEXTURE_2D, 0, static_cast<GLenum>(format),
                 static_cast<GLenum>(type), dataPtr);
   bind(false);
 }
 
+/**
+ * @brief Enable asynchronous downloads. Instead of draining the pipeline like
+ * glGetTexImage into host memory, the image is copied into a pixel pack buffer
+ * and only mapped once its fence has signalled.
+ *
+ * @param format format of the downloaded pixel data.
+ * @param type type of the downloaded pixel data.
+ * @param ringDepth number of downloads that can be in flight.
+ */
+void Texture2d::enableAsyncDownload(const TextureFormat format,
+                                    const DataType type, uint32_t ringDepth) {
+  if (mDownloadQueue != nullptr) {
+    mDownloadQueue->finish();
+  }
+  mDownloadFormat = format;
+  mDownloadType   = type;
+  mDownloadQueue  = std::make_unique<ReadbackQueue>(
+    GL_PIXEL_PACK_BUFFER,
+    static_cast<std::size_t>(mWidth) * mHeight * getChannelCount(format) *
+      prgl::getSizeInBytes(type),
+    ringDepth);
+}
+
+/**
+ * @brief Record a download of mip level 0. The returned future becomes ready
+ * (and the callback is called) from within pollDownloads once the GPU has
+ * finished the copy.
+ */
+std::future<std::vector<uint8_t>> Texture2d::downloadAsync(
+  ReadbackQueue::Callback callback) {
+  if (mDownloadQueue == nullptr) {
+    throw std::runtime_error(
+      "Texture2d::downloadAsync: async download is not enabled");
+  }
+  return mDownloadQueue->enqueue(
+    mDownloadQueue->getSlotSize(),
+    [this](std::size_t offset) {
+      int32_t alignment = 0;
+      glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+      glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+      if (mBarrierTracker) {
+        mBarrierTracker->flush(*this, BarrierTracker::Access::TextureUpdate);
+      }
+      bind(true);
+      // the data pointer is an offset into the bound pixel pack buffer
+      glGetTexImage(mTarget, 0, static_cast<GLenum>(mDownloadFormat),
+                    static_cast<GLenum>(mDownloadType),
+                    reinterpret_cast<void*>(offset));
+      bind(false);
+
+      glPixelStorei(GL_PACK_ALIGNMENT, alignment);
+    },
+    std::move(callback));
+}
+
+uint32_t Texture2d::pollDownloads() {
+  if (mDownloadQueue == nullptr) {
+    return 0U;
+  }
+  return mDownloadQueue->poll();
+}
+
 void Texture2d::bind(bool bind) const {
   if (bind) {
     glBindTexture(mTarget, mHandle);
@@ -102,6 +449,15 @@ void Texture2d::bindImageTexture(uint32_t unit, TextureAccess access,
                      static_cast<uint32_t>(mInternalFormat));
 }
 
+void Texture2d::setBarrierTracker(
+  const std::shared_ptr<BarrierTracker>& tracker) {
+  mBarrierTracker = tracker;
+}
+
+const std::shared_ptr<BarrierTracker>& Texture2d::getBarrierTracker() const {
+  return mBarrierTracker;
+}
+
 uint32_t Texture2d::getId() const {
   return mHandle;
 }
@@ -146,26 +502,23 @@ TextureEnvMode Texture2d::getEnvMode() const {
   return mEnvMode;
 }
 
+uint32_t Texture2d::getMipLevelCount() const {
+  return mLevelCount;
+}
+
 void Texture2d::setWrapMode(TextureWrapMode wrap) {
   mWrap = wrap;
 
-  bind(true);
-
-  glTexParameteri(mTarget, GL_TEXTURE_WRAP_S, static_cast<GLint>(mWrap));
-  glTexParameteri(mTarget, GL_TEXTURE_WRAP_T, static_cast<GLint>(mWrap));
-  glTexParameteri(mTarget, GL_TEXTURE_WRAP_R, static_cast<GLint>(mWrap));
-
-  bind(false);
+  glTextureParameteri(mHandle, GL_TEXTURE_WRAP_S, static_cast<GLint>(mWrap));
+  glTextureParameteri(mHandle, GL_TEXTURE_WRAP_T, static_cast<GLint>(mWrap));
+  glTextureParameteri(mHandle, GL_TEXTURE_WRAP_R, static_cast<GLint>(mWrap));
 }
 
 void Texture2d::setEnvMode(TextureEnvMode envMode) {
   mEnvMode = envMode;
 
-  bind(true);
-
+  // texture environment is state of the active texture unit
   glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, static_cast<GLint>(mEnvMode));
-
-  bind(false);
 }
 
 void Texture2d::setFilter(TextureMinFilter minFilter,
@@ -173,102 +526,51 @@ void Texture2d::setFilter(TextureMinFilter minFilter,
   mMinFilter = minFilter;
   mMagFilter = magFilter;
 
-  bind(true);
-
-  glTexParameteri(mTarget, GL_TEXTURE_MIN_FILTER,
-                  static_cast<GLint>(mMinFilter));
-  glTexParameteri(mTarget, GL_TEXTURE_MAG_FILTER,
-                  static_cast<GLint>(mMagFilter));
-
-  bind(false);
+  glTextureParameteri(mHandle, GL_TEXTURE_MIN_FILTER,
+                      static_cast<GLint>(mMinFilter));
+  glTextureParameteri(mHandle, GL_TEXTURE_MAG_FILTER,
+                      static_cast<GLint>(mMagFilter));
 }
 
 void Texture2d::setMaxIsotropy(float anisotropy) {
   mMaxAnisotropy = anisotropy;
 
-  bind(true);
-
-  glTexParameterf(mTarget, GL_TEXTURE_MAX_ANISOTROPY_EXT, mMaxAnisotropy);
-
-  bind(false);
+  glTextureParameterf(mHandle, GL_TEXTURE_MAX_ANISOTROPY_EXT, mMaxAnisotropy);
 }
 
+/**
+ * @brief Draw the texture into the current viewport. Prefer a QuadRenderer to
+ * draw many textures, this issues one draw call per texture.
+ *
+ * @param posX left edge in pixels.
+ * @param posY top edge in pixels.
+ * @param width width in pixels.
+ * @param height height in pixels.
+ * @param convert_sRGB convert linear colors to sRGB.
+ */
 void Texture2d::render(float posX, float posY, float width, float height,
                        bool convert_sRGB) const {
-  glPushAttrib(GL_ALL_ATTRIB_BITS);
-
-  if (convert_sRGB) {
-    glEnable(GL_FRAMEBUFFER_SRGB);
-  } else {
-    glDisable(GL_FRAMEBUFFER_SRGB);
-  }
-  // deactivate color clamping
-  glClampColor(GL_CLAMP_VERTEX_COLOR_ARB, GL_FALSE);
-  glClampColor(GL_CLAMP_READ_COLOR_ARB, GL_FALSE);
-  glClampColor(GL_CLAMP_FRAGMENT_COLOR_ARB, GL_FALSE);
-
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, 0);
-
-  glColor4f(1.0, 1.0, 1.0, 1.0F);
-
-  glEnable(GL_TEXTURE_2D);
-  glActiveTexture(GL_TEXTURE0);
-  bind(true);
-
-  glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
-
-  glDisable(GL_DEPTH_TEST);
-
-  int32_t iViewport[4];
-  glGetIntegerv(GL_VIEWPORT, iViewport);
-
-  glMatrixMode(GL_PROJECTION);
-  glPushMatrix();
-  glLoadIdentity();
-
-  glOrtho(iViewport[0], iViewport[0] + iViewport[2],
-          iViewport[1] + iViewport[3], iViewport[1], -1, 1);
-  glMatrixMode(GL_MODELVIEW);
-  glPushMatrix();
-  glLoadIdentity();
-
-  glPushAttrib(GL_DEPTH_BUFFER_BIT | GL_LIGHTING_BIT);
-  glDisable(GL_DEPTH_TEST);
-  glDisable(GL_LIGHTING);
-
-  glPushMatrix();
-  glTranslatef(posX, posY, 0.0F);
-  glBegin(GL_QUADS);
-  glTexCoord2f(0.0F, 1.0F);
-  glVertex3f(0.0F, 0.0F, 0.0F);
-
-  glTexCoord2f(1.0F, 1.0F);
-  glVertex3f(width, 0.0F, 0.0F);
-
-  glTexCoord2f(1.0F, 0.0F);
-  glVertex3f(width, height, 0.0F);
-
-  glTexCoord2f(0.0F, 0.0F);
-  glVertex3f(0.0, height, 0.0F);
-  glEnd();
-  glPopMatrix();
-
-  glPopAttrib();
-  glMatrixMode(GL_PROJECTION);
-  glPopMatrix();
-  glMatrixMode(GL_MODELVIEW);
-  glPopMatrix();
-
-  bind(false);
-
-  glDisable(GL_TEXTURE_2D);
-  glEnable(GL_DEPTH_TEST);
+  // the GL objects of a renderer belong to the context that created them
+  auto* context  = ContextImplementation::GetCurrent();
+  auto& renderer = (context != nullptr) ? context->getQuadRenderer()
+                                        : getFallbackRenderer();
+  render(renderer, posX, posY, width, height, convert_sRGB);
+}
 
-  glPopAttrib();
+void Texture2d::render(QuadRenderer& renderer, float posX, float posY,
+                       float width, float height, bool convert_sRGB) const {
+  renderer.add(*this, posX, posY, width, height);
+  renderer.flush(convert_sRGB);
 }
 
 void Texture2d::copyTo(Texture2d& other) const {
+  if (mBarrierTracker) {
+    mBarrierTracker->flush(*this, BarrierTracker::Access::TextureUpdate);
+  }
+  if (other.mBarrierTracker) {
+    other.mBarrierTracker->flush(other, BarrierTracker::Access::TextureUpdate,
+                                 true);
+  }
   glCopyImageSubData(mHandle, mTarget, 0, 0, 0, 0, other.mHandle, other.mTarget,
                      0, 0, 0, 0, mWidth, mHeight, 1);
 }
@@ -0,0 +1,236 @@
+#include "prgl/Texture2dArray.hxx"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "prgl/BarrierTracker.hxx"
+
+namespace prgl {
+
+Texture2dArray::Texture2dArray(uint32_t width, uint32_t height,
+                               uint32_t layers,
+                               TextureFormatInternal internalFormat,
+                               TextureFormat format, DataType type,
+                               TextureMinFilter minFilter,
+                               TextureMagFilter magFilter,
+                               TextureWrapMode wrapMode, bool createMipMaps)
+    : mHandle(INVALID_HANDLE),
+      mWidth(width),
+      mHeight(height),
+      mLayers(layers),
+      mTarget(GL_TEXTURE_2D_ARRAY),
+      mInternalFormat(internalFormat),
+      mFormat(format),
+      mType(type),
+      mMinFilter(minFilter),
+      mMagFilter(magFilter),
+      mWrap(wrapMode),
+      mLevelCount(createMipMaps ? prgl::getMipLevelCount(width, height) : 1U),
+      mMaxAnisotropy(1.0F),
+      mBarrierTracker(nullptr) {
+  if (!isSizedFormat(mInternalFormat)) {
+    throw std::invalid_argument(
+      "Texture2dArray: immutable storage requires a sized internal format");
+  }
+  if ((mWidth == 0U) || (mHeight == 0U) || (mLayers == 0U)) {
+    throw std::invalid_argument(
+      "Texture2dArray: width, height and layers must not be zero");
+  }
+
+  glCreateTextures(mTarget, 1, &mHandle);
+  glTextureStorage3D(mHandle, static_cast<GLsizei>(mLevelCount),
+                     static_cast<GLenum>(mInternalFormat),
+                     static_cast<GLsizei>(mWidth),
+                     static_cast<GLsizei>(mHeight),
+                     static_cast<GLsizei>(mLayers));
+
+  setFilter(mMinFilter, mMagFilter);
+  setWrapMode(mWrap);
+}
+
+Texture2dArray::~Texture2dArray() {
+  glDeleteTextures(1, &mHandle);
+  mHandle = INVALID_HANDLE;
+}
+
+void Texture2dArray::bind(bool bind) const {
+  if (bind) {
+    glBindTexture(mTarget, mHandle);
+  } else {
+    glBindTexture(mTarget, 0);
+  }
+}
+
+void Texture2dArray::bindUnit(uint32_t unit) const {
+  glBindTextureUnit(static_cast<GLuint>(unit), mHandle);
+}
+
+void Texture2dArray::bindImageTexture(uint32_t unit, TextureAccess access,
+                                      int32_t level, bool layered,
+                                      int32_t layer) {
+  glBindImageTexture(static_cast<GLuint>(unit), mHandle, level,
+                     static_cast<GLboolean>(layered), layer,
+                     static_cast<uint32_t>(access),
+                     static_cast<uint32_t>(mInternalFormat));
+}
+
+/**
+ * @brief Replace level 0 of a layer. Mip levels are not updated, call
+ * generateMipMaps() once after uploading a batch of layers.
+ */
+void Texture2dArray::upload(uint32_t layer, const void* data) {
+  uploadRegion(0U, 0U, layer, mWidth, mHeight, 0U, data, 0U);
+}
+
+/**
+ * @brief Update a part of a mip level of a single layer.
+ *
+ * @param x left column of the region.
+ * @param y bottom row of the region.
+ * @param layer the layer to update.
+ * @param width width of the region.
+ * @param height height of the region.
+ * @param level mip level to update.
+ * @param data pixel data in the format and type given on construction.
+ * @param rowStride number of pixels between two rows in data, 0 if the rows
+ * are tightly packed.
+ */
+void Texture2dArray::uploadRegion(uint32_t x, uint32_t y, uint32_t layer,
+                                  uint32_t width, uint32_t height,
+                                  uint32_t level, const void* data,
+                                  uint32_t rowStride) {
+  if ((level >= mLevelCount) || (layer >= mLayers)) {
+    throw std::invalid_argument(
+      "Texture2dArray::uploadRegion: invalid mip level or layer");
+  }
+  const auto levelWidth  = std::max(1U, mWidth >> level);
+  const auto levelHeight = std::max(1U, mHeight >> level);
+  if (((x + width) > levelWidth) || ((y + height) > levelHeight)) {
+    throw std::invalid_argument(
+      "Texture2dArray::uploadRegion: region exceeds the texture size");
+  }
+
+  int32_t alignment = 0;
+  glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+  int32_t rowLength = 0;
+  glGetIntegerv(GL_UNPACK_ROW_LENGTH, &rowLength);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(rowStride));
+
+  glTextureSubImage3D(mHandle, static_cast<GLint>(level),
+                      static_cast<GLint>(x), static_cast<GLint>(y),
+                      static_cast<GLint>(layer), static_cast<GLsizei>(width),
+                      static_cast<GLsizei>(height), 1,
+                      static_cast<GLenum>(mFormat), static_cast<GLenum>(mType),
+                      data);
+
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+}
+
+void Texture2dArray::generateMipMaps() {
+  glGenerateTextureMipmap(mHandle);
+}
+
+void Texture2dArray::download(uint32_t layer, void* dataPtr,
+                              const TextureFormat format,
+                              const DataType type) const {
+  const auto nBytes = static_cast<std::size_t>(mWidth) * mHeight *
+                      getChannelCount(format) * getSizeInBytes(type);
+
+  if (mBarrierTracker) {
+    mBarrierTracker->flush(*this, BarrierTracker::Access::TextureUpdate);
+  }
+
+  int32_t alignment = 0;
+  glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+  glGetTextureSubImage(mHandle, 0, 0, 0, static_cast<GLint>(layer),
+                       static_cast<GLsizei>(mWidth),
+                       static_cast<GLsizei>(mHeight), 1,
+                       static_cast<GLenum>(format), static_cast<GLenum>(type),
+                       static_cast<GLsizei>(nBytes), dataPtr);
+
+  glPixelStorei(GL_PACK_ALIGNMENT, alignment);
+}
+
+void Texture2dArray::setWrapMode(TextureWrapMode wrap) {
+  mWrap = wrap;
+
+  glTextureParameteri(mHandle, GL_TEXTURE_WRAP_S, static_cast<GLint>(mWrap));
+  glTextureParameteri(mHandle, GL_TEXTURE_WRAP_T, static_cast<GLint>(mWrap));
+}
+
+void Texture2dArray::setFilter(TextureMinFilter minFilter,
+                               TextureMagFilter magFilter) {
+  mMinFilter = minFilter;
+  mMagFilter = magFilter;
+
+  glTextureParameteri(mHandle, GL_TEXTURE_MIN_FILTER,
+                      static_cast<GLint>(mMinFilter));
+  glTextureParameteri(mHandle, GL_TEXTURE_MAG_FILTER,
+                      static_cast<GLint>(mMagFilter));
+}
+
+void Texture2dArray::setMaxIsotropy(float anisotropy) {
+  mMaxAnisotropy = anisotropy;
+
+  glTextureParameterf(mHandle, GL_TEXTURE_MAX_ANISOTROPY_EXT, mMaxAnisotropy);
+}
+
+uint32_t Texture2dArray::getId() const {
+  return mHandle;
+}
+
+uint32_t Texture2dArray::getWidth() const {
+  return mWidth;
+}
+
+uint32_t Texture2dArray::getHeight() const {
+  return mHeight;
+}
+
+uint32_t Texture2dArray::getLayers() const {
+  return mLayers;
+}
+
+TextureFormatInternal Texture2dArray::getInternalFormat() const {
+  return mInternalFormat;
+}
+
+TextureFormat Texture2dArray::getFormat() const {
+  return mFormat;
+}
+
+DataType Texture2dArray::getType() const {
+  return mType;
+}
+
+TextureMinFilter Texture2dArray::getMinFilter() const {
+  return mMinFilter;
+}
+
+TextureMagFilter Texture2dArray::getMagFilter() const {
+  return mMagFilter;
+}
+
+TextureWrapMode Texture2dArray::getWrap() const {
+  return mWrap;
+}
+
+uint32_t Texture2dArray::getMipLevelCount() const {
+  return mLevelCount;
+}
+
+void Texture2dArray::setBarrierTracker(
+  const std::shared_ptr<BarrierTracker>& tracker) {
+  mBarrierTracker = tracker;
+}
+
+const std::shared_ptr<BarrierTracker>& Texture2dArray::getBarrierTracker()
+  const {
+  return mBarrierTracker;
+}
+
+}  // namespace prgl
@@ -0,0 +1,111 @@
+#include "prgl/TextureAtlas.hxx"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace prgl {
+
+TextureAtlas::TextureAtlas(uint32_t width, uint32_t height, uint32_t layers,
+                           TextureFormatInternal internalFormat,
+                           TextureFormat format, DataType type,
+                           uint32_t padding)
+    : mTexture(Texture2dArray::Create(width, height, layers, internalFormat,
+                                      format, type)),
+      mPackers(layers, RectanglePacker(width, height)),
+      mPadding(padding) {}
+
+TextureAtlas::Region TextureAtlas::add(uint32_t width, uint32_t height,
+                                       const void* data, uint32_t rowStride) {
+  const auto paddedWidth  = width + (2U * mPadding);
+  const auto paddedHeight = height + (2U * mPadding);
+
+  for (auto layer = 0U; layer < mPackers.size(); layer++) {
+    const auto rect = mPackers[layer].insert(paddedWidth, paddedHeight);
+    if (!rect) {
+      continue;
+    }
+
+    Region region{};
+    region.layer  = layer;
+    region.x      = rect->x + mPadding;
+    region.y      = rect->y + mPadding;
+    region.width  = width;
+    region.height = height;
+
+    const auto invWidth  = 1.0F / static_cast<float>(mTexture->getWidth());
+    const auto invHeight = 1.0F / static_cast<float>(mTexture->getHeight());
+    region.texCoords[0U] = static_cast<float>(region.x) * invWidth;
+    region.texCoords[1U] = static_cast<float>(region.y) * invHeight;
+    region.texCoords[2U] = static_cast<float>(region.x + width) * invWidth;
+    region.texCoords[3U] = static_cast<float>(region.y + height) * invHeight;
+
+    if ((mPadding == 0U) || (data == nullptr) || (width == 0U) ||
+        (height == 0U)) {
+      mTexture->uploadRegion(region.x, region.y, layer, width, height, 0U,
+                             data, rowStride);
+    } else {
+      const auto padded = extrude(width, height, data, rowStride);
+      mTexture->uploadRegion(rect->x, rect->y, layer, paddedWidth,
+                             paddedHeight, 0U, padded.data());
+    }
+    return region;
+  }
+
+  throw std::runtime_error(
+    "TextureAtlas::add: no space left for image of size " +
+    std::to_string(width) + "x" + std::to_string(height));
+}
+
+/**
+ * @brief Copy of the image with its border pixels repeated mPadding times on
+ * each side, so that filtering at the edge of a region reads the image's own
+ * colors instead of its neighbours or uninitialized texels.
+ */
+std::vector<uint8_t> TextureAtlas::extrude(uint32_t width, uint32_t height,
+                                           const void* data,
+                                           uint32_t rowStride) const {
+  const auto pixelSize    = getChannelCount(mTexture->getFormat()) *
+                           getSizeInBytes(mTexture->getType());
+  const auto paddedWidth  = width + (2U * mPadding);
+  const auto paddedHeight = height + (2U * mPadding);
+  const auto rowSize      = paddedWidth * pixelSize;
+  const auto stride =
+    static_cast<std::size_t>((rowStride > 0U) ? rowStride : width) *
+    pixelSize;
+  const auto* source = static_cast<const uint8_t*>(data);
+
+  std::vector<uint8_t> padded(rowSize * paddedHeight);
+  for (auto y = 0U; y < paddedHeight; y++) {
+    // rows above and below the image repeat its first and last row
+    const auto sourceY =
+      std::min(std::max(y, mPadding) - mPadding, height - 1U);
+
+    const auto* sourceRow = source + (sourceY * stride);
+    auto* row             = padded.data() + (y * rowSize);
+    for (auto x = 0U; x < mPadding; x++) {
+      std::memcpy(row + (x * pixelSize), sourceRow, pixelSize);
+      std::memcpy(row + ((mPadding + width + x) * pixelSize),
+                  sourceRow + ((width - 1U) * pixelSize), pixelSize);
+    }
+    std::memcpy(row + (mPadding * pixelSize), sourceRow, width * pixelSize);
+  }
+  return padded;
+}
+
+void TextureAtlas::clear() {
+  for (auto& packer : mPackers) {
+    packer.clear();
+  }
+}
+
+const std::shared_ptr<Texture2dArray>& TextureAtlas::getTexture() const {
+  return mTexture;
+}
+
+float TextureAtlas::getOccupancy(uint32_t layer) const {
+  return mPackers.at(layer).getOccupancy();
+}
+
+}  // namespace prgl
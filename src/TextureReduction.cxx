@@ -0,0 +1,266 @@
+#include "prgl/TextureReduction.hxx"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+
+namespace prgl {
+
+namespace {
+// every invocation of the first pass folds 2x2 texels, 16x16 invocations
+constexpr auto TileSize = 32U;
+// matches local_size_x and local_size_y of the histogram pass
+constexpr auto HistogramTileSize = 16U;
+
+// tree reduction of the 256 invocations of a work group in shared memory
+const char* const ReductionCommon = R"(
+  #version 430
+
+  shared vec4 sharedMin[256];
+  shared vec4 sharedMax[256];
+  shared vec4 sharedSum[256];
+
+  void treeReduce(uint local, vec4 minimum, vec4 maximum, vec4 sum)
+  {
+    sharedMin[local] = minimum;
+    sharedMax[local] = maximum;
+    sharedSum[local] = sum;
+    barrier();
+    for (uint stride = 128u; stride > 0u; stride >>= 1u) {
+      if (local < stride) {
+        sharedMin[local] = min(sharedMin[local], sharedMin[local + stride]);
+        sharedMax[local] = max(sharedMax[local], sharedMax[local + stride]);
+        sharedSum[local] += sharedSum[local + stride];
+      }
+      barrier();
+    }
+  }
+)";
+
+const char* const ReduceShader = R"(
+  layout(local_size_x = 16, local_size_y = 16) in;
+
+  uniform sampler2D source;
+  uniform int level;
+
+  layout(std430, binding = 0) writeonly buffer Partials
+  {
+    vec4 partials[];
+  };
+
+  void main()
+  {
+    const ivec2 size = textureSize(source, level);
+    vec4 minimum = vec4(3.402823466e38);
+    vec4 maximum = vec4(-3.402823466e38);
+    vec4 sum     = vec4(0.0);
+    for (int j = 0; j < 2; ++j) {
+      for (int i = 0; i < 2; ++i) {
+        const ivec2 p = 2 * ivec2(gl_GlobalInvocationID.xy) + ivec2(i, j);
+        if (all(lessThan(p, size))) {
+          const vec4 texel = texelFetch(source, p, level);
+          minimum = min(minimum, texel);
+          maximum = max(maximum, texel);
+          sum += texel;
+        }
+      }
+    }
+    treeReduce(gl_LocalInvocationIndex, minimum, maximum, sum);
+
+    if (gl_LocalInvocationIndex == 0u) {
+      const uint group =
+        gl_WorkGroupID.y * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+      partials[3u * group]      = sharedMin[0];
+      partials[3u * group + 1u] = sharedMax[0];
+      partials[3u * group + 2u] = sharedSum[0];
+    }
+  }
+)";
+
+const char* const FinalShader = R"(
+  layout(local_size_x = 256) in;
+
+  uniform uint partialCount;
+
+  layout(std430, binding = 0) readonly buffer Partials
+  {
+    vec4 partials[];
+  };
+  layout(std430, binding = 1) writeonly buffer Result
+  {
+    vec4 result[3];
+  };
+
+  void main()
+  {
+    const uint local = gl_LocalInvocationIndex;
+    vec4 minimum = vec4(3.402823466e38);
+    vec4 maximum = vec4(-3.402823466e38);
+    vec4 sum     = vec4(0.0);
+    for (uint i = local; i < partialCount; i += 256u) {
+      minimum = min(minimum, partials[3u * i]);
+      maximum = max(maximum, partials[3u * i + 1u]);
+      sum += partials[3u * i + 2u];
+    }
+    treeReduce(local, minimum, maximum, sum);
+
+    if (local == 0u) {
+      result[0] = sharedMin[0];
+      result[1] = sharedMax[0];
+      result[2] = sharedSum[0];
+    }
+  }
+)";
+
+const char* const HistogramShader = R"(
+  #version 430
+
+  layout(local_size_x = 16, local_size_y = 16) in;
+
+  uniform sampler2D source;
+  uniform int level;
+  uniform int channel;
+  uniform float minValue;
+  uniform float invRange;
+  uniform uint binCount;
+
+  layout(std430, binding = 0) buffer Bins
+  {
+    uint bins[];
+  };
+
+  shared uint localBins[256];
+
+  void main()
+  {
+    const uint local = gl_LocalInvocationIndex;
+    localBins[local] = 0u;
+    barrier();
+
+    const ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    if (all(lessThan(p, textureSize(source, level)))) {
+      const vec4 texel = texelFetch(source, p, level);
+      const float value = (channel == 4)
+        ? dot(texel.rgb, vec3(0.2126, 0.7152, 0.0722))
+        : texel[channel];
+      const float t = clamp((value - minValue) * invRange, 0.0, 1.0);
+      atomicAdd(localBins[min(uint(t * float(binCount)), binCount - 1u)], 1u);
+    }
+    barrier();
+
+    // one global atomic per bin and work group
+    if ((local < binCount) && (localBins[local] != 0u)) {
+      atomicAdd(bins[local], localBins[local]);
+    }
+  }
+)";
+
+uint32_t divideRoundUp(uint32_t value, uint32_t divisor) {
+  return (value + divisor - 1U) / divisor;
+}
+}  // namespace
+
+std::shared_ptr<TextureReduction> TextureReduction::Create() {
+  return std::make_shared<TextureReduction>();
+}
+
+TextureReduction::TextureReduction()
+    : mReduceShader(GlslComputeShader::Create(std::string(ReductionCommon) +
+                                              ReduceShader)),
+      mFinalShader(
+        GlslComputeShader::Create(std::string(ReductionCommon) + FinalShader)),
+      mHistogramShader(GlslComputeShader::Create(HistogramShader)),
+      mPartials(ShaderStorageBuffer::Create()),
+      mResult(ShaderStorageBuffer::Create()),
+      mBins(ShaderStorageBuffer::Create()),
+      mPartialCapacity(0U) {
+  mResult->create(nullptr, 3U * sizeof(vec4f));
+  mBins->create(nullptr, MaxBinCount * sizeof(uint32_t));
+}
+
+TextureReduction::~TextureReduction() = default;
+
+TextureReduction::Result TextureReduction::reduce(
+  const std::shared_ptr<Texture2d>& texture, uint32_t level) {
+  const auto width   = std::max(1U, texture->getWidth() >> level);
+  const auto height  = std::max(1U, texture->getHeight() >> level);
+  const auto groupsX = divideRoundUp(width, TileSize);
+  const auto groupsY = divideRoundUp(height, TileSize);
+  const auto groups  = groupsX * groupsY;
+  if (groups > mPartialCapacity) {
+    mPartials->create(nullptr,
+                      groups * 3U * static_cast<uint32_t>(sizeof(vec4f)));
+    mPartialCapacity = groups;
+  }
+
+  // one partial result per work group
+  mReduceShader->bind(true);
+  mReduceShader->bindSampler("source", 0U, texture);
+  mReduceShader->seti("level", static_cast<int32_t>(level));
+  mReduceShader->bindSSBO(0U, mPartials);
+  mReduceShader->dispatchCompute(groupsX, groupsY, 1U);
+  mReduceShader->memoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+  // a single work group folds all partial results
+  mFinalShader->bind(true);
+  mFinalShader->setui("partialCount", groups);
+  mFinalShader->bindSSBO(0U, mPartials);
+  mFinalShader->bindSSBO(1U, mResult);
+  mFinalShader->dispatchCompute(1U, 1U, 1U);
+  mFinalShader->memoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+  mFinalShader->bind(false);
+
+  std::array<vec4f, 3U> values;
+  glGetNamedBufferSubData(mResult->getHandle(), 0,
+                          static_cast<GLsizeiptr>(sizeof(values)),
+                          values.data());
+
+  Result result{values[0U], values[1U], values[2U], {}};
+  const auto count = static_cast<float>(width) * static_cast<float>(height);
+  for (auto c = 0U; c < 4U; c++) {
+    result.mean[c] = result.sum[c] / count;
+  }
+  return result;
+}
+
+std::vector<uint32_t> TextureReduction::histogram(
+  const std::shared_ptr<Texture2d>& texture, uint32_t binCount,
+  float minValue, float maxValue, ReductionChannel channel, uint32_t level) {
+  if ((binCount == 0U) || (binCount > MaxBinCount)) {
+    throw std::invalid_argument(
+      "TextureReduction::histogram: binCount must be in [1, 256]");
+  }
+  if (!(maxValue > minValue)) {
+    throw std::invalid_argument(
+      "TextureReduction::histogram: maxValue must be larger than minValue");
+  }
+
+  const auto width  = std::max(1U, texture->getWidth() >> level);
+  const auto height = std::max(1U, texture->getHeight() >> level);
+
+  glClearNamedBufferData(mBins->getHandle(), GL_R32UI, GL_RED_INTEGER,
+                         GL_UNSIGNED_INT, nullptr);
+
+  mHistogramShader->bind(true);
+  mHistogramShader->bindSampler("source", 0U, texture);
+  mHistogramShader->seti("level", static_cast<int32_t>(level));
+  mHistogramShader->seti("channel", static_cast<int32_t>(channel));
+  mHistogramShader->setf("minValue", minValue);
+  mHistogramShader->setf("invRange", 1.0F / (maxValue - minValue));
+  mHistogramShader->setui("binCount", binCount);
+  mHistogramShader->bindSSBO(0U, mBins);
+  mHistogramShader->dispatchCompute(divideRoundUp(width, HistogramTileSize),
+                                    divideRoundUp(height, HistogramTileSize),
+                                    1U);
+  mHistogramShader->memoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+  mHistogramShader->bind(false);
+
+  std::vector<uint32_t> bins(binCount, 0U);
+  glGetNamedBufferSubData(mBins->getHandle(), 0,
+                          static_cast<GLsizeiptr>(binCount * sizeof(uint32_t)),
+                          bins.data());
+  return bins;
+}
+
+}  // namespace prgl
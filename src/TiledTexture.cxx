@@ -0,0 +1,269 @@
+#include "prgl/TiledTexture.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace prgl {
+
+namespace {
+std::size_t getTileSizeInBytes(uint32_t tileSize, TextureFormat format,
+                               DataType type) {
+  return static_cast<std::size_t>(tileSize) * tileSize *
+         getChannelCount(format) * getSizeInBytes(type);
+}
+}  // namespace
+
+TiledTexture::TiledTexture(uint32_t width, uint32_t height, uint32_t tileSize,
+                           uint32_t cacheSize, TileLoader loader,
+                           TextureFormatInternal internalFormat,
+                           TextureFormat format, DataType type)
+    : mWidth(width),
+      mHeight(height),
+      mTileSize(tileSize),
+      mLevelCount(1U),
+      mLoader(std::move(loader)),
+      mTexture(nullptr),
+      mUploadRing(GL_PIXEL_UNPACK_BUFFER,
+                  getTileSizeInBytes(tileSize, format, type), 3U,
+                  PersistentBufferRing::Access::Write),
+      mTiles(),
+      mLru(),
+      mFreeLayers(),
+      mFrame(0U),
+      mEvictionFailures(0U) {
+  if ((mWidth == 0U) || (mHeight == 0U) || (mTileSize == 0U) ||
+      (cacheSize == 0U)) {
+    throw std::invalid_argument(
+      "TiledTexture: size, tile size and cache size must not be zero");
+  }
+  if (!mLoader) {
+    throw std::invalid_argument("TiledTexture: no tile loader given");
+  }
+  int32_t maxSize   = 0;
+  int32_t maxLayers = 0;
+  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+  glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+  if ((mTileSize > static_cast<uint32_t>(maxSize)) ||
+      (cacheSize > static_cast<uint32_t>(maxLayers))) {
+    throw std::invalid_argument(
+      "TiledTexture: tile size or cache size exceed the GL limits");
+  }
+
+  // the coarsest level fits into a single tile
+  while (((std::max(mWidth, mHeight) >> (mLevelCount - 1U)) > mTileSize)) {
+    mLevelCount++;
+  }
+
+  mTexture = Texture2dArray::Create(mTileSize, mTileSize, cacheSize,
+                                    internalFormat, format, type);
+  mFreeLayers.reserve(cacheSize);
+  for (auto layer = cacheSize; layer > 0U; layer--) {
+    mFreeLayers.push_back(layer - 1U);
+  }
+}
+
+TiledTexture::~TiledTexture() = default;
+
+uint64_t TiledTexture::makeKey(uint32_t level, uint32_t tileX,
+                               uint32_t tileY) {
+  return (static_cast<uint64_t>(level) << 56U) |
+         (static_cast<uint64_t>(tileX) << 28U) | static_cast<uint64_t>(tileY);
+}
+
+uint32_t TiledTexture::selectLevel(const Viewport& viewport) const {
+  const auto texelsPerPixel =
+    viewport.imageWidth / std::max(viewport.screenWidth, 1.0F);
+  if (texelsPerPixel <= 1.0F) {
+    return 0U;
+  }
+  const auto level = std::floor(std::log2(texelsPerPixel));
+  return std::min(static_cast<uint32_t>(level), mLevelCount - 1U);
+}
+
+std::array<uint32_t, 4U> TiledTexture::getVisibleTiles(
+  const Viewport& viewport, uint32_t level) const {
+  // tile edge length in level 0 texels
+  const auto span   = static_cast<float>(mTileSize << level);
+  const auto toTile = [span](float texel, uint32_t count) {
+    const auto tile = std::floor(std::max(texel, 0.0F) / span);
+    return std::min(static_cast<uint32_t>(tile), count - 1U);
+  };
+  const auto countX = getTileCountX(level);
+  const auto countY = getTileCountY(level);
+  return {toTile(viewport.imageX, countX), toTile(viewport.imageY, countY),
+          toTile(viewport.imageX + viewport.imageWidth, countX),
+          toTile(viewport.imageY + viewport.imageHeight, countY)};
+}
+
+uint32_t TiledTexture::update(const Viewport& viewport, uint32_t maxUploads) {
+  mFrame++;
+  mEvictionFailures = 0U;
+  auto uploads      = 0U;
+
+  const auto coarsest = mLevelCount - 1U;
+  if (request(coarsest, 0U, 0U, true)) {
+    uploads++;
+  }
+
+  const auto level = selectLevel(viewport);
+  const auto tiles = getVisibleTiles(viewport, level);
+  for (auto y = tiles[1U]; y <= tiles[3U]; y++) {
+    for (auto x = tiles[0U]; x <= tiles[2U]; x++) {
+      if (request(level, x, y, uploads < maxUploads)) {
+        uploads++;
+      }
+    }
+  }
+  return uploads;
+}
+
+/**
+ * @brief Mark a tile as used in this frame and load it if it is missing.
+ *
+ * @return true if the tile was uploaded.
+ */
+bool TiledTexture::request(uint32_t level, uint32_t tileX, uint32_t tileY,
+                           bool mayUpload) {
+  const auto key = makeKey(level, tileX, tileY);
+  auto it        = mTiles.find(key);
+  if (it != mTiles.end()) {
+    it->second.lastUsed = mFrame;
+    mLru.splice(mLru.begin(), mLru, it->second.lru);
+    return false;
+  }
+  if (!mayUpload) {
+    return false;
+  }
+
+  if (mFreeLayers.empty()) {
+    // tiles requested in this frame are not evicted
+    const auto victim = mTiles.find(mLru.back());
+    if (victim->second.lastUsed == mFrame) {
+      mEvictionFailures++;
+      return false;
+    }
+    mFreeLayers.push_back(victim->second.layer);
+    mLru.pop_back();
+    mTiles.erase(victim);
+  }
+  const auto layer = mFreeLayers.back();
+  mFreeLayers.pop_back();
+
+  const auto slot = mUploadRing.acquire();
+  mLoader(level, tileX, tileY, mUploadRing.getMappedSlot(slot));
+  mUploadRing.bind(true);
+  // the data pointer is an offset into the bound pixel unpack buffer
+  mTexture->uploadRegion(
+    0U, 0U, layer, mTileSize, mTileSize, 0U,
+    reinterpret_cast<const void*>(mUploadRing.getSlotOffset(slot)));
+  mUploadRing.bind(false);
+  mUploadRing.fence(slot);
+
+  mLru.push_front(key);
+  mTiles.emplace(key, Tile{layer, mFrame, mLru.begin()});
+  return true;
+}
+
+void TiledTexture::render(QuadRenderer& renderer,
+                          const Viewport& viewport) const {
+  const auto level = selectLevel(viewport);
+  const auto tiles = getVisibleTiles(viewport, level);
+  for (auto y = tiles[1U]; y <= tiles[3U]; y++) {
+    for (auto x = tiles[0U]; x <= tiles[2U]; x++) {
+      addQuad(renderer, viewport, level, x, y);
+    }
+  }
+}
+
+/**
+ * @brief Draw the area of a tile with the finest resident tile covering it.
+ */
+void TiledTexture::addQuad(QuadRenderer& renderer, const Viewport& viewport,
+                           uint32_t level, uint32_t tileX,
+                           uint32_t tileY) const {
+  // area of the tile in level 0 texels, clipped at the image border
+  const auto span = static_cast<float>(mTileSize << level);
+  const auto x0   = static_cast<float>(tileX) * span;
+  const auto y0   = static_cast<float>(tileY) * span;
+  const auto x1   = std::min(x0 + span, static_cast<float>(mWidth));
+  const auto y1   = std::min(y0 + span, static_cast<float>(mHeight));
+
+  for (auto source = level; source < mLevelCount; source++) {
+    const auto shift = source - level;
+    const auto layer =
+      getResidentLayer(source, tileX >> shift, tileY >> shift);
+    if (!layer) {
+      continue;
+    }
+    // texture coordinates of the area inside the (coarser) source tile
+    const auto sourceSpan = static_cast<float>(mTileSize << source);
+    const auto originX    = static_cast<float>(tileX >> shift) * sourceSpan;
+    const auto originY    = static_cast<float>(tileY >> shift) * sourceSpan;
+    const vec4f texCoords = {(x0 - originX) / sourceSpan,
+                             (y0 - originY) / sourceSpan,
+                             (x1 - originX) / sourceSpan,
+                             (y1 - originY) / sourceSpan};
+
+    // screen rectangle, screen y grows downwards
+    const auto scaleX = viewport.screenWidth / viewport.imageWidth;
+    const auto scaleY = viewport.screenHeight / viewport.imageHeight;
+    const auto top    = viewport.imageY + viewport.imageHeight;
+    renderer.add(*mTexture, *layer,
+                 viewport.screenX + ((x0 - viewport.imageX) * scaleX),
+                 viewport.screenY + ((top - y1) * scaleY), (x1 - x0) * scaleX,
+                 (y1 - y0) * scaleY, texCoords);
+    return;
+  }
+}
+
+std::optional<uint32_t> TiledTexture::getResidentLayer(uint32_t level,
+                                                       uint32_t tileX,
+                                                       uint32_t tileY) const {
+  const auto it = mTiles.find(makeKey(level, tileX, tileY));
+  if (it == mTiles.end()) {
+    return std::nullopt;
+  }
+  return it->second.layer;
+}
+
+const std::shared_ptr<Texture2dArray>& TiledTexture::getTexture() const {
+  return mTexture;
+}
+
+uint32_t TiledTexture::getWidth() const {
+  return mWidth;
+}
+
+uint32_t TiledTexture::getHeight() const {
+  return mHeight;
+}
+
+uint32_t TiledTexture::getTileSize() const {
+  return mTileSize;
+}
+
+uint32_t TiledTexture::getLevelCount() const {
+  return mLevelCount;
+}
+
+uint32_t TiledTexture::getTileCountX(uint32_t level) const {
+  const auto levelWidth = std::max(1U, mWidth >> level);
+  return (levelWidth + mTileSize - 1U) / mTileSize;
+}
+
+uint32_t TiledTexture::getTileCountY(uint32_t level) const {
+  const auto levelHeight = std::max(1U, mHeight >> level);
+  return (levelHeight + mTileSize - 1U) / mTileSize;
+}
+
+uint32_t TiledTexture::getResidentCount() const {
+  return static_cast<uint32_t>(mTiles.size());
+}
+
+uint32_t TiledTexture::getEvictionFailures() const {
+  return mEvictionFailures;
+}
+
+}  // namespace prgl
@@ -0,0 +1,389 @@
+#include "prgl/TlsfAllocator.hxx"
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace prgl {
+
+namespace {
+constexpr uint32_t Invalid = std::numeric_limits<uint32_t>::max();
+
+uint32_t highestBit(uint64_t value) {
+  return 63U - static_cast<uint32_t>(__builtin_clzll(value));
+}
+
+uint32_t lowestBit(uint64_t value) {
+  return static_cast<uint32_t>(__builtin_ctzll(value));
+}
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1U) & ~(alignment - 1U);
+}
+}  // namespace
+
+TlsfAllocator::TlsfAllocator(uint64_t capacity)
+    : mCapacity(capacity),
+      mUsed(0U),
+      mAllocations(0U),
+      mFirst(Invalid),
+      mBlocks(),
+      mUnused(),
+      mFlBitmap(0U),
+      mSlBitmaps(),
+      mFreeLists() {
+  if (capacity == 0U) {
+    throw std::invalid_argument("TlsfAllocator: capacity must not be zero");
+  }
+  clear();
+}
+
+void TlsfAllocator::clear() {
+  mBlocks.clear();
+  mUnused.clear();
+  mFlBitmap = 0U;
+  mSlBitmaps.fill(0U);
+  for (auto& lists : mFreeLists) {
+    lists.fill(Invalid);
+  }
+  mUsed        = 0U;
+  mAllocations = 0U;
+  mFirst       = createBlock(0U, mCapacity);
+  insertFree(mFirst);
+}
+
+/**
+ * @brief Sizes below SlCount map linearly to the first level 0, larger sizes
+ * to the power of two range they lie in and a linear subdivision of it.
+ */
+void TlsfAllocator::mapping(uint64_t size, uint32_t& fl, uint32_t& sl) {
+  if (size < SlCount) {
+    fl = 0U;
+    sl = static_cast<uint32_t>(size);
+    return;
+  }
+  const auto bit = highestBit(size);
+  fl             = bit - SlLog2 + 1U;
+  sl             = static_cast<uint32_t>(size >> (bit - SlLog2)) - SlCount;
+}
+
+uint32_t TlsfAllocator::createBlock(uint64_t offset, uint64_t size) {
+  const Block block = {offset,  size,    1U,      Invalid,
+                       Invalid, Invalid, Invalid, false};
+  if (!mUnused.empty()) {
+    const auto index = mUnused.back();
+    mUnused.pop_back();
+    mBlocks[index] = block;
+    return index;
+  }
+  mBlocks.push_back(block);
+  return static_cast<uint32_t>(mBlocks.size() - 1U);
+}
+
+void TlsfAllocator::releaseBlock(uint32_t block) {
+  // released blocks count as free so they are never taken for allocations
+  mBlocks[block].free = true;
+  mUnused.push_back(block);
+}
+
+void TlsfAllocator::insertFree(uint32_t block) {
+  uint32_t fl = 0U;
+  uint32_t sl = 0U;
+  mapping(mBlocks[block].size, fl, sl);
+  auto& head = mFreeLists[fl][sl];
+
+  mBlocks[block].free     = true;
+  mBlocks[block].prevFree = Invalid;
+  mBlocks[block].nextFree = head;
+  if (head != Invalid) {
+    mBlocks[head].prevFree = block;
+  }
+  head = block;
+  mSlBitmaps[fl] |= 1U << sl;
+  mFlBitmap |= 1ULL << fl;
+}
+
+void TlsfAllocator::removeFree(uint32_t block) {
+  uint32_t fl = 0U;
+  uint32_t sl = 0U;
+  mapping(mBlocks[block].size, fl, sl);
+
+  const auto prev = mBlocks[block].prevFree;
+  const auto next = mBlocks[block].nextFree;
+  if (prev != Invalid) {
+    mBlocks[prev].nextFree = next;
+  } else {
+    mFreeLists[fl][sl] = next;
+  }
+  if (next != Invalid) {
+    mBlocks[next].prevFree = prev;
+  }
+  mBlocks[block].free = false;
+
+  if (mFreeLists[fl][sl] == Invalid) {
+    mSlBitmaps[fl] &= ~(1U << sl);
+    if (mSlBitmaps[fl] == 0U) {
+      mFlBitmap &= ~(1ULL << fl);
+    }
+  }
+}
+
+/**
+ * @brief Head of the first non empty list whose blocks all hold at least size
+ * bytes. Rounding the size up to the next list boundary avoids searching a
+ * list.
+ */
+uint32_t TlsfAllocator::findFree(uint64_t size) const {
+  auto search = size;
+  if (search >= SlCount) {
+    search += (1ULL << (highestBit(search) - SlLog2)) - 1U;
+    if (search < size) {
+      return Invalid;
+    }
+  }
+  uint32_t fl = 0U;
+  uint32_t sl = 0U;
+  mapping(search, fl, sl);
+
+  auto slMap = mSlBitmaps[fl] & (~0U << sl);
+  if (slMap == 0U) {
+    const auto flMap =
+      ((fl + 1U) < 64U) ? (mFlBitmap & (~0ULL << (fl + 1U))) : 0U;
+    if (flMap == 0U) {
+      return Invalid;
+    }
+    fl    = lowestBit(flMap);
+    slMap = mSlBitmaps[fl];
+  }
+  return mFreeLists[fl][lowestBit(slMap)];
+}
+
+/**
+ * @brief Fallback for findFree, searches the lists the rounded size skipped
+ * for a block the aligned range fits into exactly.
+ */
+uint32_t TlsfAllocator::findFit(uint64_t size, uint64_t alignment) const {
+  uint32_t fl = 0U;
+  uint32_t sl = 0U;
+  mapping(size, fl, sl);
+  auto slMap = mSlBitmaps[fl] & (~0U << sl);
+  while (fl < FlCount) {
+    while (slMap != 0U) {
+      auto block = mFreeLists[fl][lowestBit(slMap)];
+      while (block != Invalid) {
+        const auto& candidate = mBlocks[block];
+        const auto padding =
+          alignUp(candidate.offset, alignment) - candidate.offset;
+        if ((padding <= candidate.size) &&
+            (size <= (candidate.size - padding))) {
+          return block;
+        }
+        block = candidate.nextFree;
+      }
+      // clear the lowest bit
+      slMap &= slMap - 1U;
+    }
+    fl++;
+    if (fl < FlCount) {
+      slMap = mSlBitmaps[fl];
+    }
+  }
+  return Invalid;
+}
+
+void TlsfAllocator::splitTail(uint32_t block, uint64_t size) {
+  if (mBlocks[block].size <= size) {
+    return;
+  }
+  const auto tail = createBlock(mBlocks[block].offset + size,
+                                mBlocks[block].size - size);
+  const auto next = mBlocks[block].nextPhysical;
+  mBlocks[tail].prevPhysical = block;
+  mBlocks[tail].nextPhysical = next;
+  if (next != Invalid) {
+    mBlocks[next].prevPhysical = tail;
+  }
+  mBlocks[block].nextPhysical = tail;
+  mBlocks[block].size         = size;
+  insertFree(tail);
+}
+
+std::optional<TlsfAllocator::Allocation> TlsfAllocator::allocate(
+  uint64_t size, uint64_t alignment) {
+  if ((alignment == 0U) || ((alignment & (alignment - 1U)) != 0U)) {
+    throw std::invalid_argument(
+      "TlsfAllocator::allocate: alignment must be a power of two");
+  }
+  if ((size == 0U) || (size > mCapacity)) {
+    return std::nullopt;
+  }
+  // any block of this size can hold the aligned range
+  auto block = Invalid;
+  if ((alignment - 1U) <= (mCapacity - size)) {
+    block = findFree(size + alignment - 1U);
+  }
+  if (block == Invalid) {
+    // e.g. a range filling the whole capacity
+    block = findFit(size, alignment);
+  }
+  if (block == Invalid) {
+    return std::nullopt;
+  }
+  removeFree(block);
+
+  const auto offset  = alignUp(mBlocks[block].offset, alignment);
+  const auto padding = offset - mBlocks[block].offset;
+  if (padding > 0U) {
+    // free neighbours are always merged, so the previous block is in use
+    const auto pad  = createBlock(mBlocks[block].offset, padding);
+    const auto prev = mBlocks[block].prevPhysical;
+    mBlocks[pad].prevPhysical = prev;
+    mBlocks[pad].nextPhysical = block;
+    if (prev != Invalid) {
+      mBlocks[prev].nextPhysical = pad;
+    } else {
+      mFirst = pad;
+    }
+    mBlocks[block].prevPhysical = pad;
+    mBlocks[block].offset       = offset;
+    mBlocks[block].size -= padding;
+    insertFree(pad);
+  }
+  splitTail(block, size);
+
+  mBlocks[block].alignment = alignment;
+  mUsed += size;
+  mAllocations++;
+  return Allocation{offset, size, block};
+}
+
+void TlsfAllocator::free(uint32_t block) {
+  checkAllocated("free", block);
+  mUsed -= mBlocks[block].size;
+  mAllocations--;
+
+  auto current    = block;
+  const auto next = mBlocks[current].nextPhysical;
+  if ((next != Invalid) && mBlocks[next].free) {
+    removeFree(next);
+    const auto after = mBlocks[next].nextPhysical;
+    mBlocks[current].size += mBlocks[next].size;
+    mBlocks[current].nextPhysical = after;
+    if (after != Invalid) {
+      mBlocks[after].prevPhysical = current;
+    }
+    releaseBlock(next);
+  }
+  const auto prev = mBlocks[current].prevPhysical;
+  if ((prev != Invalid) && mBlocks[prev].free) {
+    removeFree(prev);
+    const auto after = mBlocks[current].nextPhysical;
+    mBlocks[prev].size += mBlocks[current].size;
+    mBlocks[prev].nextPhysical = after;
+    if (after != Invalid) {
+      mBlocks[after].prevPhysical = prev;
+    }
+    releaseBlock(current);
+    current = prev;
+  }
+  mBlocks[current].alignment = 1U;
+  insertFree(current);
+}
+
+TlsfAllocator::Allocation TlsfAllocator::get(uint32_t block) const {
+  checkAllocated("get", block);
+  return {mBlocks[block].offset, mBlocks[block].size, block};
+}
+
+void TlsfAllocator::checkAllocated(const char* function,
+                                   uint32_t block) const {
+  if ((block >= mBlocks.size()) || mBlocks[block].free) {
+    throw std::invalid_argument(std::string("TlsfAllocator::") + function +
+                                ": block is not allocated");
+  }
+}
+
+/**
+ * @brief Allocations keep their block index, only their offsets change. The
+ * gaps alignment requires between them stay free.
+ */
+std::vector<TlsfAllocator::Move> TlsfAllocator::defragment() {
+  std::vector<uint32_t> used;
+  for (auto block = mFirst; block != Invalid;) {
+    const auto next = mBlocks[block].nextPhysical;
+    if (mBlocks[block].free) {
+      releaseBlock(block);
+    } else {
+      used.push_back(block);
+    }
+    block = next;
+  }
+  mFlBitmap = 0U;
+  mSlBitmaps.fill(0U);
+  for (auto& lists : mFreeLists) {
+    lists.fill(Invalid);
+  }
+
+  auto previous = Invalid;
+  mFirst        = Invalid;
+
+  const auto append = [this, &previous](uint32_t block) {
+    mBlocks[block].prevPhysical = previous;
+    mBlocks[block].nextPhysical = Invalid;
+    if (previous != Invalid) {
+      mBlocks[previous].nextPhysical = block;
+    } else {
+      mFirst = block;
+    }
+    previous = block;
+  };
+
+  std::vector<Move> moves;
+  uint64_t cursor = 0U;
+  for (const auto block : used) {
+    const auto offset = alignUp(cursor, mBlocks[block].alignment);
+    if (offset > cursor) {
+      const auto gap = createBlock(cursor, offset - cursor);
+      append(gap);
+      insertFree(gap);
+    }
+    if (offset != mBlocks[block].offset) {
+      moves.push_back({mBlocks[block].offset, offset, mBlocks[block].size});
+      mBlocks[block].offset = offset;
+    }
+    append(block);
+    cursor = offset + mBlocks[block].size;
+  }
+  if (cursor < mCapacity) {
+    const auto tail = createBlock(cursor, mCapacity - cursor);
+    append(tail);
+    insertFree(tail);
+  }
+  return moves;
+}
+
+uint64_t TlsfAllocator::getCapacity() const {
+  return mCapacity;
+}
+
+TlsfAllocator::Statistics TlsfAllocator::getStatistics() const {
+  Statistics statistics = {mCapacity, mUsed, 0U, mAllocations, 0U, 0.0F};
+  for (auto block = mFirst; block != Invalid;
+       block      = mBlocks[block].nextPhysical) {
+    if (mBlocks[block].free) {
+      statistics.freeBlocks++;
+      if (mBlocks[block].size > statistics.largestFree) {
+        statistics.largestFree = mBlocks[block].size;
+      }
+    }
+  }
+  const auto freeBytes = mCapacity - mUsed;
+  if (freeBytes > 0U) {
+    statistics.fragmentation =
+      1.0F - static_cast<float>(static_cast<double>(statistics.largestFree) /
+                                static_cast<double>(freeBytes));
+  }
+  return statistics;
+}
+
+}  // namespace prgl
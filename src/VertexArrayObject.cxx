@@ -10,6 +10,9 @@
  */
 #include "prgl/VertexArrayObject.hxx"
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "prgl/glCommon.hxx"
 
 namespace prgl {
@@ -54,19 +57,92 @@ void VertexArrayObject::render(const DrawMode& mode, const uint32_t first,
                static_cast<GLint>(count));
 }
 
+/**
+ * @brief
+ * https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glDrawArraysInstancedBaseInstance.xhtml
+ *
+ * @param mode Specifies what kind of primitives to render.
+ * @param first Specifies the starting index in the enabled arrays.
+ * @param count Specifies the number of indices to be rendered.
+ * @param instanceCount Specifies the number of instances to be rendered.
+ * @param baseInstance Specifies the first instance of per instance attributes.
+ */
+void VertexArrayObject::renderInstanced(const DrawMode& mode,
+                                        const uint32_t first,
+                                        const uint32_t count,
+                                        const uint32_t instanceCount,
+                                        const uint32_t baseInstance) {
+  glDrawArraysInstancedBaseInstance(
+    static_cast<GLenum>(mode), static_cast<GLint>(first),
+    static_cast<GLsizei>(count), static_cast<GLsizei>(instanceCount),
+    baseInstance);
+}
+
+/**
+ * @brief Source the attribute at location from the vertex buffer object.
+ *
+ * @param location attribute location in the shader.
+ * @param vbo the vertex buffer object.
+ * @param divisor 0 to advance per vertex, n to advance every n instances.
+ */
 void VertexArrayObject::addVertexBufferObject(
-  uint32_t location, const std::shared_ptr<VertexBufferObject>& vbo) {
+  uint32_t location, const std::shared_ptr<VertexBufferObject>& vbo,
+  uint32_t divisor) {
   // add to the map to keep the reference (consider move)
   mVboMap[location] = vbo;
 
   bind(true);
   {
     Binder<VertexBufferObject> binderVbo(vbo);
+    // the offset of heap allocated buffers is passed as pointer
     glVertexAttribPointer(
-      location, vbo->getVertexComponentDataColumns(),
+      location, static_cast<GLint>(vbo->getVertexComponentDataColumns()),
       static_cast<GLenum>(vbo->getVertexComponentDataType()), GL_FALSE, 0,
-      nullptr);
+      reinterpret_cast<const void*>(vbo->getOffset()));
     glEnableVertexAttribArray(location);
+    glVertexAttribDivisor(location, divisor);
+  }
+  bind(false);
+}
+
+/**
+ * @brief Source the attributes of the layout from the vertex buffer object
+ * through a single buffer binding point, the lowest location of the layout.
+ * Attributes previously sourced from other buffers at these locations are
+ * replaced.
+ *
+ * @param vbo the vertex buffer object, e.g. created with
+ * VertexBufferObject::createInterleavedBuffer.
+ * @param layout offsets and formats of the attributes inside a vertex.
+ * @param divisor 0 to advance per vertex, n to advance every n instances.
+ */
+void VertexArrayObject::addVertexBufferObject(
+  const std::shared_ptr<VertexBufferObject>& vbo, const VertexLayout& layout,
+  uint32_t divisor) {
+  const auto& attributes = layout.getAttributes();
+  if (attributes.empty()) {
+    throw std::invalid_argument(
+      "VertexArrayObject::addVertexBufferObject: empty layout");
+  }
+  auto binding = attributes.front().location;
+  for (const auto& attribute : attributes) {
+    binding = std::min(binding, attribute.location);
+    mVboMap[attribute.location] = vbo;
+  }
+
+  bind(true);
+  glBindVertexBuffer(binding, vbo->getHandle(),
+                     static_cast<GLintptr>(vbo->getOffset()),
+                     static_cast<GLsizei>(layout.getStride()));
+  glVertexBindingDivisor(binding, divisor);
+  for (const auto& attribute : attributes) {
+    glVertexAttribFormat(attribute.location,
+                         static_cast<GLint>(attribute.components),
+                         static_cast<GLenum>(attribute.type),
+                         attribute.normalized ? GL_TRUE : GL_FALSE,
+                         attribute.offset);
+    glVertexAttribBinding(attribute.location, binding);
+    glEnableVertexAttribArray(attribute.location);
   }
   bind(false);
 }
@@ -11,6 +11,7 @@
 #include "prgl/VertexBufferObject.hxx"
 
 #include <iostream>
+#include <stdexcept>
 
 #include "prgl/glCommon.hxx"
 
@@ -21,14 +22,35 @@ VertexBufferObject::VertexBufferObject(const Usage usage)
       mDataType(DataType::Float),
       mDataColumns(0U),
       mVerticesCount(0U),
-      mUsage(usage) {
+      mUsage(usage),
+      mHeap(nullptr),
+      mAllocation({INVALID_HANDLE, 0U, 0U, 0U, 0U}) {
   glGenBuffers(1, &mVbo);
 }
 
 VertexBufferObject::VertexBufferObject()
     : VertexBufferObject(Usage::StaticDraw) {}
 
+VertexBufferObject::VertexBufferObject(const std::shared_ptr<BufferHeap>& heap)
+    : mVbo(INVALID_HANDLE),
+      mDataType(DataType::Float),
+      mDataColumns(0U),
+      mVerticesCount(0U),
+      mUsage(Usage::StaticDraw),
+      mHeap(heap),
+      mAllocation({INVALID_HANDLE, 0U, 0U, 0U, 0U}) {
+  if (heap == nullptr) {
+    throw std::invalid_argument("VertexBufferObject: heap is null");
+  }
+}
+
 VertexBufferObject::~VertexBufferObject() {
+  if (mHeap != nullptr) {
+    if (mAllocation.size > 0U) {
+      mHeap->free(mAllocation);
+    }
+    return;
+  }
   glDeleteBuffers(1, &mVbo);
   mVbo = INVALID_HANDLE;
 }
@@ -40,12 +62,58 @@ VertexBufferObject::~VertexBufferObject() {
  */
 void VertexBufferObject::bind(bool bind) const {
   if (bind) {
-    glBindBuffer(GL_ARRAY_BUFFER, mVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, getHandle());
   } else {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
   }
 }
 
+/**
+ * @brief Upload count vertices of stride bytes each. The buffer has no single
+ * component type, getVertexComponentDataColumns() returns 0.
+ */
+void VertexBufferObject::createInterleavedBuffer(const void* dataPtr,
+                                                 std::size_t stride,
+                                                 std::size_t count) {
+  mDataType      = DataType::UnsignedByte;
+  mDataColumns   = 0U;
+  mVerticesCount = count;
+
+  allocate(dataPtr, stride * count);
+}
+
+void VertexBufferObject::allocate(const void* dataPtr, std::size_t nBytes) {
+  if (mHeap != nullptr) {
+    if (mAllocation.size > 0U) {
+      mHeap->free(mAllocation);
+      mAllocation.size = 0U;
+    }
+    if (nBytes > 0U) {
+      mAllocation = mHeap->allocate(nBytes);
+      if (dataPtr != nullptr) {
+        mHeap->upload(mAllocation, dataPtr, nBytes);
+      }
+    }
+    return;
+  }
+  bind(true);
+  glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(nBytes), dataPtr,
+               static_cast<GLenum>(mUsage));
+  bind(false);
+}
+
+void VertexBufferObject::uploadRange(const void* dataPtr, std::size_t offset,
+                                     std::size_t nBytes) {
+  if (mHeap != nullptr) {
+    mHeap->upload(mAllocation, dataPtr, nBytes, offset);
+    return;
+  }
+  bind(true);
+  glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset),
+                  static_cast<GLsizeiptr>(nBytes), dataPtr);
+  bind(false);
+}
+
 DataType VertexBufferObject::getVertexComponentDataType() const {
   return mDataType;
 }
@@ -58,4 +126,19 @@ size_t VertexBufferObject::getVerticesCount() const {
   return mVerticesCount;
 }
 
+uint32_t VertexBufferObject::getHandle() const {
+  if ((mHeap != nullptr) && (mAllocation.size > 0U)) {
+    return mHeap->resolve(mAllocation).buffer;
+  }
+  return mVbo;
+}
+
+std::size_t VertexBufferObject::getOffset() const {
+  if ((mHeap != nullptr) && (mAllocation.size > 0U)) {
+    // moves with BufferHeap::defragment
+    return mHeap->resolve(mAllocation).offset;
+  }
+  return 0U;
+}
+
 }  // namespace prgl
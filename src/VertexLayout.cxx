@@ -0,0 +1,51 @@
+#include "prgl/VertexLayout.hxx"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace prgl {
+
+VertexLayout::VertexLayout(uint32_t stride)
+    : mStride(stride), mEnd(0U), mAttributes() {}
+
+VertexLayout& VertexLayout::add(uint32_t location, uint32_t components,
+                                DataType type, bool normalized) {
+  const auto size = static_cast<uint32_t>(getSizeInBytes(type));
+  return add(location, components, type, normalized,
+             ((mEnd + size - 1U) / size) * size);
+}
+
+VertexLayout& VertexLayout::add(uint32_t location, uint32_t components,
+                                DataType type, bool normalized,
+                                uint32_t offset) {
+  if ((components == 0U) || (components > 4U)) {
+    throw std::invalid_argument(
+      "VertexLayout::add: an attribute has 1 to 4 components");
+  }
+  for (const auto& attribute : mAttributes) {
+    if (attribute.location == location) {
+      throw std::invalid_argument(
+        "VertexLayout::add: location is already used");
+    }
+  }
+  const auto end =
+    offset + components * static_cast<uint32_t>(getSizeInBytes(type));
+  if ((mStride > 0U) && (end > mStride)) {
+    throw std::invalid_argument(
+      "VertexLayout::add: attribute exceeds the stride");
+  }
+  mAttributes.push_back({location, components, type, normalized, offset});
+  mEnd = std::max(mEnd, end);
+  return *this;
+}
+
+uint32_t VertexLayout::getStride() const {
+  return (mStride > 0U) ? mStride : mEnd;
+}
+
+const std::vector<VertexLayout::Attribute>& VertexLayout::getAttributes()
+  const {
+  return mAttributes;
+}
+
+}  // namespace prgl
@@ -0,0 +1,104 @@
+/**
+ * @file BarrierTrackerTest.cxx
+ * @author thomas lindemeier
+ *
+ * @brief
+ *
+ * @date 2026-10-17
+ *
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "prgl/BarrierTracker.hxx"
+
+namespace {
+using Access = prgl::BarrierTracker::Access;
+
+constexpr uint32_t Image  = 1U;
+constexpr uint32_t Buffer = 1U;
+
+// barriers are recorded instead of issued
+struct Recorder {
+  std::vector<GLbitfield> barriers;
+
+  prgl::BarrierTracker::MemoryBarrier function() {
+    return [this](GLbitfield bits) { barriers.push_back(bits); };
+  }
+};
+}  // namespace
+
+TEST(BarrierTrackerTest, elidesBarriersWithoutIncoherentWrites) {
+  Recorder recorder;
+  prgl::BarrierTracker tracker(recorder.function());
+
+  tracker.useTexture(Image, Access::TextureFetch, false);
+  EXPECT_EQ(tracker.flush(), 0U);
+  // render target writes are coherent for later draws
+  tracker.useTexture(Image, Access::Framebuffer, true);
+  EXPECT_EQ(tracker.flush(), 0U);
+  tracker.useTexture(Image, Access::TextureFetch, false);
+  EXPECT_EQ(tracker.flush(), 0U);
+
+  EXPECT_TRUE(recorder.barriers.empty());
+  EXPECT_EQ(tracker.getStatistics().issued, 0U);
+  EXPECT_EQ(tracker.getStatistics().elided, 3U);
+}
+
+TEST(BarrierTrackerTest, issuesOnlyTheBitsOfTheReader) {
+  Recorder recorder;
+  prgl::BarrierTracker tracker(recorder.function());
+
+  tracker.useTexture(Image, Access::ImageLoadStore, true);
+  tracker.useBuffer(Buffer, Access::StorageBuffer, true);
+  EXPECT_EQ(tracker.flush(), 0U);
+
+  // the image is sampled, the buffer is not used
+  tracker.useTexture(Image, Access::TextureFetch, false);
+  EXPECT_EQ(tracker.flush(), GL_TEXTURE_FETCH_BARRIER_BIT);
+  // already covered
+  tracker.useTexture(Image, Access::TextureFetch, false);
+  EXPECT_EQ(tracker.flush(), 0U);
+  // the same bit made the buffer visible to texture fetches only
+  tracker.useBuffer(Buffer, Access::BufferUpdate, false);
+  tracker.useTexture(Image, Access::TextureFetch, false);
+  EXPECT_EQ(tracker.flush(), GL_BUFFER_UPDATE_BARRIER_BIT);
+
+  EXPECT_EQ(recorder.barriers,
+            (std::vector<GLbitfield>{GL_TEXTURE_FETCH_BARRIER_BIT,
+                                     GL_BUFFER_UPDATE_BARRIER_BIT}));
+  EXPECT_EQ(tracker.getStatistics().issued, 2U);
+  EXPECT_EQ(tracker.getStatistics().elided, 2U);
+}
+
+TEST(BarrierTrackerTest, redeclaredWritesNeedANewBarrier) {
+  Recorder recorder;
+  prgl::BarrierTracker tracker(recorder.function());
+
+  // two dispatches writing the same bound buffer, the second one reads the
+  // results of the first
+  for (auto dispatch = 0U; dispatch < 2U; dispatch++) {
+    tracker.useBuffer(Buffer, Access::StorageBuffer, true);
+    tracker.flush();
+  }
+  tracker.useBuffer(Buffer, Access::StorageBuffer, false);
+  EXPECT_EQ(tracker.flush(), GL_SHADER_STORAGE_BARRIER_BIT);
+
+  EXPECT_EQ(recorder.barriers,
+            (std::vector<GLbitfield>{GL_SHADER_STORAGE_BARRIER_BIT,
+                                     GL_SHADER_STORAGE_BARRIER_BIT}));
+}
+
+TEST(BarrierTrackerTest, resetForgetsWrites) {
+  Recorder recorder;
+  prgl::BarrierTracker tracker(recorder.function());
+
+  tracker.useTexture(Image, Access::ImageLoadStore, true);
+  tracker.flush();
+  // e.g. after GL_ALL_BARRIER_BITS
+  tracker.reset();
+  tracker.useTexture(Image, Access::ImageLoadStore, false);
+  EXPECT_EQ(tracker.flush(), 0U);
+  EXPECT_TRUE(recorder.barriers.empty());
+}
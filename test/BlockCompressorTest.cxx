@@ -0,0 +1,250 @@
+/**
+ * @file BlockCompressorTest.cxx
+ * @author thomas lindemeier
+ *
+ * @brief
+ *
+ * @date 2026-10-17
+ *
+ */
+
+#include <array>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "prgl/BlockCompressor.hxx"
+
+namespace {
+using Pixels = std::array<std::array<int32_t, 4U>, 16U>;
+
+uint32_t readBits(const uint8_t* data, uint32_t& position, uint32_t bits) {
+  auto value = 0U;
+  for (auto bit = 0U; bit < bits; bit++, position++) {
+    value |= ((data[position >> 3U] >> (position & 7U)) & 1U) << bit;
+  }
+  return value;
+}
+
+Pixels decodeBc1(const uint8_t* block) {
+  auto position    = 0U;
+  const auto c0    = readBits(block, position, 16U);
+  const auto c1    = readBits(block, position, 16U);
+  const auto color = [](uint32_t c) {
+    const auto r = (c >> 11U) & 31U;
+    const auto g = (c >> 5U) & 63U;
+    const auto b = c & 31U;
+    return std::array<int32_t, 4U>{static_cast<int32_t>((r << 3U) | (r >> 2U)),
+                                   static_cast<int32_t>((g << 2U) | (g >> 4U)),
+                                   static_cast<int32_t>((b << 3U) | (b >> 2U)),
+                                   255};
+  };
+  std::array<std::array<int32_t, 4U>, 4U> palette = {color(c0), color(c1)};
+  for (auto c = 0U; c < 3U; c++) {
+    if (c0 > c1) {
+      palette[2U][c] = ((2 * palette[0U][c]) + palette[1U][c]) / 3;
+      palette[3U][c] = (palette[0U][c] + (2 * palette[1U][c])) / 3;
+    } else {
+      palette[2U][c] = (palette[0U][c] + palette[1U][c]) / 2;
+      palette[3U][c] = 0;
+    }
+  }
+  palette[2U][3U] = 255;
+  palette[3U][3U] = (c0 > c1) ? 255 : 0;
+
+  Pixels pixels;
+  for (auto& pixel : pixels) {
+    pixel = palette[readBits(block, position, 2U)];
+  }
+  return pixels;
+}
+
+std::array<int32_t, 16U> decodeBc4(const uint8_t* block) {
+  auto position = 0U;
+  const auto a0 = static_cast<int32_t>(readBits(block, position, 8U));
+  const auto a1 = static_cast<int32_t>(readBits(block, position, 8U));
+  std::array<int32_t, 8U> palette = {a0, a1};
+  for (auto i = 2; i < 8; i++) {
+    palette[static_cast<std::size_t>(i)] =
+      (a0 > a1) ? (((8 - i) * a0) + ((i - 1) * a1)) / 7 : a0;
+  }
+  std::array<int32_t, 16U> values;
+  for (auto& value : values) {
+    value = palette[readBits(block, position, 3U)];
+  }
+  return values;
+}
+
+Pixels decodeBc7Mode6(const uint8_t* block) {
+  constexpr std::array<int32_t, 16U> Weights = {
+    0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+  auto position = 0U;
+  EXPECT_EQ(readBits(block, position, 7U), 1U << 6U);
+  std::array<std::array<uint32_t, 4U>, 2U> endpoints;
+  for (auto c = 0U; c < 4U; c++) {
+    endpoints[0U][c] = readBits(block, position, 7U);
+    endpoints[1U][c] = readBits(block, position, 7U);
+  }
+  const auto p0 = readBits(block, position, 1U);
+  const auto p1 = readBits(block, position, 1U);
+  Pixels pixels;
+  for (auto i = 0U; i < 16U; i++) {
+    const auto weight = Weights[readBits(block, position, (i == 0U) ? 3U : 4U)];
+    for (auto c = 0U; c < 4U; c++) {
+      const auto e0 = static_cast<int32_t>((endpoints[0U][c] << 1U) | p0);
+      const auto e1 = static_cast<int32_t>((endpoints[1U][c] << 1U) | p1);
+      pixels[i][c]  = (((64 - weight) * e0) + (weight * e1) + 32) >> 6;
+    }
+  }
+  return pixels;
+}
+
+std::vector<uint8_t> gradient(uint32_t width, uint32_t height) {
+  std::vector<uint8_t> rgba(width * height * 4U);
+  for (auto y = 0U; y < height; y++) {
+    for (auto x = 0U; x < width; x++) {
+      auto* pixel = &rgba[((y * width) + x) * 4U];
+      pixel[0U]   = static_cast<uint8_t>((x * 255U) / (width - 1U));
+      pixel[1U]   = static_cast<uint8_t>((y * 255U) / (height - 1U));
+      pixel[2U]   = static_cast<uint8_t>(255U - pixel[0U]);
+      pixel[3U]   = static_cast<uint8_t>((pixel[0U] + pixel[1U]) / 2U);
+    }
+  }
+  return rgba;
+}
+
+// colors on a line through RGBA space, what a single subset can represent
+std::vector<uint8_t> ramp(uint32_t width, uint32_t height) {
+  std::vector<uint8_t> rgba(width * height * 4U);
+  const std::array<uint32_t, 4U> from = {10U, 200U, 40U, 255U};
+  const std::array<uint32_t, 4U> to   = {250U, 30U, 120U, 60U};
+  for (auto y = 0U; y < height; y++) {
+    for (auto x = 0U; x < width; x++) {
+      const auto t = ((x + y) * 255U) / (width + height - 2U);
+      for (auto c = 0U; c < 4U; c++) {
+        rgba[(((y * width) + x) * 4U) + c] = static_cast<uint8_t>(
+          ((from[c] * (255U - t)) + (to[c] * t)) / 255U);
+      }
+    }
+  }
+  return rgba;
+}
+
+// largest absolute error over the first channels of the decoded 4x4 block
+template <typename Decoded>
+int32_t blockError(const std::vector<uint8_t>& rgba, uint32_t width,
+                   uint32_t blockX, uint32_t blockY, const Decoded& decoded,
+                   uint32_t channels) {
+  auto error = 0;
+  for (auto i = 0U; i < 16U; i++) {
+    const auto x = (blockX * 4U) + (i % 4U);
+    const auto y = (blockY * 4U) + (i / 4U);
+    for (auto c = 0U; c < channels; c++) {
+      const auto original =
+        static_cast<int32_t>(rgba[(((y * width) + x) * 4U) + c]);
+      error = std::max(error, std::abs(decoded[i][c] - original));
+    }
+  }
+  return error;
+}
+}  // namespace
+
+TEST(BlockCompressorTest, outputSize) {
+  const prgl::BlockCompressor compressor(2U);
+  const auto rgba = gradient(10U, 6U);
+
+  EXPECT_EQ(compressor.compress(rgba.data(), 10U, 6U,
+                                prgl::TextureFormatInternal::Bc1Rgb)
+              .size(),
+            3U * 2U * 8U);
+  EXPECT_EQ(compressor.compress(rgba.data(), 10U, 6U,
+                                prgl::TextureFormatInternal::Bc7Rgba)
+              .size(),
+            3U * 2U * 16U);
+  EXPECT_THROW(compressor.compress(rgba.data(), 10U, 6U,
+                                   prgl::TextureFormatInternal::Rgba8),
+               std::invalid_argument);
+}
+
+TEST(BlockCompressorTest, bc1Gradient) {
+  const prgl::BlockCompressor compressor(1U);
+  const auto rgba = gradient(64U, 64U);
+  const auto data = compressor.compress(rgba.data(), 64U, 64U,
+                                        prgl::TextureFormatInternal::Bc1Rgb);
+
+  for (auto blockY = 0U; blockY < 16U; blockY++) {
+    for (auto blockX = 0U; blockX < 16U; blockX++) {
+      const auto decoded = decodeBc1(&data[((blockY * 16U) + blockX) * 8U]);
+      EXPECT_LE(blockError(rgba, 64U, blockX, blockY, decoded, 3U), 16);
+    }
+  }
+}
+
+TEST(BlockCompressorTest, bc1PunchThroughAlpha) {
+  const prgl::BlockCompressor compressor(1U);
+  std::vector<uint8_t> rgba(4U * 4U * 4U, 200U);
+  rgba[3U]  = 0U;
+  rgba[63U] = 0U;
+  const auto data = compressor.compress(rgba.data(), 4U, 4U,
+                                        prgl::TextureFormatInternal::Bc1Rgba);
+
+  const auto decoded = decodeBc1(data.data());
+  EXPECT_EQ(decoded[0U][3U], 0);
+  EXPECT_EQ(decoded[15U][3U], 0);
+  for (auto i = 1U; i < 15U; i++) {
+    EXPECT_EQ(decoded[i][3U], 255);
+    EXPECT_NEAR(decoded[i][0U], 200, 4);
+  }
+}
+
+TEST(BlockCompressorTest, bc4AndBc5Gradient) {
+  const prgl::BlockCompressor compressor(3U);
+  const auto rgba = gradient(32U, 32U);
+  const auto bc4  = compressor.compress(rgba.data(), 32U, 32U,
+                                       prgl::TextureFormatInternal::Bc4R);
+  const auto bc5  = compressor.compress(rgba.data(), 32U, 32U,
+                                       prgl::TextureFormatInternal::Bc5Rg);
+
+  for (auto blockY = 0U; blockY < 8U; blockY++) {
+    for (auto blockX = 0U; blockX < 8U; blockX++) {
+      const auto block = (blockY * 8U) + blockX;
+      const auto red   = decodeBc4(&bc4[block * 8U]);
+      const auto green = decodeBc4(&bc5[(block * 16U) + 8U]);
+      Pixels decoded;
+      for (auto i = 0U; i < 16U; i++) {
+        decoded[i] = {red[i], green[i], 0, 0};
+      }
+      EXPECT_LE(blockError(rgba, 32U, blockX, blockY, decoded, 2U), 3);
+      EXPECT_EQ(decodeBc4(&bc5[block * 16U]), red);
+    }
+  }
+}
+
+TEST(BlockCompressorTest, bc7Ramp) {
+  const prgl::BlockCompressor compressor(4U);
+  const auto rgba = ramp(32U, 32U);
+  const auto data = compressor.compress(rgba.data(), 32U, 32U,
+                                        prgl::TextureFormatInternal::Bc7Rgba);
+
+  for (auto blockY = 0U; blockY < 8U; blockY++) {
+    for (auto blockX = 0U; blockX < 8U; blockX++) {
+      const auto decoded =
+        decodeBc7Mode6(&data[((blockY * 8U) + blockX) * 16U]);
+      EXPECT_LE(blockError(rgba, 32U, blockX, blockY, decoded, 4U), 6);
+    }
+  }
+}
+
+TEST(BlockCompressorTest, independentOfThreadCount) {
+  const auto rgba = gradient(70U, 45U);
+  for (const auto format : {prgl::TextureFormatInternal::Bc1Rgb,
+                            prgl::TextureFormatInternal::Bc3Rgba,
+                            prgl::TextureFormatInternal::Bc7Rgba}) {
+    const auto single =
+      prgl::BlockCompressor(1U).compress(rgba.data(), 70U, 45U, format);
+    const auto multi =
+      prgl::BlockCompressor(5U).compress(rgba.data(), 70U, 45U, format);
+    EXPECT_EQ(single, multi);
+  }
+}
@@ -0,0 +1,109 @@
+/**
+ * @file MappedImageFileTest.cxx
+ * @author thomas lindemeier
+ *
+ * @brief
+ *
+ * @date 2026-10-17
+ *
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "prgl/MappedImageFile.hxx"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+std::string writeFile(const std::string& name, const std::string& content) {
+  const auto path = testing::TempDir() + name;
+  std::ofstream file(path, std::ios::binary);
+  file << content;
+  return path;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+// the next descriptor open() hands out, grows if descriptors leak
+int lowestFreeDescriptor() {
+  const auto file = open("/dev/null", O_RDONLY);
+  close(file);
+  return file;
+}
+#endif
+}  // namespace
+
+TEST(MappedImageFileTest, ppm) {
+  // 2x2 rgb image, a comment in the header and 8 bit samples
+  const auto path = writeFile("prgl_test.ppm",
+                              std::string("P6\n# comment\n2 2\n255\n") +
+                                "\x01\x02\x03\x04\x05\x06"
+                                "\x07\x08\x09\x0a\x0b\x0c");
+
+  const prgl::MappedImageFile image(path);
+  EXPECT_EQ(image.getWidth(), 2U);
+  EXPECT_EQ(image.getHeight(), 2U);
+  EXPECT_EQ(image.getFormat(), prgl::TextureFormat::Rgb);
+  EXPECT_EQ(image.getType(), prgl::DataType::UnsignedByte);
+  EXPECT_EQ(image.getRowSize(), 6U);
+  EXPECT_TRUE(image.isTopDown());
+  EXPECT_EQ(image.getRow(0U)[0U], 1U);
+  EXPECT_EQ(image.getRow(1U)[5U], 12U);
+
+  std::remove(path.c_str());
+}
+
+TEST(MappedImageFileTest, pfmAndTruncated) {
+  // negative scale: little endian floats, stored bottom up
+  std::string pixels(3U * 4U * 2U, '\0');
+  const auto path = writeFile("prgl_test.pfm", "PF\n1 2\n-1.0\n" + pixels);
+
+  const prgl::MappedImageFile image(path);
+  EXPECT_EQ(image.getFormat(), prgl::TextureFormat::Rgb);
+  EXPECT_EQ(image.getType(), prgl::DataType::Float);
+  EXPECT_FALSE(image.isBigEndian());
+  EXPECT_FALSE(image.isTopDown());
+  std::remove(path.c_str());
+
+  const auto truncated =
+    writeFile("prgl_truncated.pfm", "PF\n1 2\n-1.0\n" + pixels.substr(4U));
+  EXPECT_THROW(prgl::MappedImageFile{truncated}, std::runtime_error);
+  std::remove(truncated.c_str());
+}
+
+TEST(MappedImageFileTest, raw) {
+  const auto path = writeFile("prgl_test.raw", std::string(16U + 8U, '\x7f'));
+
+  const prgl::MappedImageFile image(
+    path, {2U, 2U, prgl::TextureFormat::Rg, prgl::DataType::UnsignedByte, 16U,
+           false, false});
+  EXPECT_EQ(image.getRowSize(), 4U);
+  EXPECT_EQ(image.getRow(1U)[3U], 0x7fU);
+
+  std::remove(path.c_str());
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST(MappedImageFileTest, invalidFilesAreClosed) {
+  const auto unsupported = writeFile("prgl_test.bmp", "BM\n1 1\n");
+  const auto raw         = writeFile("prgl_small.raw", std::string(3U, '\0'));
+  const auto before      = lowestFreeDescriptor();
+
+  EXPECT_THROW(prgl::MappedImageFile{unsupported}, std::runtime_error);
+  EXPECT_THROW(
+    (prgl::MappedImageFile{raw,
+                           {2U, 2U, prgl::TextureFormat::Red,
+                            prgl::DataType::UnsignedByte, 0U, false, true}}),
+    std::runtime_error);
+  EXPECT_EQ(lowestFreeDescriptor(), before);
+
+  std::remove(unsupported.c_str());
+  std::remove(raw.c_str());
+}
+#endif
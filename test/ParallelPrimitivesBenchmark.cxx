@@ -0,0 +1,86 @@
+/**
+ * @file ParallelPrimitivesBenchmark.cxx
+ * @author Thomas Lindemeier
+ *
+ * @brief Throughput of the GPU scan, radix sort, histogram and compaction in
+ * elements per second.
+ *
+ * @date 2026-10-17
+ *
+ */
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "prgl/ContextImplementation.hxx"
+#include "prgl/ParallelPrimitives.hxx"
+
+namespace {
+
+constexpr uint32_t NrRuns = 20U;
+
+template <class Run>
+double measureElementsPerSecond(uint32_t count, Run&& run) {
+  // warm up, allocates the scratch buffers
+  run();
+  glFinish();
+
+  const auto start = std::chrono::steady_clock::now();
+  for (auto i = 0U; i < NrRuns; i++) {
+    run();
+  }
+  glFinish();
+  const auto end = std::chrono::steady_clock::now();
+
+  const std::chrono::duration<double> seconds = end - start;
+  return static_cast<double>(count) * NrRuns / seconds.count();
+}
+
+void benchmark(prgl::ParallelPrimitives& primitives, uint32_t count) {
+  std::mt19937 generator(count);
+  std::vector<uint32_t> data(count);
+  for (auto& v : data) {
+    v = static_cast<uint32_t>(generator());
+  }
+  const auto nBytes = static_cast<uint32_t>(count * sizeof(uint32_t));
+  auto input        = prgl::ShaderStorageBuffer::Create();
+  auto output       = prgl::ShaderStorageBuffer::Create();
+  auto bins         = prgl::ShaderStorageBuffer::Create();
+  input->create(data.data(), nBytes);
+  output->create(nullptr, nBytes);
+  bins->create(nullptr, prgl::ParallelPrimitives::MaxBinCount * 4U);
+
+  const auto scan = measureElementsPerSecond(
+    count, [&]() { primitives.scan(input, count); });
+  // sorting sorted keys is as expensive as sorting random ones
+  const auto sort = measureElementsPerSecond(
+    count, [&]() { primitives.sort(input, nullptr, count); });
+  const auto histogram = measureElementsPerSecond(count, [&]() {
+    primitives.histogram(input, count, bins,
+                         prgl::ParallelPrimitives::MaxBinCount, 1U << 24U);
+  });
+  const auto compact = measureElementsPerSecond(
+    count, [&]() { primitives.compact(input, input, output, count); });
+
+  const auto toM = 1.0e-6;
+  std::cout << count << " elements: scan " << scan * toM
+            << " M/s, sort " << sort * toM << " M/s, histogram "
+            << histogram * toM << " M/s, compact " << compact * toM
+            << " M/s" << std::endl;
+}
+
+}  // namespace
+
+int32_t main(int32_t /*argc*/, char** /*args*/) {
+  // hidden window providing the context
+  prgl::ContextImplementation context;
+  prgl::ParallelPrimitives primitives;
+
+  for (const auto count : {1U << 16U, 1U << 20U, 1U << 24U}) {
+    benchmark(primitives, count);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file ParallelPrimitivesTest.cxx
+ * @author thomas lindemeier
+ *
+ * @brief Compares the GPU primitives with CPU results, needs a display.
+ *
+ * @date 2026-10-17
+ *
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "prgl/ContextImplementation.hxx"
+#include "prgl/ParallelPrimitives.hxx"
+
+namespace {
+// sizes around the work group and block boundaries, the last one needs a
+// second level of block sums
+const std::vector<uint32_t> Counts = {1U,    255U,   512U,   513U,
+                                      1024U, 4099U,  65536U, 300001U};
+
+class ParallelPrimitivesTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if ((std::getenv("DISPLAY") == nullptr) &&
+        (std::getenv("WAYLAND_DISPLAY") == nullptr)) {
+      GTEST_SKIP() << "no display for a GL context";
+    }
+    mContext    = std::make_unique<prgl::ContextImplementation>();
+    mPrimitives = prgl::ParallelPrimitives::Create();
+  }
+
+  void TearDown() override {
+    mPrimitives.reset();
+    mContext.reset();
+  }
+
+  static std::shared_ptr<prgl::ShaderStorageBuffer> upload(
+    const std::vector<uint32_t>& data) {
+    auto buffer = prgl::ShaderStorageBuffer::Create();
+    buffer->create(data.data(),
+                   static_cast<uint32_t>(data.size() * sizeof(uint32_t)));
+    return buffer;
+  }
+
+  static std::vector<uint32_t> download(
+    const std::shared_ptr<prgl::ShaderStorageBuffer>& buffer,
+    std::size_t count) {
+    std::vector<uint32_t> data(count);
+    glGetNamedBufferSubData(
+      buffer->getHandle(), 0,
+      static_cast<GLsizeiptr>(count * sizeof(uint32_t)), data.data());
+    return data;
+  }
+
+  static std::vector<uint32_t> random(std::size_t count, uint32_t max) {
+    std::mt19937 generator(static_cast<uint32_t>(count));
+    std::uniform_int_distribution<uint32_t> distribution(0U, max);
+    std::vector<uint32_t> data(count);
+    for (auto& v : data) {
+      v = distribution(generator);
+    }
+    return data;
+  }
+
+  std::unique_ptr<prgl::ContextImplementation> mContext;
+  std::shared_ptr<prgl::ParallelPrimitives> mPrimitives;
+};
+}  // namespace
+
+TEST_F(ParallelPrimitivesTest, exclusiveScan) {
+  for (const auto count : Counts) {
+    const auto input = random(count, 7U);
+    auto buffer      = upload(input);
+    mPrimitives->scan(buffer, count);
+
+    std::vector<uint32_t> expected(count, 0U);
+    std::partial_sum(input.begin(), input.end() - 1, expected.begin() + 1);
+    EXPECT_EQ(download(buffer, count), expected) << "count " << count;
+  }
+}
+
+TEST_F(ParallelPrimitivesTest, inclusiveScanOfRange) {
+  const auto count  = 5000U;
+  const auto offset = 37U;
+  const auto input  = random(offset + count + 11U, 100U);
+  auto buffer       = upload(input);
+  mPrimitives->scan(buffer, count, prgl::ScanType::Inclusive, offset);
+
+  auto expected = input;
+  std::partial_sum(input.begin() + offset, input.begin() + offset + count,
+                   expected.begin() + offset);
+  EXPECT_EQ(download(buffer, input.size()), expected);
+}
+
+TEST_F(ParallelPrimitivesTest, sortKeys) {
+  for (const auto count : Counts) {
+    const auto input = random(count, 0xFFFFFFFFU);
+    auto buffer      = upload(input);
+    mPrimitives->sort(buffer, nullptr, count);
+
+    auto expected = input;
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(download(buffer, count), expected) << "count " << count;
+  }
+}
+
+TEST_F(ParallelPrimitivesTest, sortIsStable) {
+  // few distinct keys, values record the original order
+  const auto count = 70000U;
+  const auto keys  = random(count, 300U);
+  std::vector<uint32_t> values(count);
+  std::iota(values.begin(), values.end(), 0U);
+  auto keyBuffer   = upload(keys);
+  auto valueBuffer = upload(values);
+  // 9 bits, an odd number of passes
+  mPrimitives->sort(keyBuffer, valueBuffer, count, 0U, 9U);
+
+  std::vector<std::pair<uint32_t, uint32_t>> expected(count);
+  for (auto i = 0U; i < count; i++) {
+    expected[i] = {keys[i], values[i]};
+  }
+  std::stable_sort(
+    expected.begin(), expected.end(),
+    [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  const auto sortedKeys   = download(keyBuffer, count);
+  const auto sortedValues = download(valueBuffer, count);
+  for (auto i = 0U; i < count; i++) {
+    ASSERT_EQ(sortedKeys[i], expected[i].first) << "index " << i;
+    ASSERT_EQ(sortedValues[i], expected[i].second) << "index " << i;
+  }
+}
+
+TEST_F(ParallelPrimitivesTest, histogram) {
+  const auto count    = 123457U;
+  const auto binCount = 64U;
+  const auto binWidth = 3U;
+  const auto input    = random(count, 250U);
+  auto values         = upload(input);
+  auto bins           = upload(std::vector<uint32_t>(binCount, 42U));
+  mPrimitives->histogram(values, count, bins, binCount, binWidth);
+
+  std::vector<uint32_t> expected(binCount, 0U);
+  for (const auto v : input) {
+    expected[std::min(v / binWidth, binCount - 1U)]++;
+  }
+  EXPECT_EQ(download(bins, binCount), expected);
+  EXPECT_THROW(mPrimitives->histogram(values, count, bins, 257U),
+               std::invalid_argument);
+}
+
+TEST_F(ParallelPrimitivesTest, compact) {
+  for (const auto count : Counts) {
+    const auto input = random(count, 9U);
+    auto buffer      = upload(input);
+    auto output      = upload(std::vector<uint32_t>(count, 0U));
+    // zero values are dropped
+    mPrimitives->compact(buffer, buffer, output, count);
+
+    std::vector<uint32_t> expected;
+    std::copy_if(input.begin(), input.end(), std::back_inserter(expected),
+                 [](uint32_t v) { return v != 0U; });
+    ASSERT_EQ(mPrimitives->getCompactedCount(), expected.size())
+      << "count " << count;
+    EXPECT_EQ(download(output, expected.size()), expected)
+      << "count " << count;
+  }
+}
@@ -0,0 +1,158 @@
+/**
+ * @file PassGraphTest.cxx
+ * @author thomas lindemeier
+ *
+ * @brief
+ *
+ * @date 2026-10-17
+ *
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "prgl/PassGraph.hxx"
+
+namespace {
+using Access = prgl::BarrierTracker::Access;
+
+const prgl::PassGraph::TextureDescriptor Hdr = {
+  256U, 256U, prgl::TextureFormatInternal::Rgba16F, 1U};
+}  // namespace
+
+TEST(PassGraphTest, sortsByDependencies) {
+  prgl::PassGraph graph;
+  const auto a = graph.createTexture("a", Hdr);
+  const auto b = graph.createTexture("b", Hdr);
+
+  // added in reverse order of execution
+  const auto present = graph.addPass("present", nullptr);
+  const auto blur    = graph.addPass("blur", nullptr);
+  const auto scene   = graph.addPass("scene", nullptr);
+  const auto aScene  = graph.write(scene, a, Access::Framebuffer);
+  graph.read(blur, aScene, Access::TextureFetch);
+  const auto bBlur = graph.write(blur, b, Access::ImageLoadStore);
+  graph.read(present, bBlur, Access::TextureFetch);
+  graph.setSideEffect(present);
+  graph.compile();
+
+  EXPECT_EQ(graph.getOrder(), (std::vector<uint32_t>{scene, blur, present}));
+}
+
+TEST(PassGraphTest, cullsUnusedPasses) {
+  prgl::PassGraph graph;
+  const auto color = graph.createTexture("color", Hdr);
+  const auto debug = graph.createBuffer("debug", 1024U);
+
+  const auto scene       = graph.addPass("scene", nullptr);
+  const auto colorScene  = graph.write(scene, color, Access::Framebuffer);
+  const auto statistics  = graph.addPass("statistics", nullptr);
+  const auto debugFilled = graph.write(statistics, debug,
+                                       Access::StorageBuffer);
+  graph.read(statistics, colorScene, Access::TextureFetch);
+  const auto present = graph.addPass("present", nullptr);
+  graph.read(present, colorScene, Access::TextureFetch);
+  graph.setSideEffect(present);
+  graph.compile();
+
+  EXPECT_FALSE(graph.isCulled(scene));
+  EXPECT_TRUE(graph.isCulled(statistics));
+  EXPECT_FALSE(graph.isCulled(present));
+  EXPECT_EQ(graph.getPhysicalIndex(debugFilled), prgl::PassGraph::Culled);
+  EXPECT_EQ(graph.getStatistics().culled, 1U);
+  EXPECT_EQ(graph.getStatistics().physicalBuffers, 0U);
+}
+
+TEST(PassGraphTest, aliasesTransientsWithDisjointLifetimes) {
+  // ping pong chain of five passes over four textures
+  prgl::PassGraph graph;
+  std::vector<prgl::PassGraph::Handle> textures;
+  for (auto i = 0U; i < 4U; i++) {
+    textures.push_back(graph.createTexture("t", Hdr));
+  }
+  auto previous = graph.write(graph.addPass("first", nullptr), textures[0],
+                              Access::Framebuffer);
+  std::vector<prgl::PassGraph::Handle> written = {previous};
+  for (auto i = 1U; i < 4U; i++) {
+    const auto pass = graph.addPass("filter", nullptr);
+    graph.read(pass, previous, Access::TextureFetch);
+    previous = graph.write(pass, textures[i], Access::ImageLoadStore);
+    written.push_back(previous);
+  }
+  const auto last = graph.addPass("last", nullptr);
+  graph.read(last, previous, Access::TextureFetch);
+  graph.setSideEffect(last);
+  graph.compile();
+
+  const auto statistics = graph.getStatistics();
+  EXPECT_EQ(statistics.transientTextures, 4U);
+  EXPECT_EQ(statistics.physicalTextures, 2U);
+  EXPECT_EQ(graph.getPhysicalIndex(written[0]),
+            graph.getPhysicalIndex(written[2]));
+  EXPECT_NE(graph.getPhysicalIndex(written[0]),
+            graph.getPhysicalIndex(written[1]));
+
+  // a different descriptor never shares an object
+  graph.reset();
+  const auto small = graph.createTexture(
+    "small", {128U, 128U, prgl::TextureFormatInternal::Rgba16F, 1U});
+  const auto large = graph.createTexture("large", Hdr);
+  const auto pass0 = graph.addPass("small", nullptr);
+  const auto pass1 = graph.addPass("large", nullptr);
+  graph.read(pass1, graph.write(pass0, small, Access::Framebuffer),
+             Access::TextureFetch);
+  graph.write(pass1, large, Access::Framebuffer);
+  graph.setSideEffect(pass1);
+  graph.compile();
+  EXPECT_EQ(graph.getStatistics().physicalTextures, 2U);
+}
+
+TEST(PassGraphTest, buffersReuseFreeObjects) {
+  prgl::PassGraph graph;
+  const auto a     = graph.createBuffer("a", 256U);
+  const auto b     = graph.createBuffer("b", 4096U);
+  const auto c     = graph.createBuffer("c", 1024U);
+  const auto first = graph.addPass("first", nullptr);
+  const auto aW    = graph.write(first, a, Access::StorageBuffer);
+  const auto mid   = graph.addPass("mid", nullptr);
+  graph.read(mid, aW, Access::StorageBuffer);
+  const auto bW   = graph.write(mid, b, Access::StorageBuffer);
+  const auto last = graph.addPass("last", nullptr);
+  graph.read(last, bW, Access::StorageBuffer);
+  const auto cW = graph.write(last, c, Access::StorageBuffer);
+  graph.setSideEffect(last);
+  graph.compile();
+
+  EXPECT_EQ(graph.getStatistics().physicalBuffers, 2U);
+  EXPECT_EQ(graph.getPhysicalIndex(aW), graph.getPhysicalIndex(cW));
+}
+
+TEST(PassGraphTest, rejectsStaleWrites) {
+  prgl::PassGraph graph;
+  const auto t     = graph.createTexture("t", Hdr);
+  const auto pass0 = graph.addPass("0", nullptr);
+  const auto pass1 = graph.addPass("1", nullptr);
+  graph.write(pass0, t, Access::Framebuffer);
+  EXPECT_THROW(graph.write(pass1, t, Access::Framebuffer),
+               std::invalid_argument);
+  EXPECT_THROW(graph.read(7U, t, Access::TextureFetch), std::invalid_argument);
+  EXPECT_THROW(graph.createBuffer("empty", 0U), std::invalid_argument);
+}
+
+TEST(PassGraphTest, readersRunBeforeOverwrite) {
+  prgl::PassGraph graph;
+  const auto t      = graph.createTexture("t", Hdr);
+  const auto write0 = graph.addPass("write0", nullptr);
+  const auto write1 = graph.addPass("write1", nullptr);
+  const auto reader = graph.addPass("reader", nullptr);
+  const auto t0     = graph.write(write0, t, Access::ImageLoadStore);
+  graph.write(write1, t0, Access::ImageLoadStore);
+  // reads the first version, must run before write1
+  graph.read(reader, t0, Access::TextureFetch);
+  graph.setSideEffect(reader);
+  graph.setSideEffect(write1);
+  graph.compile();
+
+  EXPECT_EQ(graph.getOrder(),
+            (std::vector<uint32_t>{write0, reader, write1}));
+}
@@ -0,0 +1,84 @@
+/**
+ * @file ProgramBinaryCacheTest.cxx
+ * @author thomas lindemeier
+ *
+ * @brief
+ *
+ * @date 2026-10-17
+ *
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "prgl/ProgramBinaryCache.hxx"
+
+namespace {
+// cache file with the given header, identity and payloadSize bytes of payload
+void writeEntry(const std::string& path, const std::string& identity,
+                uint64_t size, std::size_t payloadSize) {
+  std::ofstream file(path, std::ios::binary);
+  const uint32_t magic        = 0x32475250U;
+  const uint32_t format       = 1U;
+  const uint64_t identitySize = identity.size();
+  file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+  file.write(reinterpret_cast<const char*>(&format), sizeof(format));
+  file.write(reinterpret_cast<const char*>(&identitySize),
+             sizeof(identitySize));
+  file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  file << identity << std::string(payloadSize, '\x2a');
+}
+
+class ProgramBinaryCacheTest : public ::testing::Test {
+ protected:
+  ProgramBinaryCacheTest()
+      : mDirectory(testing::TempDir() + "prgl_binary_cache"),
+        mCache(mDirectory) {}
+
+  ~ProgramBinaryCacheTest() override {
+    std::filesystem::remove_all(mDirectory);
+  }
+
+  std::string path(const prgl::ProgramBinaryCache::Key& key) const {
+    return (std::filesystem::path(mDirectory) / (key.name + ".bin")).string();
+  }
+
+  std::string mDirectory;
+  prgl::ProgramBinaryCache mCache;
+};
+}  // namespace
+
+TEST_F(ProgramBinaryCacheTest, sizeMismatchIsAMiss) {
+  // a huge size must not be allocated
+  const prgl::ProgramBinaryCache::Key huge = {"huge", "source"};
+  writeEntry(path(huge), huge.identity, 1ULL << 62U, 16U);
+  EXPECT_FALSE(mCache.load(0U, huge));
+  EXPECT_FALSE(std::filesystem::exists(path(huge)));
+
+  const prgl::ProgramBinaryCache::Key truncated = {"short", "source"};
+  writeEntry(path(truncated), truncated.identity, 32U, 16U);
+  EXPECT_FALSE(mCache.load(0U, truncated));
+  EXPECT_FALSE(std::filesystem::exists(path(truncated)));
+
+  EXPECT_FALSE(mCache.load(0U, {"missing", "source"}));
+  EXPECT_EQ(mCache.getMisses(), 3U);
+  EXPECT_EQ(mCache.getHits(), 0U);
+}
+
+TEST_F(ProgramBinaryCacheTest, identityMismatchIsAMiss) {
+  // same name, e.g. a hash collision, but other sources
+  const prgl::ProgramBinaryCache::Key key = {"collision", "source a"};
+  writeEntry(path(key), "source b", 16U, 16U);
+  EXPECT_FALSE(mCache.load(0U, key));
+  EXPECT_FALSE(std::filesystem::exists(path(key)));
+
+  // the identity sizes differ
+  writeEntry(path(key), "other source", 16U, 16U);
+  EXPECT_FALSE(mCache.load(0U, key));
+  EXPECT_FALSE(std::filesystem::exists(path(key)));
+
+  EXPECT_EQ(mCache.getMisses(), 2U);
+  EXPECT_EQ(mCache.getHits(), 0U);
+}
@@ -0,0 +1,75 @@
+/**
+ * @file RectanglePackerTest.cxx
+ * @author thomas lindemeier
+ *
+ * @brief
+ *
+ * @date 2026-10-17
+ *
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "prgl/RectanglePacker.hxx"
+
+namespace {
+bool overlap(const prgl::RectanglePacker::Rect& a,
+             const prgl::RectanglePacker::Rect& b) {
+  return (a.x < (b.x + b.width)) && (b.x < (a.x + a.width)) &&
+         (a.y < (b.y + b.height)) && (b.y < (a.y + a.height));
+}
+}  // namespace
+
+TEST(RectanglePackerTest, fillsAreaWithoutOverlap) {
+  prgl::RectanglePacker packer(64U, 64U);
+
+  std::vector<prgl::RectanglePacker::Rect> rects;
+  for (auto i = 0U; i < 16U; i++) {
+    const auto rect = packer.insert(16U, 16U);
+    ASSERT_TRUE(rect.has_value());
+    EXPECT_LE(rect->x + rect->width, 64U);
+    EXPECT_LE(rect->y + rect->height, 64U);
+    for (const auto& other : rects) {
+      EXPECT_FALSE(overlap(*rect, other));
+    }
+    rects.push_back(*rect);
+  }
+
+  EXPECT_FLOAT_EQ(packer.getOccupancy(), 1.0F);
+  EXPECT_FALSE(packer.insert(1U, 1U).has_value());
+}
+
+TEST(RectanglePackerTest, mixedSizes) {
+  prgl::RectanglePacker packer(128U, 128U);
+
+  std::vector<prgl::RectanglePacker::Rect> rects;
+  for (auto i = 0U; i < 40U; i++) {
+    const auto size = 4U + ((i * 7U) % 21U);
+    const auto rect = packer.insert(size, 24U - (size / 2U));
+    if (!rect) {
+      continue;
+    }
+    for (const auto& other : rects) {
+      EXPECT_FALSE(overlap(*rect, other));
+    }
+    rects.push_back(*rect);
+  }
+  EXPECT_GT(rects.size(), 30U);
+}
+
+TEST(RectanglePackerTest, rejectsInvalidSizes) {
+  prgl::RectanglePacker packer(32U, 32U);
+
+  EXPECT_FALSE(packer.insert(0U, 8U).has_value());
+  EXPECT_FALSE(packer.insert(33U, 8U).has_value());
+  EXPECT_FALSE(packer.insert(8U, 33U).has_value());
+
+  ASSERT_TRUE(packer.insert(32U, 32U).has_value());
+  packer.clear();
+  EXPECT_FLOAT_EQ(packer.getOccupancy(), 0.0F);
+  const auto rect = packer.insert(8U, 8U);
+  ASSERT_TRUE(rect.has_value());
+  EXPECT_EQ(rect->x, 0U);
+  EXPECT_EQ(rect->y, 0U);
+}
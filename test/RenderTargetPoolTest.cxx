@@ -0,0 +1,135 @@
+/**
+ * @file RenderTargetPoolTest.cxx
+ * @author thomas lindemeier
+ *
+ * @brief Creates real render targets, needs a display.
+ *
+ * @date 2026-10-18
+ *
+ */
+
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+#include "prgl/ContextImplementation.hxx"
+#include "prgl/RenderTargetPool.hxx"
+
+namespace {
+using Format = prgl::TextureFormatInternal;
+
+class RenderTargetPoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if ((std::getenv("DISPLAY") == nullptr) &&
+        (std::getenv("WAYLAND_DISPLAY") == nullptr)) {
+      GTEST_SKIP() << "no display for a GL context";
+    }
+    mContext = std::make_unique<prgl::ContextImplementation>();
+    mPool    = prgl::RenderTargetPool::Create(2U);
+  }
+
+  void TearDown() override {
+    mPool.reset();
+    mContext.reset();
+  }
+
+  std::unique_ptr<prgl::ContextImplementation> mContext;
+  std::shared_ptr<prgl::RenderTargetPool> mPool;
+};
+}  // namespace
+
+TEST_F(RenderTargetPoolTest, hitOnSameDescriptor) {
+  auto first             = mPool->acquire(64U, 32U, Format::Rgba16F);
+  const auto* released   = first.get();
+  const auto framebuffer = first->getId();
+  mPool->release(first);
+  first.reset();
+
+  const auto second = mPool->acquire(64U, 32U, Format::Rgba16F);
+  EXPECT_EQ(second.get(), released);
+  EXPECT_EQ(second->getId(), framebuffer);
+  EXPECT_EQ(second->getTarget()->getMipLevelCount(), 1U);
+
+  const auto statistics = mPool->getStatistics();
+  EXPECT_EQ(statistics.hits, 1U);
+  EXPECT_EQ(statistics.misses, 1U);
+  EXPECT_EQ(statistics.inUse, 1U);
+}
+
+TEST_F(RenderTargetPoolTest, missOnOtherLevelsOrFormat) {
+  const auto single = mPool->acquire(64U, 64U, Format::Rgba16F, 1U);
+  const auto id     = single->getId();
+  mPool->release(single);
+
+  // a full chain must not alias the single level target
+  const auto chain = mPool->acquire(64U, 64U, Format::Rgba16F, 0U);
+  EXPECT_NE(chain->getId(), id);
+  EXPECT_EQ(chain->getTarget()->getMipLevelCount(), 7U);
+  mPool->release(chain);
+
+  const auto format = mPool->acquire(64U, 64U, Format::Rgba8, 1U);
+  EXPECT_NE(format->getId(), id);
+  EXPECT_NE(format->getId(), chain->getId());
+
+  // the full chain is the same target however its level count is written
+  const auto explicitChain = mPool->acquire(64U, 64U, Format::Rgba16F, 7U);
+  EXPECT_EQ(explicitChain->getId(), chain->getId());
+
+  const auto statistics = mPool->getStatistics();
+  EXPECT_EQ(statistics.misses, 3U);
+  EXPECT_EQ(statistics.hits, 1U);
+}
+
+TEST_F(RenderTargetPoolTest, reuseAfterRelease) {
+  auto target   = mPool->acquire(16U, 16U);
+  const auto id = target->getId();
+
+  // in use, a second request needs a new target
+  const auto other = mPool->acquire(16U, 16U);
+  EXPECT_NE(other->getId(), id);
+
+  mPool->release(target);
+  EXPECT_EQ(mPool->acquire(16U, 16U)->getId(), id);
+
+  EXPECT_THROW(mPool->release(prgl::FrameBufferObject::Create()),
+               std::invalid_argument);
+}
+
+TEST_F(RenderTargetPoolTest, droppedTargetIsReleased) {
+  const prgl::FrameBufferObject* dropped = nullptr;
+  {
+    const auto target = mPool->acquire(16U, 16U);
+    dropped           = target.get();
+    EXPECT_EQ(mPool->getStatistics().inUse, 1U);
+  }
+  EXPECT_EQ(mPool->getStatistics().inUse, 0U);
+  EXPECT_EQ(mPool->getStatistics().available, 1U);
+
+  const auto target = mPool->acquire(16U, 16U);
+  EXPECT_EQ(target.get(), dropped);
+  EXPECT_EQ(mPool->getStatistics().hits, 1U);
+}
+
+TEST_F(RenderTargetPoolTest, evictsIdleTargets) {
+  mPool->release(mPool->acquire(16U, 16U));
+  mPool->release(mPool->acquire(32U, 32U));
+
+  // kept for maxIdleFrames frames
+  mPool->nextFrame();
+  mPool->nextFrame();
+  EXPECT_EQ(mPool->getStatistics().available, 2U);
+
+  // requesting a target keeps it alive
+  mPool->release(mPool->acquire(32U, 32U));
+  mPool->nextFrame();
+  auto statistics = mPool->getStatistics();
+  EXPECT_EQ(statistics.available, 1U);
+  EXPECT_EQ(statistics.evictions, 1U);
+
+  mPool->clear();
+  statistics = mPool->getStatistics();
+  EXPECT_EQ(statistics.available, 0U);
+  EXPECT_EQ(statistics.evictions, 2U);
+}
@@ -0,0 +1,94 @@
+/**
+ * @file ShaderPreprocessorTest.cxx
+ * @author thomas lindemeier
+ *
+ * @brief
+ *
+ * @date 2026-10-17
+ *
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "prgl/ShaderPreprocessor.hxx"
+
+namespace {
+std::string writeFile(const std::string& name, const std::string& content) {
+  const auto directory =
+    std::filesystem::path(testing::TempDir()) / "prgl_preprocessor";
+  std::filesystem::create_directories(directory / "lib");
+  const auto path = directory / name;
+  std::ofstream file(path, std::ios::binary);
+  file << content;
+  return path.string();
+}
+}  // namespace
+
+TEST(ShaderPreprocessorTest, expandsIncludesWithLineDirectives) {
+  writeFile("lib/common.glsl",
+            "#pragma once\nfloat common() { return 1.0; }\n");
+  writeFile("lib/math.glsl", "#include \"common.glsl\"\nfloat twice();\n");
+  const auto path = writeFile(
+    "main.glsl",
+    "#version 430\n#include \"lib/math.glsl\"\n#include "
+    "\"lib/common.glsl\"\nvoid main() {}\n");
+
+  prgl::ShaderPreprocessor preprocessor;
+  const auto result = preprocessor.process(path);
+
+  ASSERT_EQ(result.files.size(), 3U);
+  EXPECT_EQ(std::filesystem::path(result.files[0U]).filename(), "main.glsl");
+  EXPECT_EQ(std::filesystem::path(result.files[1U]).filename(), "math.glsl");
+  EXPECT_EQ(std::filesystem::path(result.files[2U]).filename(),
+            "common.glsl");
+
+  const std::string expected =
+    "#version 430\n"
+    "#line 1 1\n"
+    "#line 1 2\n"
+    "\n"
+    "float common() { return 1.0; }\n"
+    "#line 2 1\n"
+    "float twice();\n"
+    "#line 3 0\n"
+    // included once only
+    "#line 1 2\n"
+    "#line 4 0\n"
+    "void main() {}\n";
+  EXPECT_EQ(result.source, expected);
+}
+
+TEST(ShaderPreprocessorTest, searchesIncludePaths) {
+  const auto library = writeFile("lib/noise.glsl", "float noise();\n");
+  const auto path    = writeFile("search.glsl", "#include <noise.glsl>\n");
+
+  prgl::ShaderPreprocessor preprocessor(
+    {std::filesystem::path(library).parent_path().string()});
+  const auto result = preprocessor.process(path);
+  EXPECT_NE(result.source.find("float noise();"), std::string::npos);
+}
+
+TEST(ShaderPreprocessorTest, cachesUntilInvalidated) {
+  const auto path = writeFile("cached.glsl", "old\n");
+  prgl::ShaderPreprocessor preprocessor;
+  EXPECT_EQ(preprocessor.process(path).source, "old\n");
+
+  writeFile("cached.glsl", "new\n");
+  EXPECT_EQ(preprocessor.process(path).source, "old\n");
+  preprocessor.invalidate(path);
+  EXPECT_EQ(preprocessor.process(path).source, "new\n");
+}
+
+TEST(ShaderPreprocessorTest, rejectsCyclesAndMissingFiles) {
+  writeFile("a.glsl", "#include \"b.glsl\"\n");
+  const auto path    = writeFile("b.glsl", "#include \"a.glsl\"\n");
+  const auto missing = writeFile("missing.glsl", "#include \"none.glsl\"\n");
+
+  prgl::ShaderPreprocessor preprocessor;
+  EXPECT_THROW(preprocessor.process(path), std::runtime_error);
+  EXPECT_THROW(preprocessor.process(missing), std::runtime_error);
+}
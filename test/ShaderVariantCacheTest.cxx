@@ -0,0 +1,71 @@
+/**
+ * @file ShaderVariantCacheTest.cxx
+ * @author thomas lindemeier
+ *
+ * @brief
+ *
+ * @date 2026-10-17
+ *
+ */
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "prgl/ShaderVariantCache.hxx"
+
+TEST(ShaderVariantCacheTest, injectsDefinesAfterVersion) {
+  const std::string source =
+    "// blur kernel\n"
+    "  #version 430\n"
+    "#extension GL_ARB_shading_language_include : enable\n"
+    "void main() {}\n";
+  const auto result = prgl::GlslProgram::InjectDefines(
+    source, {{"RADIUS", "4"}, {"CHANNELS", "3"}, {"USE_ALPHA", ""}});
+
+  EXPECT_EQ(result,
+            "// blur kernel\n"
+            "  #version 430\n"
+            "#define CHANNELS 3\n"
+            "#define RADIUS 4\n"
+            "#define USE_ALPHA\n"
+            "#line 3\n"
+            "#extension GL_ARB_shading_language_include : enable\n"
+            "void main() {}\n");
+}
+
+TEST(ShaderVariantCacheTest, injectsDefinesWithoutVersion) {
+  EXPECT_EQ(prgl::GlslProgram::InjectDefines("void main() {}\n", {}),
+            "void main() {}\n");
+  EXPECT_EQ(prgl::GlslProgram::InjectDefines("void main() {}\n", {{"A", "1"}}),
+            "#define A 1\n#line 1\nvoid main() {}\n");
+  // "#version" inside a line is not the directive
+  EXPECT_EQ(prgl::GlslProgram::InjectDefines("// #version\n", {{"A", "1"}}),
+            "#define A 1\n#line 1\n// #version\n");
+  EXPECT_EQ(
+    prgl::GlslProgram::InjectDefines(GLSL(430, void main() {}), {{"A", "1"}}),
+    "#version 430\n#define A 1\n#line 2\nvoid main() {}");
+}
+
+TEST(ShaderVariantCacheTest, rejectsInvalidDefines) {
+  EXPECT_THROW(prgl::GlslProgram::InjectDefines("", {{"2X", "1"}}),
+               std::invalid_argument);
+  EXPECT_THROW(prgl::GlslProgram::InjectDefines("", {{"A B", "1"}}),
+               std::invalid_argument);
+  EXPECT_THROW(prgl::GlslProgram::InjectDefines("", {{"A", "1\n2"}}),
+               std::invalid_argument);
+}
+
+TEST(ShaderVariantCacheTest, keysDependOnSourcesAndDefines) {
+  const std::map<uint32_t, std::string> sources = {
+    {GL_COMPUTE_SHADER, "#version 430\nvoid main() {}\n"}};
+  const auto plain  = prgl::ShaderVariantCache::makeKey(sources, {});
+  const auto radius = prgl::ShaderVariantCache::makeKey(sources, {{"R", "4"}});
+
+  EXPECT_EQ(plain, prgl::ShaderVariantCache::makeKey(sources, {}));
+  EXPECT_NE(plain, radius);
+  EXPECT_NE(radius, prgl::ShaderVariantCache::makeKey(sources, {{"R", "5"}}));
+  EXPECT_NE(radius, prgl::ShaderVariantCache::makeKey(sources, {{"R4", ""}}));
+  EXPECT_NE(plain, prgl::ShaderVariantCache::makeKey(
+                     {{GL_FRAGMENT_SHADER, sources.at(GL_COMPUTE_SHADER)}},
+                     {}));
+}
@@ -0,0 +1,86 @@
+/**
+ * @file TextureUploadBenchmark.cxx
+ * @author Thomas Lindemeier
+ *
+ * @brief Compares blocking Texture2d::upload with streaming uploads through
+ * persistently mapped pixel unpack buffers.
+ *
+ * @date 2026-10-17
+ *
+ */
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "prgl/ContextImplementation.hxx"
+#include "prgl/Texture2d.hxx"
+
+namespace {
+
+constexpr uint32_t Width    = 3840U;
+constexpr uint32_t Height   = 2160U;
+constexpr uint32_t NrFrames = 120U;
+constexpr uint32_t RingSize = 3U;
+
+template <class Upload>
+double measureFps(Upload&& upload) {
+  // warm up, first upload allocates the storage
+  upload(0U);
+  glFinish();
+
+  const auto start = std::chrono::steady_clock::now();
+  for (auto frame = 1U; frame <= NrFrames; frame++) {
+    upload(frame);
+    glFlush();
+  }
+  glFinish();
+  const auto end = std::chrono::steady_clock::now();
+
+  const std::chrono::duration<double> seconds = end - start;
+  return static_cast<double>(NrFrames) / seconds.count();
+}
+
+void benchmark(const std::string& name, prgl::TextureFormatInternal internal,
+               prgl::DataType type) {
+  auto blockingTex = prgl::Texture2d::Create(Width, Height, internal,
+                                             prgl::TextureFormat::Rgba, type);
+  auto streamingTex = prgl::Texture2d::Create(Width, Height, internal,
+                                              prgl::TextureFormat::Rgba, type);
+  streamingTex->enableStreaming(RingSize);
+
+  // simulated camera frame, touched every frame so no upload can be skipped
+  std::vector<uint8_t> frameData(blockingTex->getSizeInBytes(), 0U);
+
+  const auto blockingFps = measureFps([&](uint32_t frame) {
+    frameData[frame % frameData.size()] = static_cast<uint8_t>(frame);
+    blockingTex->upload(frameData.data());
+  });
+
+  const auto streamingFps = measureFps([&](uint32_t frame) {
+    frameData[frame % frameData.size()] = static_cast<uint8_t>(frame);
+    auto* dst = streamingTex->beginStreamingUpload();
+    std::memcpy(dst, frameData.data(), frameData.size());
+    streamingTex->endStreamingUpload();
+  });
+
+  std::cout << name << " " << Width << "x" << Height
+            << ": upload: " << blockingFps
+            << " fps, streaming (ring of " << RingSize
+            << "): " << streamingFps << " fps" << std::endl;
+}
+
+}  // namespace
+
+int32_t main(int32_t /*argc*/, char** /*args*/) {
+  // hidden window providing the context
+  prgl::ContextImplementation context;
+
+  benchmark("RGBA8", prgl::TextureFormatInternal::Rgba8,
+            prgl::DataType::UnsignedByte);
+  benchmark("RGBA32F", prgl::TextureFormatInternal::Rgba32F,
+            prgl::DataType::Float);
+
+  return EXIT_SUCCESS;
+}
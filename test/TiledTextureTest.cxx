@@ -0,0 +1,171 @@
+/**
+ * @file TiledTextureTest.cxx
+ * @author thomas lindemeier
+ *
+ * @brief Streams tiles of a generated image, needs a display.
+ *
+ * @date 2026-10-18
+ *
+ */
+
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "prgl/ContextImplementation.hxx"
+#include "prgl/QuadRenderer.hxx"
+#include "prgl/TiledTexture.hxx"
+
+namespace {
+using TileId = std::array<uint32_t, 3U>;
+
+constexpr uint32_t TileSize = 128U;
+
+// image rectangle drawn 1:1, so level 0 is selected
+prgl::TiledTexture::Viewport texelsAt(float x, float y, float width,
+                                      float height) {
+  return {x, y, width, height, 0.0F, 0.0F, width, height};
+}
+
+class TiledTextureTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if ((std::getenv("DISPLAY") == nullptr) &&
+        (std::getenv("WAYLAND_DISPLAY") == nullptr)) {
+      GTEST_SKIP() << "no display for a GL context";
+    }
+    mContext = std::make_unique<prgl::ContextImplementation>();
+  }
+
+  void TearDown() override {
+    mTexture.reset();
+    mContext.reset();
+  }
+
+  // the loader records which tiles were loaded, in order
+  void create(uint32_t width, uint32_t height, uint32_t cacheSize) {
+    mTexture = prgl::TiledTexture::Create(
+      width, height, TileSize, cacheSize,
+      [this](uint32_t level, uint32_t tileX, uint32_t tileY,
+             void* destination) {
+        mLoaded.push_back({level, tileX, tileY});
+        std::memset(destination, static_cast<int>(level),
+                    static_cast<std::size_t>(TileSize) * TileSize * 4U);
+      });
+  }
+
+  std::unique_ptr<prgl::ContextImplementation> mContext;
+  std::shared_ptr<prgl::TiledTexture> mTexture;
+  std::vector<TileId> mLoaded;
+};
+}  // namespace
+
+TEST_F(TiledTextureTest, selectLevel) {
+  create(1024U, 1024U, 8U);
+  // the coarsest level is a single tile
+  ASSERT_EQ(mTexture->getLevelCount(), 4U);
+
+  auto viewport = texelsAt(0.0F, 0.0F, 1024.0F, 1024.0F);
+  EXPECT_EQ(mTexture->selectLevel(viewport), 0U);
+  // magnified
+  viewport.screenWidth = 2048.0F;
+  EXPECT_EQ(mTexture->selectLevel(viewport), 0U);
+  // 4 texels per pixel
+  viewport.screenWidth = 256.0F;
+  EXPECT_EQ(mTexture->selectLevel(viewport), 2U);
+  // 10.24 texels per pixel rounds down
+  viewport.screenWidth = 100.0F;
+  EXPECT_EQ(mTexture->selectLevel(viewport), 3U);
+  // clamped to the coarsest level
+  viewport.screenWidth = 1.0F;
+  EXPECT_EQ(mTexture->selectLevel(viewport), 3U);
+}
+
+TEST_F(TiledTextureTest, loadsVisibleTilesAndCoarsestLevel) {
+  create(1024U, 1024U, 16U);
+
+  // texels [100, 300] x [300, 400] touch tiles 0..2 x 2..3
+  EXPECT_EQ(mTexture->update(texelsAt(100.0F, 300.0F, 200.0F, 100.0F)), 7U);
+  const std::vector<TileId> expected = {
+    {3U, 0U, 0U}, {0U, 0U, 2U}, {0U, 1U, 2U}, {0U, 2U, 2U},
+    {0U, 0U, 3U}, {0U, 1U, 3U}, {0U, 2U, 3U}};
+  EXPECT_EQ(mLoaded, expected);
+  EXPECT_EQ(mTexture->getResidentCount(), 7U);
+
+  // tiles beyond the image border are clamped to the last one
+  mLoaded.clear();
+  mTexture->update(texelsAt(960.0F, 0.0F, 500.0F, 10.0F));
+  EXPECT_EQ(mLoaded, (std::vector<TileId>{{0U, 7U, 0U}}));
+
+  // resident tiles are not loaded again
+  mLoaded.clear();
+  EXPECT_EQ(mTexture->update(texelsAt(100.0F, 300.0F, 200.0F, 100.0F)), 0U);
+  EXPECT_TRUE(mLoaded.empty());
+}
+
+TEST_F(TiledTextureTest, limitsUploadsPerUpdate) {
+  create(1024U, 1024U, 16U);
+  const auto viewport = texelsAt(0.0F, 0.0F, 300.0F, 300.0F);
+
+  // the coarsest tile and 2 of the 9 visible ones
+  EXPECT_EQ(mTexture->update(viewport, 3U), 3U);
+  EXPECT_EQ(mTexture->update(viewport, 3U), 3U);
+  EXPECT_EQ(mTexture->update(viewport, 8U), 4U);
+  EXPECT_EQ(mTexture->getResidentCount(), 10U);
+}
+
+TEST_F(TiledTextureTest, evictsLeastRecentlyUsed) {
+  create(512U, 512U, 3U);
+  ASSERT_EQ(mTexture->getLevelCount(), 3U);
+
+  mTexture->update(texelsAt(0.0F, 0.0F, 100.0F, 100.0F));
+  mTexture->update(texelsAt(130.0F, 0.0F, 100.0F, 100.0F));
+  ASSERT_EQ(mTexture->getResidentCount(), 3U);
+  const auto oldest = mTexture->getResidentLayer(0U, 0U, 0U);
+  ASSERT_TRUE(oldest.has_value());
+
+  // tile (0, 0) was not requested in the last frame, its layer is reused
+  EXPECT_EQ(mTexture->update(texelsAt(260.0F, 0.0F, 100.0F, 100.0F)), 1U);
+  EXPECT_FALSE(mTexture->getResidentLayer(0U, 0U, 0U).has_value());
+  EXPECT_EQ(mTexture->getResidentLayer(0U, 2U, 0U), oldest);
+  EXPECT_TRUE(mTexture->getResidentLayer(0U, 1U, 0U).has_value());
+  EXPECT_TRUE(mTexture->getResidentLayer(2U, 0U, 0U).has_value());
+  EXPECT_EQ(mTexture->getEvictionFailures(), 0U);
+}
+
+TEST_F(TiledTextureTest, keepsTilesOfTheCurrentFrame) {
+  create(512U, 512U, 3U);
+  const auto viewport = texelsAt(0.0F, 0.0F, 200.0F, 200.0F);
+
+  // the coarsest tile and 4 visible ones compete for 3 layers, tiles of this
+  // frame are never evicted
+  EXPECT_EQ(mTexture->update(viewport), 3U);
+  EXPECT_EQ(mTexture->getEvictionFailures(), 2U);
+  EXPECT_EQ(mTexture->getResidentCount(), 3U);
+  EXPECT_TRUE(mTexture->getResidentLayer(2U, 0U, 0U).has_value());
+  EXPECT_TRUE(mTexture->getResidentLayer(0U, 0U, 0U).has_value());
+  EXPECT_TRUE(mTexture->getResidentLayer(0U, 1U, 0U).has_value());
+  EXPECT_FALSE(mTexture->getResidentLayer(0U, 0U, 1U).has_value());
+  EXPECT_FALSE(mTexture->getResidentLayer(0U, 1U, 1U).has_value());
+
+  // the counter covers the last update only
+  mTexture->update(texelsAt(0.0F, 0.0F, 100.0F, 100.0F));
+  EXPECT_EQ(mTexture->getEvictionFailures(), 0U);
+}
+
+TEST_F(TiledTextureTest, fallsBackToCoarsestLevel) {
+  create(512U, 512U, 3U);
+  const auto viewport = texelsAt(0.0F, 0.0F, 200.0F, 200.0F);
+  mTexture->update(viewport);
+  ASSERT_EQ(mTexture->getEvictionFailures(), 2U);
+
+  // the two missing tiles are drawn from the coarsest one
+  auto renderer = prgl::QuadRenderer::Create();
+  mTexture->render(*renderer, viewport);
+  renderer->flush();
+  EXPECT_EQ(renderer->getQuadCount(), 4U);
+  EXPECT_EQ(renderer->getDrawCallCount(), 1U);
+}
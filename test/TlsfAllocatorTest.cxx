@@ -0,0 +1,157 @@
+/**
+ * @file TlsfAllocatorTest.cxx
+ * @author thomas lindemeier
+ *
+ * @brief
+ *
+ * @date 2026-10-17
+ *
+ */
+
+#include <array>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "prgl/TlsfAllocator.hxx"
+
+TEST(TlsfAllocatorTest, allocatesAlignedRangesWithoutOverlap) {
+  prgl::TlsfAllocator allocator(1U << 20U);
+
+  std::vector<prgl::TlsfAllocator::Allocation> allocations;
+  for (auto i = 0U; i < 64U; i++) {
+    const auto alignment  = 1ULL << (i % 9U);
+    const auto allocation = allocator.allocate(100U + i * 7U, alignment);
+    ASSERT_TRUE(allocation.has_value());
+    EXPECT_EQ(allocation->offset % alignment, 0U);
+    EXPECT_LE(allocation->offset + allocation->size, allocator.getCapacity());
+    for (const auto& other : allocations) {
+      EXPECT_TRUE(((allocation->offset + allocation->size) <= other.offset) ||
+                  ((other.offset + other.size) <= allocation->offset));
+    }
+    allocations.push_back(*allocation);
+  }
+  EXPECT_EQ(allocator.getStatistics().allocations, 64U);
+
+  EXPECT_FALSE(allocator.allocate(0U).has_value());
+  EXPECT_FALSE(allocator.allocate(2U << 20U).has_value());
+  EXPECT_THROW(allocator.allocate(16U, 3U), std::invalid_argument);
+}
+
+TEST(TlsfAllocatorTest, allocatesWholeCapacity) {
+  constexpr uint64_t MiB = 1U << 20U;
+  for (const auto& request : std::vector<std::array<uint64_t, 3U>>{
+         {100U * MiB, 100U * MiB, 16U},
+         {100U * MiB + 12345U, 100U * MiB + 12345U, 1U},
+         {64U * MiB, 64U * MiB, 256U}}) {
+    prgl::TlsfAllocator allocator(request[0U]);
+    const auto allocation = allocator.allocate(request[1U], request[2U]);
+    ASSERT_TRUE(allocation.has_value());
+    EXPECT_EQ(allocation->offset, 0U);
+    EXPECT_EQ(allocation->size, request[1U]);
+    EXPECT_EQ(allocator.getStatistics().freeBlocks, 0U);
+    EXPECT_FALSE(allocator.allocate(1U).has_value());
+  }
+
+  // the exact fit has to honour the alignment
+  prgl::TlsfAllocator allocator(4096U);
+  const auto first = allocator.allocate(1U);
+  ASSERT_TRUE(first.has_value());
+  EXPECT_FALSE(allocator.allocate(4095U, 2U).has_value());
+  const auto rest = allocator.allocate(4094U, 2U);
+  ASSERT_TRUE(rest.has_value());
+  EXPECT_EQ(rest->offset, 2U);
+}
+
+TEST(TlsfAllocatorTest, freeMergesNeighbours) {
+  prgl::TlsfAllocator allocator(4096U);
+  const auto a = allocator.allocate(1024U);
+  const auto b = allocator.allocate(1024U);
+  const auto c = allocator.allocate(1024U);
+  const auto d = allocator.allocate(1024U);
+  ASSERT_TRUE(a && b && c && d);
+  EXPECT_EQ(allocator.getStatistics().freeBlocks, 0U);
+
+  allocator.free(a->block);
+  EXPECT_THROW(allocator.free(a->block), std::invalid_argument);
+  allocator.free(c->block);
+  EXPECT_EQ(allocator.getStatistics().freeBlocks, 2U);
+  // no free range holds 2048 bytes
+  EXPECT_FALSE(allocator.allocate(2048U).has_value());
+
+  allocator.free(b->block);
+  EXPECT_EQ(allocator.getStatistics().freeBlocks, 1U);
+  allocator.free(d->block);
+  const auto statistics = allocator.getStatistics();
+  EXPECT_EQ(statistics.freeBlocks, 1U);
+  EXPECT_EQ(statistics.used, 0U);
+  EXPECT_EQ(statistics.largestFree, 4096U);
+  EXPECT_FLOAT_EQ(statistics.fragmentation, 0.0F);
+  EXPECT_TRUE(allocator.allocate(4096U).has_value());
+
+  EXPECT_THROW(allocator.get(1000U), std::invalid_argument);
+}
+
+TEST(TlsfAllocatorTest, defragmentCompactsAllocations) {
+  prgl::TlsfAllocator allocator(1U << 16U);
+  std::vector<uint8_t> memory(allocator.getCapacity(), 0U);
+
+  std::vector<prgl::TlsfAllocator::Allocation> allocations;
+  for (auto i = 0U; i < 32U; i++) {
+    const auto allocation = allocator.allocate(256U + i * 64U, 64U);
+    ASSERT_TRUE(allocation.has_value());
+    std::memset(&memory[allocation->offset], static_cast<int>(i),
+                allocation->size);
+    allocations.push_back(*allocation);
+  }
+  for (auto i = 0U; i < 32U; i += 2U) {
+    allocator.free(allocations[i].block);
+  }
+  EXPECT_GT(allocator.getStatistics().fragmentation, 0.0F);
+
+  for (const auto& move : allocator.defragment()) {
+    EXPECT_LT(move.to, move.from);
+    std::memmove(&memory[move.to], &memory[move.from], move.size);
+  }
+
+  const auto statistics = allocator.getStatistics();
+  EXPECT_EQ(statistics.freeBlocks, 1U);
+  EXPECT_FLOAT_EQ(statistics.fragmentation, 0.0F);
+  for (auto i = 1U; i < 32U; i += 2U) {
+    const auto allocation = allocator.get(allocations[i].block);
+    EXPECT_EQ(allocation.offset % 64U, 0U);
+    EXPECT_EQ(allocation.size, allocations[i].size);
+    EXPECT_EQ(memory[allocation.offset], i);
+    EXPECT_EQ(memory[allocation.offset + allocation.size - 1U], i);
+  }
+}
+
+TEST(TlsfAllocatorTest, randomAllocateAndFreeKeepsAccounting) {
+  prgl::TlsfAllocator allocator(1U << 24U);
+  std::mt19937 generator(7U);
+  std::uniform_int_distribution<uint32_t> size(1U, 8192U);
+
+  std::vector<prgl::TlsfAllocator::Allocation> allocations;
+  uint64_t used = 0U;
+  for (auto i = 0U; i < 4000U; i++) {
+    if (!allocations.empty() && ((generator() % 2U) == 0U)) {
+      const auto index = generator() % allocations.size();
+      used -= allocations[index].size;
+      allocator.free(allocations[index].block);
+      allocations.erase(allocations.begin() +
+                        static_cast<std::ptrdiff_t>(index));
+    } else {
+      const auto allocation = allocator.allocate(size(generator), 16U);
+      ASSERT_TRUE(allocation.has_value());
+      used += allocation->size;
+      allocations.push_back(*allocation);
+    }
+    ASSERT_EQ(allocator.getStatistics().used, used);
+  }
+  for (const auto& allocation : allocations) {
+    allocator.free(allocation.block);
+  }
+  EXPECT_EQ(allocator.getStatistics().freeBlocks, 1U);
+  EXPECT_EQ(allocator.getStatistics().largestFree, allocator.getCapacity());
+}
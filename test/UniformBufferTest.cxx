@@ -0,0 +1,80 @@
+/**
+ * @file UniformBufferTest.cxx
+ * @author thomas lindemeier
+ *
+ * @brief
+ *
+ * @date 2026-10-17
+ *
+ */
+
+#include <cstring>
+
+#include "gtest/gtest.h"
+#include "prgl/Projection.hxx"
+#include "prgl/UniformBuffer.hxx"
+
+namespace {
+// mirror of
+// layout(std140, row_major) uniform Camera {
+//   mat4 viewProjection; vec3 position; float time; vec2 viewport; };
+struct Camera {
+  prgl::mat4x4<float> viewProjection;
+  prgl::vec3f position;
+  float time;
+  prgl::vec2f viewport;
+  prgl::vec2f padding;
+};
+PRGL_STD140_MEMBER(Camera, viewProjection, 0U);
+PRGL_STD140_MEMBER(Camera, position, 64U);
+PRGL_STD140_MEMBER(Camera, time, 76U);
+PRGL_STD140_MEMBER(Camera, viewport, 80U);
+
+struct Light {
+  prgl::vec4f color;
+};
+
+struct Misaligned {
+  float intensity;
+  prgl::vec3f direction;
+};
+}  // namespace
+
+TEST(UniformBufferTest, acceptsStd140Types) {
+  EXPECT_TRUE(prgl::Std140Traits<float>::Supported);
+  EXPECT_TRUE(prgl::Std140Traits<prgl::vec3f>::Supported);
+  EXPECT_TRUE(prgl::Std140Traits<prgl::mat4x4<float>>::Supported);
+  EXPECT_TRUE(prgl::Std140Traits<Camera>::Supported);
+  EXPECT_TRUE((prgl::Std140Traits<std::array<Light, 4U>>::Supported));
+  EXPECT_TRUE((prgl::Std140Traits<std::array<prgl::vec4f, 8U>>::Supported));
+  EXPECT_EQ(prgl::Std140Traits<prgl::vec2f>::Alignment, 8U);
+  EXPECT_EQ(prgl::Std140Traits<prgl::vec3f>::Alignment, 16U);
+}
+
+TEST(UniformBufferTest, rejectsTypesWithDifferentLayout) {
+  EXPECT_FALSE(prgl::Std140Traits<bool>::Supported);
+  EXPECT_FALSE(prgl::Std140Traits<double>::Supported);
+  EXPECT_FALSE(prgl::Std140Traits<prgl::mat3x3<float>>::Supported);
+  EXPECT_FALSE((prgl::Std140Traits<std::array<float, 4U * 2U>>::Supported));
+  // the vec3 follows the float directly instead of starting at 16
+  EXPECT_NE(offsetof(Misaligned, direction) %
+              prgl::Std140Traits<prgl::vec3f>::Alignment,
+            0U);
+}
+
+TEST(UniformBufferTest, matricesAreRowMajor) {
+  // a row_major std140 mat4 is four vec4 rows, row r column c at 16 r + 4 c
+  Camera camera{};
+  camera.viewProjection =
+    prgl::projection::ortho(0.0F, 2.0F, 0.0F, 4.0F, 1.0F, 3.0F);
+  std::array<unsigned char, sizeof(Camera)> block{};
+  std::memcpy(block.data(), &camera, sizeof(Camera));
+
+  // the translation is the last column, the shader reads it as m[3]
+  const std::array<float, 4U> translation = {-1.0F, -1.0F, -2.0F, 1.0F};
+  for (auto row = 0U; row < 4U; row++) {
+    float value = 0.0F;
+    std::memcpy(&value, &block[(16U * row) + (4U * 3U)], sizeof(float));
+    EXPECT_FLOAT_EQ(value, translation[row]);
+  }
+}
@@ -0,0 +1,148 @@
+/**
+ * @file VertexLayoutBenchmark.cxx
+ * @author Thomas Lindemeier
+ *
+ * @brief Vertex throughput of an interleaved buffer described by a
+ * VertexLayout compared with one buffer per attribute.
+ *
+ * @date 2026-10-17
+ *
+ */
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "prgl/ContextImplementation.hxx"
+#include "prgl/FrameBufferObject.hxx"
+#include "prgl/GlslRenderingPipelineProgram.hxx"
+#include "prgl/Texture2d.hxx"
+#include "prgl/VertexArrayObject.hxx"
+
+namespace {
+
+constexpr uint32_t NrVertices = 10000000U;
+constexpr uint32_t NrRuns     = 20U;
+// small target, the vertex fetch dominates
+constexpr uint32_t TargetSize = 256U;
+
+struct Vertex {
+  prgl::vec3f position;
+  prgl::vec3f normal;
+  prgl::vec2f texCoord;
+};
+
+const std::string VertexShader = R"(
+  #version 430 core
+
+  layout(location = 0) in vec3 position;
+  layout(location = 1) in vec3 normal;
+  layout(location = 2) in vec2 texCoord;
+
+  out vec4 vColor;
+
+  void main() {
+    vColor      = vec4(normal * 0.5 + 0.5, texCoord.x);
+    gl_Position = vec4(position, 1.0);
+  }
+)";
+
+const std::string FragmentShader = R"(
+  #version 430 core
+
+  in vec4 vColor;
+  out vec4 color;
+
+  void main() {
+    color = vColor;
+  }
+)";
+
+// vertices per second
+double measureVertexRate(
+  const std::shared_ptr<prgl::VertexArrayObject>& vao,
+  const std::shared_ptr<prgl::GlslRenderingPipelineProgram>& program,
+  const std::shared_ptr<prgl::FrameBufferObject>& fbo) {
+  const auto fboBinder     = prgl::Binder(fbo);
+  const auto programBinder = prgl::Binder(program);
+  const auto vaoBinder     = prgl::Binder(vao);
+
+  // warm up
+  vao->render(prgl::DrawMode::Points, 0U, NrVertices);
+  glFinish();
+
+  const auto start = std::chrono::steady_clock::now();
+  for (auto i = 0U; i < NrRuns; i++) {
+    vao->render(prgl::DrawMode::Points, 0U, NrVertices);
+  }
+  glFinish();
+  const auto end = std::chrono::steady_clock::now();
+
+  const std::chrono::duration<double> seconds = end - start;
+  return static_cast<double>(NrVertices) * NrRuns / seconds.count();
+}
+
+}  // namespace
+
+int32_t main(int32_t /*argc*/, char** /*args*/) {
+  // hidden window providing the context
+  prgl::ContextImplementation context;
+
+  std::mt19937 generator(NrVertices);
+  std::uniform_real_distribution<float> uniform(-1.0F, 1.0F);
+  std::vector<Vertex> vertices(NrVertices);
+  std::vector<prgl::vec3f> positions(NrVertices);
+  std::vector<prgl::vec3f> normals(NrVertices);
+  std::vector<prgl::vec2f> texCoords(NrVertices);
+  for (auto i = 0U; i < NrVertices; i++) {
+    vertices[i] = {{uniform(generator), uniform(generator), 0.0F},
+                   {uniform(generator), uniform(generator), 1.0F},
+                   {uniform(generator), uniform(generator)}};
+    positions[i] = vertices[i].position;
+    normals[i]   = vertices[i].normal;
+    texCoords[i] = vertices[i].texCoord;
+  }
+
+  // one buffer per attribute
+  auto vboPositions = prgl::VertexBufferObject::Create();
+  auto vboNormals   = prgl::VertexBufferObject::Create();
+  auto vboTexCoords = prgl::VertexBufferObject::Create();
+  vboPositions->createBuffer(positions);
+  vboNormals->createBuffer(normals);
+  vboTexCoords->createBuffer(texCoords);
+  auto separate = prgl::VertexArrayObject::Create();
+  separate->addVertexBufferObject(0U, vboPositions);
+  separate->addVertexBufferObject(1U, vboNormals);
+  separate->addVertexBufferObject(2U, vboTexCoords);
+
+  // all attributes of a vertex next to each other
+  auto interleaved = prgl::VertexArrayObject::Create();
+  auto vboVertices = prgl::VertexBufferObject::Create();
+  vboVertices->createInterleavedBuffer(vertices);
+  prgl::VertexLayout layout(static_cast<uint32_t>(sizeof(Vertex)));
+  layout.add(0U, 3U).add(1U, 3U).add(2U, 2U);
+  interleaved->addVertexBufferObject(vboVertices, layout);
+
+  auto program = prgl::GlslRenderingPipelineProgram::Create();
+  program->build({{GL_VERTEX_SHADER, VertexShader},
+                  {GL_FRAGMENT_SHADER, FragmentShader}});
+
+  auto fbo    = prgl::FrameBufferObject::Create();
+  auto target = prgl::Texture2d::Create(TargetSize, TargetSize,
+                                        prgl::TextureFormatInternal::Rgba8,
+                                        prgl::TextureFormat::Rgba,
+                                        prgl::DataType::UnsignedByte);
+  fbo->attachTexture(target);
+
+  const auto separateRate    = measureVertexRate(separate, program, fbo);
+  const auto interleavedRate = measureVertexRate(interleaved, program, fbo);
+
+  const auto toM = 1.0e-6;
+  std::cout << NrVertices << " vertices (" << sizeof(Vertex)
+            << " bytes): separate buffers " << separateRate * toM
+            << " M/s, interleaved " << interleavedRate * toM << " M/s"
+            << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file VertexLayoutTest.cxx
+ * @author thomas lindemeier
+ *
+ * @brief
+ *
+ * @date 2026-10-17
+ *
+ */
+
+#include "gtest/gtest.h"
+#include "prgl/VertexLayout.hxx"
+
+TEST(VertexLayoutTest, appendsAlignedAttributes) {
+  prgl::VertexLayout layout;
+  layout.add(0U, 3U)
+    .add(1U, 4U, prgl::DataType::UnsignedByte, true)
+    .add(2U, 2U, prgl::DataType::HalfFloat)
+    .add(3U, 1U);
+
+  const auto& attributes = layout.getAttributes();
+  ASSERT_EQ(attributes.size(), 4U);
+  EXPECT_EQ(attributes[0].offset, 0U);
+  EXPECT_EQ(attributes[1].offset, 12U);
+  EXPECT_TRUE(attributes[1].normalized);
+  EXPECT_EQ(attributes[2].offset, 16U);
+  EXPECT_EQ(attributes[3].offset, 20U);
+  EXPECT_EQ(layout.getStride(), 24U);
+}
+
+TEST(VertexLayoutTest, explicitOffsetsAndStride) {
+  prgl::VertexLayout layout(32U);
+  layout.add(1U, 2U, prgl::DataType::Float, false, 24U)
+    .add(0U, 3U, prgl::DataType::Float, false, 0U);
+  EXPECT_EQ(layout.getStride(), 32U);
+
+  EXPECT_THROW(layout.add(2U, 4U, prgl::DataType::Float, false, 24U),
+               std::invalid_argument);
+  EXPECT_THROW(layout.add(0U, 1U), std::invalid_argument);
+  EXPECT_THROW(layout.add(3U, 5U), std::invalid_argument);
+}